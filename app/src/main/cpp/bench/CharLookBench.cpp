@@ -0,0 +1,319 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "NxBuilder.h"
+
+#include "Character/Look/CharLook.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+#include <nlnx/nx.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <initializer_list>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Draw time per frame of 100 characters which all look different, with the
+// textures of every frame looked up and ordered on each draw and with the
+// draw lists cached per look.
+//
+// Texture::draw does nothing here, so only the cost of finding the textures
+// is measured.
+namespace ms {
+// Counted by the Texture stand-in
+extern size_t textures_drawn;
+
+namespace {
+const size_t CHARACTERS = 100;
+const size_t FRAMES = 2000;
+const int32_t VARIANTS = 6;
+
+const char *STANCES[] = { "stand1", "stand2", "walk1", "walk2", "alert" };
+const size_t STANCE_FRAMES[] = { 3, 3, 4, 4, 3 };
+
+struct Part {
+    const char *name;
+    const char *z;
+    const char *parent;
+};
+
+class CharacterFile {
+public:
+    CharacterFile() :
+        pixels_(8 * 8 * 4, 0xFF),
+        character_(builder_.add(NxBuilder::ROOT, "Character")) {}
+
+    // One part of a frame, placed relative to the body through its map.
+    // Returns the map, so that more points can be added.
+    size_t add_part(size_t frame, const Part &part, int32_t x, int32_t y) {
+        size_t bitmap = builder_.add_bitmap(frame, part.name, 8, 8, pixels_);
+        builder_.add_vector(bitmap, "origin", 4, 4);
+        builder_.add_string(bitmap, "z", part.z);
+
+        size_t map = builder_.add(bitmap, "map");
+        builder_.add_vector(map, part.parent, x, y);
+
+        return map;
+    }
+
+    // A node with all frames of all stances, each made of the given parts
+    void add_stances(size_t node, std::initializer_list<Part> parts) {
+        for (size_t s = 0; s < std::size(STANCES); s++) {
+            size_t stance = builder_.add(node, STANCES[s]);
+
+            for (size_t f = 0; f < STANCE_FRAMES[s]; f++) {
+                size_t frame = builder_.add(stance, std::to_string(f));
+
+                for (const Part &part : parts) {
+                    add_part(frame, part, static_cast<int32_t>(f), -20);
+                }
+            }
+        }
+    }
+
+    void add_body() {
+        size_t body = builder_.add(character_, "00002000.img");
+
+        for (size_t s = 0; s < std::size(STANCES); s++) {
+            size_t stance = builder_.add(body, STANCES[s]);
+
+            for (size_t f = 0; f < STANCE_FRAMES[s]; f++) {
+                size_t frame = builder_.add(stance, std::to_string(f));
+                builder_.add_int(frame, "delay", 180);
+
+                size_t torso = add_part(frame, { "body", "body", "navel" }, 0, -20);
+                builder_.add_vector(torso, "neck", 0, -32);
+
+                size_t arm = add_part(frame, { "arm", "arm", "navel" }, 0, -20);
+                builder_.add_vector(arm, "hand", 8, -12);
+
+                add_part(frame, { "lHand", "handBelowWeapon", "handMove" }, 6, -10);
+            }
+        }
+
+        size_t head = builder_.add(character_, "00012000.img");
+
+        for (size_t s = 0; s < std::size(STANCES); s++) {
+            size_t stance = builder_.add(head, STANCES[s]);
+
+            for (size_t f = 0; f < STANCE_FRAMES[s]; f++) {
+                size_t frame = builder_.add(stance, std::to_string(f));
+                size_t part = add_part(frame, { "head", "head", "neck" }, 0, 0);
+                builder_.add_vector(part, "brow", 0, -15);
+            }
+        }
+    }
+
+    void add_hair(int32_t id) {
+        size_t hair = builder_.add(dir("Hair"), "000" + std::to_string(id) + ".img");
+        add_stances(hair, { { "hair", "hair", "brow" },
+                            { "hairOverHead", "hairOverHead", "brow" },
+                            { "backHair", "backHair", "brow" } });
+    }
+
+    void add_face(int32_t id) {
+        size_t face = builder_.add(dir("Face"), "000" + std::to_string(id) + ".img");
+        add_part(builder_.add(face, "default"), { "face", "face", "brow" }, 0, 0);
+
+        size_t blink = builder_.add(face, "blink");
+
+        for (size_t f = 0; f < 3; f++) {
+            size_t frame = builder_.add(blink, std::to_string(f));
+            add_part(frame, { "face", "face", "brow" }, 0, 0);
+            builder_.add_int(frame, "delay", 60);
+        }
+    }
+
+    void add_equip(const char *category, int32_t id, std::initializer_list<Part> parts) {
+        size_t equip = builder_.add(dir(category), "0" + std::to_string(id) + ".img");
+        size_t info = builder_.add(equip, "info");
+        builder_.add_string(info, "vslot", "Cp");
+        builder_.add_int(info, "attackSpeed", 4);
+
+        add_stances(equip, parts);
+    }
+
+    std::string write() {
+        std::string path = (std::filesystem::temp_directory_path() / "CharLookBench.nx").string();
+        builder_.write(path);
+
+        return path;
+    }
+
+private:
+    size_t dir(const std::string &name) {
+        auto iter = dirs_.find(name);
+
+        if (iter == dirs_.end()) {
+            iter = dirs_.emplace(name, builder_.add(character_, name)).first;
+        }
+
+        return iter->second;
+    }
+
+    NxBuilder builder_;
+    std::vector<uint8_t> pixels_;
+    size_t character_;
+    std::map<std::string, size_t> dirs_;
+};
+
+// Ids of each kind of part, a look uses one of each
+const int32_t HAIR = 30000;
+const int32_t FACE = 20000;
+const int32_t CAP = 1002000;
+const int32_t COAT = 1040000;
+const int32_t PANTS = 1060000;
+const int32_t SHOES = 1072000;
+const int32_t GLOVE = 1082000;
+const int32_t CAPE = 1102000;
+const int32_t WEAPON = 1302000;
+
+std::string write_file() {
+    CharacterFile file;
+    file.add_body();
+    file.add_equip("Coat", Clothing::TOP_DEFAULT_ID, { { "mail", "mailChest", "navel" } });
+    file.add_equip("Pants", Clothing::BOTTOM_DEFAULT_ID, { { "pants", "pants", "navel" } });
+
+    for (int32_t i = 0; i < VARIANTS; i++) {
+        file.add_hair(HAIR + i);
+        file.add_face(FACE + i);
+        file.add_equip("Cap", CAP + i, { { "default", "cap", "brow" } });
+        file.add_equip("Coat",
+                       COAT + i,
+                       { { "mail", "mailChest", "navel" },
+                         { "mailArm", "mailArm", "navel" } });
+        file.add_equip("Pants", PANTS + i, { { "pants", "pants", "navel" } });
+        file.add_equip("Shoes", SHOES + i, { { "shoes", "shoes", "navel" } });
+        file.add_equip("Glove",
+                       GLOVE + i,
+                       { { "lGlove", "gloveWrist", "navel" },
+                         { "rGlove", "gloveOverHair", "navel" } });
+        file.add_equip("Cape", CAPE + i, { { "cape", "cape", "navel" } });
+        file.add_equip("Weapon", WEAPON + i, { { "weapon", "weapon", "hand" } });
+    }
+
+    return file.write();
+}
+
+std::vector<CharLook> make_looks() {
+    std::mt19937 engine(5);
+    std::uniform_int_distribution<int32_t> variant(0, VARIANTS - 1);
+    std::set<std::vector<int32_t>> used;
+    std::vector<CharLook> looks;
+
+    while (looks.size() < CHARACTERS) {
+        std::vector<int32_t> ids = { HAIR, FACE, CAP, COAT, PANTS, SHOES, GLOVE, CAPE, WEAPON };
+
+        for (int32_t &id : ids) {
+            id += variant(engine);
+        }
+
+        if (!used.insert(ids).second) {
+            continue;
+        }
+
+        LookEntry entry = {};
+        entry.hairid = ids[0];
+        entry.faceid = ids[1];
+
+        for (size_t i = 2; i < ids.size(); i++) {
+            entry.equips[static_cast<int8_t>(i)] = ids[i];
+        }
+
+        looks.emplace_back(entry);
+        looks.back().set_stance(looks.size() % 2 ? Stance::Id::WALK1 : Stance::Id::STAND1);
+    }
+
+    return looks;
+}
+
+// Microseconds per frame spent drawing all characters
+double measure(std::vector<CharLook> &looks, bool cached) {
+    std::chrono::duration<double, std::micro> elapsed {};
+    textures_drawn = 0;
+
+    for (size_t f = 0; f < FRAMES; f++) {
+        for (CharLook &look : looks) {
+            look.update(Constants::TIMESTEP);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < looks.size(); i++) {
+            // Without the cache every draw builds its list again, like the
+            // draw calls through each part did, and also pays for storing it
+            if (!cached) {
+                CharLook::clear_draw_cache();
+            }
+
+            DrawArgument args(Point<int16_t>(static_cast<int16_t>(i * 10), 0), i % 2 == 0);
+            looks[i].draw(args, 1.0f);
+        }
+
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    return elapsed.count() / FRAMES;
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    // Configuration saves its file into the working directory
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+    std::string path = ms::write_file();
+
+    {
+        nl::file file(path);
+        nl::nx::character = file.root()["Character"];
+
+        ms::CharLook::init();
+        std::vector<ms::CharLook> looks = ms::make_looks();
+
+        double uncached = ms::measure(looks, false);
+        size_t textures = ms::textures_drawn;
+        ms::CharLook::DrawCacheStats before = ms::CharLook::get_draw_cache_stats();
+        double cached = ms::measure(looks, true);
+        ms::CharLook::DrawCacheStats after = ms::CharLook::get_draw_cache_stats();
+
+        if (textures != ms::textures_drawn) {
+            std::fprintf(stderr,
+                         "%zu textures drawn with the cache, %zu without\n",
+                         ms::textures_drawn,
+                         textures);
+        }
+
+        std::printf("%zu looks, %zu textures per frame, us/frame\n",
+                    looks.size(),
+                    textures / ms::FRAMES);
+        std::printf("lists built per draw %8.2f\n", uncached);
+        std::printf("cached lists         %8.2f   %zu lists, %llu hits, %llu misses\n",
+                    cached,
+                    after.lists,
+                    static_cast<unsigned long long>(after.hits - before.hits),
+                    static_cast<unsigned long long>(after.misses - before.misses));
+    }
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
\ No newline at end of file
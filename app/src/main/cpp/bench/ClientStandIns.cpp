@@ -0,0 +1,95 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Audio/Audio.h"
+#include "Graphics/GraphicsGL.h"
+#include "Graphics/Texture.h"
+
+#include <nlnx/node.hpp>
+
+// Stand-ins for the parts of the client that need a GL context or an audio
+// device. Textures read their node like the client does but are never
+// uploaded but counted when drawn, images never fit into the atlas and sounds
+// are never registered.
+namespace nl::nx {
+node base, character, effect, etc, item, map, mapPretty, mapLatest, map001,
+    mob, morph, npc, quest, reactor, skill, sound, string, tamingmob, ui;
+}  // namespace nl::nx
+
+namespace ms {
+size_t textures_drawn = 0;
+
+Texture::Texture(nl::node src) {
+    if (src.data_type() == nl::node::type::bitmap) {
+        origin_ = src["origin"];
+        bitmap_ = src;
+        dimensions_ = Point<int16_t>(bitmap_.width(), bitmap_.height());
+    }
+}
+
+Texture::Texture() = default;
+
+void Texture::draw(const DrawArgument &) const {
+    textures_drawn++;
+}
+
+void Texture::shift(Point<int16_t> amount) {
+    origin_ -= amount;
+}
+
+bool Texture::is_valid() const {
+    return bitmap_.id() > 0;
+}
+
+int16_t Texture::width() const {
+    return dimensions_.x();
+}
+
+int16_t Texture::height() const {
+    return dimensions_.y();
+}
+
+Point<int16_t> Texture::get_origin() const {
+    return origin_;
+}
+
+Point<int16_t> Texture::get_dimensions() const {
+    return dimensions_;
+}
+
+const nl::bitmap &Texture::get_bitmap() const {
+    return bitmap_;
+}
+
+GraphicsGL::GraphicsGL() = default;
+
+bool GraphicsGL::add_image(uint64_t, int16_t, int16_t, const void *) {
+    return false;
+}
+
+bool GraphicsGL::draw_image(uint64_t, const Rectangle<int16_t> &, const Color &, float) {
+    return false;
+}
+
+void GraphicsGL::remove_image(uint64_t) {}
+
+Sound::Sound(const nl::node &) : id_(0), priority_(0) {}
+
+Sound::Sound() : id_(0), priority_(0) {}
+
+void Sound::play() const {}
+
+void Sound::prefetch() const {}
+}  // namespace ms
\ No newline at end of file
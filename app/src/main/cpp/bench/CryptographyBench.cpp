@@ -0,0 +1,103 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "ReferenceCryptography.h"
+
+#include "Net/Cryptography.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Throughput of the byte-wise reference cipher and of the client's cipher
+// with each AES keystream path, on random payloads: the maple cipher alone
+// (one encryption plus one decryption), AES OFB alone, and whole packets
+// through encrypt and decrypt.
+namespace ms {
+namespace {
+const size_t PAYLOAD_BYTES = 64 * 1024 * 1024;
+
+template<typename F>
+double throughput(size_t length, F crypt) {
+    std::mt19937 engine(1);
+    std::vector<int8_t> bytes(length);
+
+    for (int8_t &byte: bytes) {
+        byte = static_cast<int8_t>(engine());
+    }
+
+    size_t rounds = PAYLOAD_BYTES / length;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < rounds; i++) {
+        crypt(bytes.data(), length);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return rounds * length / elapsed.count() / 1e6;
+}
+
+template<typename C>
+void measure(const char *name, C &cryptography) {
+    for (size_t length: {64, 1024, 16384, 131072}) {
+        uint8_t iv[4] = {1, 2, 3, 4};
+
+        double maple = throughput(length, [&](int8_t *bytes, size_t size) {
+            cryptography.mapleencrypt(bytes, size);
+            cryptography.mapledecrypt(bytes, size);
+        }) * 2;
+        double aesofb = throughput(length, [&](int8_t *bytes, size_t size) {
+            cryptography.aesofb(bytes, size, iv);
+        });
+        double encrypt = throughput(length, [&](int8_t *bytes, size_t size) {
+            cryptography.encrypt(bytes, size);
+        });
+        double decrypt = throughput(length, [&](int8_t *bytes, size_t size) {
+            cryptography.decrypt(bytes, size);
+        });
+
+        std::printf("%-13s %6zu bytes: maple %6.1f, aesofb %7.1f, encrypt %6.1f, decrypt %6.1f MB/s\n",
+                    name,
+                    length,
+                    maple,
+                    aesofb,
+                    encrypt,
+                    decrypt);
+    }
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    int8_t handshake[16] = {};
+
+    ms::ReferenceCryptography reference(handshake);
+    ms::measure("byte-wise", reference);
+
+    ms::Cryptography cryptography(handshake);
+
+    ms::Cryptography::set_aes_path(ms::Cryptography::AesPath::TABLE);
+    ms::measure("T-tables", cryptography);
+
+    if (ms::Cryptography::set_aes_path(ms::Cryptography::AesPath::HARDWARE)) {
+        ms::measure("hardware AES", cryptography);
+    } else {
+        std::printf("hardware AES not supported by this cpu\n");
+    }
+
+    return 0;
+}
\ No newline at end of file
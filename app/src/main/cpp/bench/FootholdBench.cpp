@@ -0,0 +1,188 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "FootholdMap.h"
+#include "NxBuilder.h"
+#include "ReferenceFootholdTree.h"
+
+#include "Gameplay/Physics/FootholdTree.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// Each block starts with its size, so that freeing it can be counted too
+const size_t HEADER = alignof(std::max_align_t);
+size_t live = 0;
+
+// Keeps the results of the queries from being optimized away
+volatile int64_t sink = 0;
+}  // namespace
+
+// Count the bytes that are allocated and not yet freed, to report the memory
+// a tree holds on to
+void *operator new(size_t size) {
+    if (auto *block = static_cast<char *>(std::malloc(size + HEADER))) {
+        *reinterpret_cast<size_t *>(block) = size;
+        live += size;
+
+        return block + HEADER;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr) {
+        char *block = static_cast<char *>(ptr) - HEADER;
+        live -= *reinterpret_cast<size_t *>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+// Build time, memory and query latency of the foothold tree, before and after
+// the column index.
+//
+// Usage: FootholdBench [<file.nx> <path to a map's foothold node>]
+// Without arguments, a synthetic map as wide as the largest maps is used.
+namespace ms {
+namespace {
+const size_t BUILDS = 20;
+const size_t QUERIES = 1000000;
+const size_t OBJECTS = 200000;
+
+using Clock = std::chrono::steady_clock;
+using Micros = std::chrono::duration<double, std::micro>;
+using Nanos = std::chrono::duration<double, std::nano>;
+
+template<typename Tree>
+void measure(const char *label,
+             const nl::node &src,
+             const std::vector<Point<int16_t>> &positions) {
+    size_t before = live;
+    auto start = Clock::now();
+
+    for (size_t i = 1; i < BUILDS; i++) {
+        Tree discarded(src);
+    }
+
+    Tree tree(src);
+    Micros build = (Clock::now() - start) / BUILDS;
+    size_t memory = live - before;
+
+    start = Clock::now();
+    int64_t sum = 0;
+
+    for (const Point<int16_t> &position : positions) {
+        sum += tree.get_y_below(position);
+    }
+
+    Nanos below = (Clock::now() - start) / positions.size();
+
+    // Objects falling from the same positions, as mobs and drops do
+    size_t count = std::min(OBJECTS, positions.size());
+    std::vector<PhysicsObject> objects(count);
+
+    for (size_t i = 0; i < count; i++) {
+        objects[i].onground = false;
+        objects[i].set_x(positions[i].x());
+        objects[i].set_y(positions[i].y());
+        objects[i].vspeed = 2.0;
+    }
+
+    start = Clock::now();
+
+    for (PhysicsObject &phobj : objects) {
+        tree.update_fh(phobj);
+        sum += phobj.fhid;
+    }
+
+    Nanos update = (Clock::now() - start) / count;
+
+    std::printf("%-10s build %9.1f us %10zu bytes   get_y_below %7.1f ns   update_fh %7.1f ns\n",
+                label,
+                build.count(),
+                memory,
+                below.count(),
+                update.count());
+
+    sink = sink + sum;
+}
+
+void run(const nl::node &src) {
+    ReferenceFootholdTree bounds(src);
+    Range<int16_t> walls = bounds.get_walls();
+    Range<int16_t> borders = bounds.get_borders();
+
+    std::mt19937 engine(7);
+    std::uniform_int_distribution<int16_t> x(walls.first(), walls.second());
+    std::uniform_int_distribution<int16_t> y(borders.first(), borders.second());
+    std::vector<Point<int16_t>> positions;
+    positions.reserve(QUERIES);
+
+    for (size_t i = 0; i < QUERIES; i++) {
+        positions.emplace_back(x(engine), y(engine));
+    }
+
+    measure<ReferenceFootholdTree>("multimap", src, positions);
+    measure<FootholdTree>("columns", src, positions);
+}
+}  // namespace
+}  // namespace ms
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        nl::file file(argv[1]);
+        nl::node src = file.root().resolve(argv[2]);
+
+        if (!src) {
+            std::fprintf(stderr, "%s was not found in %s\n", argv[2], argv[1]);
+            return 1;
+        }
+
+        ms::run(src);
+
+        return 0;
+    }
+
+    ms::NxBuilder builder;
+    ms::add_footholds(builder, ms::NxBuilder::ROOT, ms::make_footholds(2500, 20000, 1));
+
+    std::string path = (std::filesystem::temp_directory_path() / "FootholdBench.nx").string();
+    builder.write(path);
+
+    {
+        nl::file file(path);
+        ms::run(file.root()["foothold"]);
+    }
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
\ No newline at end of file
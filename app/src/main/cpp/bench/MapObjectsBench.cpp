@@ -0,0 +1,140 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "LegacyMapObjects.h"
+
+#include "Configuration.h"
+#include "Gameplay/MapleMap/MapObjects.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+
+// Update and draw time per frame of a map with 500 mobs and 1000 drops, in
+// the hash map container MapObjects used to be and in the slot map. Both
+// keep a spatial grid current during update.
+namespace ms {
+namespace {
+const size_t FRAMES = 20000;
+
+int64_t drawn = 0;
+
+// Walks back and forth and now and then changes layer and stance. Size is
+// the rough footprint of the client's object, so that both containers touch
+// as much memory as they would in a game. Bounds are looked up by stance,
+// as Mob looks them up in its animations.
+template<size_t Size>
+class Walker : public MapObject {
+public:
+    Walker(int32_t oid, int16_t x) : MapObject(oid, { x, 0 }) {
+        for (int16_t stance = 0; stance < 6; stance++) {
+            int16_t half = 20 + stance * 5;
+            bounds_[stance] = { static_cast<int16_t>(-half), half, -60, 0 };
+        }
+    }
+
+    void draw(double viewx, double, float) const override {
+        drawn += get_position().x() + static_cast<int64_t>(viewx) + state_[0];
+    }
+
+    int8_t update(const Physics &) override {
+        steps_++;
+        phobj_.set_x(phobj_.crnt_x() + (steps_ % 64 < 32 ? 1.0 : -1.0));
+
+        if (steps_ % 500 == static_cast<uint32_t>(oid_ % 500)) {
+            phobj_.fhlayer = static_cast<int8_t>((phobj_.fhlayer + 1) % Layer::Id::LENGTH);
+            stance_ = static_cast<int16_t>((stance_ + 1) % 6);
+            reach_changed();
+        }
+
+        return phobj_.fhlayer;
+    }
+
+    Rectangle<int16_t> get_bounds() const override { return bounds_.at(stance_); }
+
+private:
+    std::map<int16_t, Rectangle<int16_t>> bounds_;
+    int16_t stance_ = 0;
+    uint32_t steps_ = 0;
+    char state_[Size] = {};
+};
+
+using Mob = Walker<1024>;
+using Drop = Walker<256>;
+
+struct Timing {
+    double update;
+    double draw;
+};
+
+template<typename Container>
+Timing run(Container &objects) {
+    for (int32_t i = 0; i < 1500; i++) {
+        // Oids are spread out like the server's
+        int32_t oid = 1000 + i * 13;
+        auto x = static_cast<int16_t>(i * 3);
+
+        if (i % 3 == 0) {
+            objects.add(std::make_unique<Mob>(oid, x));
+        } else {
+            objects.add(std::make_unique<Drop>(oid, x));
+        }
+    }
+
+    Physics physics;
+    std::chrono::duration<double, std::micro> updating {};
+    std::chrono::duration<double, std::micro> drawing {};
+
+    for (size_t frame = 0; frame < FRAMES; frame++) {
+        auto start = std::chrono::steady_clock::now();
+
+        objects.update(physics);
+
+        auto updated = std::chrono::steady_clock::now();
+
+        for (auto id : Layer::IDs) {
+            objects.draw(id, 0.0, 0.0, 1.0f);
+        }
+
+        drawing += std::chrono::steady_clock::now() - updated;
+        updating += updated - start;
+    }
+
+    return { updating.count() / FRAMES, drawing.count() / FRAMES };
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    // Configuration saves its file into the working directory
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+    // PhysicsBench may have left batched physics on, which would time a
+    // different update path
+    ms::Setting<ms::BatchedPhysics>::get().save(false);
+
+    ms::LegacyMapObjects legacy;
+    ms::MapObjects slots;
+
+    ms::Timing before = ms::run(legacy);
+    ms::Timing after = ms::run(slots);
+
+    std::printf("500 mobs, 1000 drops, us/frame   update    draw\n");
+    std::printf("hash map                       %7.2f %7.2f\n", before.update, before.draw);
+    std::printf("slot map                       %7.2f %7.2f\n", after.update, after.draw);
+
+    return ms::drawn == 0 ? 1 : 0;
+}
\ No newline at end of file
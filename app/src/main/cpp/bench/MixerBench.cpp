@@ -0,0 +1,110 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Audio/Mixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Mixer CPU time per second of audio, rendered offline with N sounds playing
+// at once over one music stream, in the blocks the device asks for.
+namespace ms {
+namespace {
+const size_t BLOCK = 1024;
+
+// Noise of half a second to two seconds, like the client's effects
+std::vector<std::shared_ptr<const Mixer::Pcm>> make_sounds(size_t count) {
+    std::vector<std::shared_ptr<const Mixer::Pcm>> sounds;
+    uint32_t state = 1;
+
+    for (size_t i = 0; i < count; i++) {
+        auto pcm = std::make_shared<Mixer::Pcm>((Mixer::RATE / 2 + i * 1733 % Mixer::RATE) * 2);
+
+        for (float &value : *pcm) {
+            state = state * 1664525 + 1013904223;
+            value = static_cast<float>(state >> 8) / (1 << 24) - 0.5f;
+        }
+
+        sounds.push_back(std::move(pcm));
+    }
+
+    return sounds;
+}
+
+double run(size_t voices, size_t seconds) {
+    Mixer mixer(voices);
+    auto sounds = make_sounds(48);
+
+    // Music is decoded ahead on another thread, here it is a looped tone
+    std::vector<float> tone(Mixer::RATE * 2);
+
+    for (size_t i = 0; i < tone.size(); i++) {
+        tone[i] = static_cast<float>(std::sin(i / 2 * 0.0626) * 0.25);
+    }
+
+    size_t position = 0;
+
+    uint64_t music = mixer.add_stream([&](float *out, size_t frames) {
+        for (size_t written = 0; written < frames * 2;) {
+            size_t count = std::min(frames * 2 - written, tone.size() - position);
+            std::copy_n(tone.data() + position, count, out + written);
+            written += count;
+            position = (position + count) % tone.size();
+        }
+
+        return frames;
+    });
+
+    mixer.start_stream(music);
+
+    std::vector<float> out(BLOCK * 2);
+    size_t blocks = seconds * Mixer::RATE / BLOCK;
+    size_t next = 0;
+
+    for (size_t block = 0; block < blocks; block++) {
+        // Keep every voice busy
+        while (mixer.get_stats().voices < voices) {
+            mixer.play(sounds[next % sounds.size()], 0.5f, (next % 5) * 0.5f - 1.0f, 0);
+            next++;
+        }
+
+        // Fade the music in and out now and then
+        if (block % 40 == 0) {
+            mixer.set_stream_gain(music, block % 80 == 0 ? 0.5f : 1.0f);
+        }
+
+        mixer.mix(out.data(), BLOCK);
+    }
+
+    return mixer.get_stats().cost();
+}
+}  // namespace
+}  // namespace ms
+
+int main(int argc, char **argv) {
+    size_t seconds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 120;
+
+    std::printf("voices  us per second of audio\n");
+
+    for (size_t voices : { 1, 8, 16, 32, 64 }) {
+        std::printf("%6zu  %8.1f\n", voices, ms::run(voices, seconds));
+    }
+
+    return 0;
+}
\ No newline at end of file
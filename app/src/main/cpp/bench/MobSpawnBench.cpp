@@ -0,0 +1,183 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "NxBuilder.h"
+
+#include "Data/MobData.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+#include <nlnx/nx.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+
+#include "StringHandling.h"
+
+namespace {
+size_t allocated = 0;
+}  // namespace
+
+// Count every allocation so that the memory held by the mob templates can be
+// reported
+void *operator new(size_t size) {
+    allocated += size;
+
+    if (void *ptr = std::malloc(size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// Time and memory of spawning N mobs of the same id.
+//
+// Before MobData, every spawn parsed the mob's node again and built its own
+// animations, which is what loading N different mobs with identical data
+// does. With MobData, all spawns of an id share one template.
+namespace ms {
+namespace {
+const int32_t FIRST_ID = 100100;
+const size_t FRAMES = 6;
+const char *STANCES[] = { "stand", "move", "jump", "hit1", "die1",
+                          "skill1", "skill2", "attack1", "attack2" };
+
+void add_mob(NxBuilder &builder,
+             size_t mobs,
+             size_t names,
+             size_t sounds,
+             int32_t id) {
+    std::string strid = string_format::extend_id(id, 7);
+    size_t mob = builder.add(mobs, strid + ".img");
+    size_t info = builder.add(mob, "info");
+
+    builder.add_int(info, "level", 30);
+    builder.add_int(info, "PADamage", 120);
+    builder.add_int(info, "MADamage", 90);
+    builder.add_int(info, "PDDamage", 60);
+    builder.add_int(info, "MDDamage", 60);
+    builder.add_int(info, "acc", 70);
+    builder.add_int(info, "eva", 10);
+    builder.add_int(info, "pushed", 200);
+    builder.add_int(info, "speed", -20);
+    builder.add_int(info, "bodyAttack", 1);
+
+    size_t skills = builder.add(info, "skill");
+
+    for (int32_t i = 0; i < 2; i++) {
+        size_t skill = builder.add(skills, std::to_string(i));
+        builder.add_int(skill, "skill", 100 + i);
+        builder.add_int(skill, "action", i + 1);
+    }
+
+    std::vector<uint8_t> pixels(8 * 8 * 4, 0xFF);
+
+    for (const char *name : STANCES) {
+        size_t stance = builder.add(mob, name);
+
+        for (size_t f = 0; f < FRAMES; f++) {
+            size_t frame = builder.add_bitmap(stance, std::to_string(f), 8, 8, pixels);
+            builder.add_vector(frame, "origin", 40, 75);
+            builder.add_vector(frame, "lt", -30, -70);
+            builder.add_vector(frame, "rb", 30, 0);
+            builder.add_int(frame, "delay", 120);
+        }
+    }
+
+    builder.add_string(builder.add(names, std::to_string(id)), "name", "Mob " + strid);
+
+    size_t sound = builder.add(sounds, strid);
+    builder.add_int(sound, "Damage", 0);
+    builder.add_int(sound, "Die", 0);
+}
+
+std::string write_file(size_t count) {
+    NxBuilder builder;
+
+    size_t mobs = builder.add(NxBuilder::ROOT, "Mob");
+    size_t names = builder.add(builder.add(NxBuilder::ROOT, "String"), "Mob.img");
+    size_t sounds = builder.add(builder.add(NxBuilder::ROOT, "Sound"), "Mob.img");
+
+    // One id spawned over and over, then one id per spawn
+    for (size_t i = 0; i <= count; i++) {
+        add_mob(builder, mobs, names, sounds, FIRST_ID + static_cast<int32_t>(i));
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "MobSpawnBench.nx").string();
+    builder.write(path);
+
+    return path;
+}
+
+template<typename F>
+void measure(const char *label, size_t count, F id_of) {
+    size_t before = allocated;
+    auto start = std::chrono::steady_clock::now();
+    size_t valid = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        valid += MobData::get(id_of(i)).is_valid() ? 1 : 0;
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (valid != count) {
+        std::fprintf(stderr, "%zu of %zu mobs were not found\n", count - valid, count);
+    }
+
+    std::printf("%-14s %6zu spawns %10.1f us total %8.2f us/spawn %9zu bytes/spawn\n",
+                label,
+                count,
+                elapsed.count(),
+                elapsed.count() / count,
+                (allocated - before) / count);
+}
+}  // namespace
+}  // namespace ms
+
+int main(int argc, char **argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 40;
+    std::string path = ms::write_file(count);
+
+    {
+        nl::file file(path);
+        nl::nx::mob = file.root()["Mob"];
+        nl::nx::string = file.root()["String"];
+        nl::nx::sound = file.root()["Sound"];
+
+        ms::measure("parse per spawn", count, [](size_t i) {
+            return ms::FIRST_ID + 1 + static_cast<int32_t>(i);
+        });
+        ms::measure("shared MobData", count, [](size_t) {
+            return ms::FIRST_ID;
+        });
+    }
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
\ No newline at end of file
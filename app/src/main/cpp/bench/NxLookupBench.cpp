@@ -0,0 +1,136 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "NxBuilder.h"
+
+#include <nlnx/child_index.hpp>
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+// Child lookup throughput over a synthetic NX file, with nlnx's child index
+// switched off (binary search over the string table) and on.
+//
+// The file mimics the shapes the client resolves most: String-style nodes
+// with tens of thousands of numeric children looked up by integer, and
+// Map-style paths like map["Map"]["Map1"]["100000000.img"]["info"]["bgm"].
+namespace ms {
+namespace {
+const int32_t IDS = 50000;
+const int32_t MAPS = 5000;
+const size_t LOOKUPS = 2000000;
+
+std::string map_name(int32_t index) {
+    char name[16];
+    std::snprintf(name, sizeof(name), "%09d.img", 100000000 + index * 1000);
+
+    return name;
+}
+
+std::string write_file() {
+    NxBuilder builder;
+
+    size_t ids = builder.add(NxBuilder::ROOT, "Mob.img");
+
+    for (int32_t i = 0; i < IDS; i++) {
+        size_t mob = builder.add(ids, std::to_string(100000 + i * 7));
+        builder.add_string(mob, "name", "mob" + std::to_string(i));
+    }
+
+    size_t maps = builder.add(builder.add(NxBuilder::ROOT, "Map"), "Map1");
+
+    for (int32_t i = 0; i < MAPS; i++) {
+        size_t info = builder.add(builder.add(maps, map_name(i)), "info");
+        builder.add_string(info, "bgm", "Bgm00/GoPicnic");
+        builder.add_int(info, "returnMap", 100000000);
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "NxLookupBench.nx").string();
+    builder.write(path);
+
+    return path;
+}
+
+template<typename F>
+double run(F lookup) {
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        found += lookup(i) ? 1 : 0;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (found != LOOKUPS) {
+        std::fprintf(stderr, "%zu of %zu lookups failed\n", LOOKUPS - found, LOOKUPS);
+    }
+
+    return LOOKUPS / elapsed.count() / 1e6;
+}
+
+void measure(const nl::node &root, bool indexed) {
+    nl::child_index::set_enabled(indexed);
+
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<int32_t> mob_dist(0, IDS - 1);
+    std::uniform_int_distribution<int32_t> map_dist(0, MAPS - 1);
+
+    std::vector<int32_t> mob_ids(LOOKUPS);
+    std::vector<std::string> map_names(LOOKUPS);
+
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        mob_ids[i] = 100000 + mob_dist(engine) * 7;
+        map_names[i] = map_name(map_dist(engine));
+    }
+
+    nl::node mobs = root["Mob.img"];
+
+    double by_integer = run([&](size_t i) {
+        return mobs[mob_ids[i]]["name"];
+    });
+
+    double by_path = run([&](size_t i) {
+        return root["Map"]["Map1"][map_names[i]]["info"]["bgm"];
+    });
+
+    std::printf("%-13s integer lookups %6.2f M/s, map paths %6.2f M/s\n",
+                indexed ? "child index" : "binary search",
+                by_integer,
+                by_path);
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    std::string path = ms::write_file();
+
+    {
+        nl::file file(path);
+
+        ms::measure(file.root(), false);
+        ms::measure(file.root(), true);
+    }
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "QuadTreePacker.h"
+
+#include "Util/RectanglePacker.h"
+
+#include <nlnx/bitmap.hpp>
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Replays a sequence of bitmap sizes through the old QuadTree allocator and
+// the skyline packer, one atlas page at a time.
+//
+// Usage: PackerBench [sizes.txt | Map.nx ...]
+// A text file holds one "width height" pair per line, e.g. dumped from a
+// session. NX files are replayed in node order. Without arguments a fixed,
+// seeded mix of small, medium and background sized bitmaps is used.
+namespace ms {
+namespace {
+struct Size {
+    int16_t width;
+    int16_t height;
+};
+
+// Size of one GraphicsGL atlas page below the font rows
+const int16_t PAGE_WIDTH = 8192;
+const int16_t PAGE_HEIGHT = 2016;
+
+void collect(const nl::node &node, std::vector<Size> &sizes) {
+    for (nl::node child: node) {
+        if (child.data_type() == nl::node::type::bitmap) {
+            nl::bitmap bmp = child.get_bitmap();
+
+            if (bmp.width() > 0 && bmp.height() > 0) {
+                sizes.push_back({static_cast<int16_t>(bmp.width()),
+                                 static_cast<int16_t>(bmp.height())});
+            }
+        }
+
+        collect(child, sizes);
+    }
+}
+
+bool load(const std::string &path, std::vector<Size> &sizes) {
+    std::ifstream stream(path);
+
+    if (!stream) {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+
+        return false;
+    }
+
+    if (path.size() > 3 && path.compare(path.size() - 3, 3, ".nx") == 0) {
+        nl::file file(path);
+        collect(file.root(), sizes);
+
+        return true;
+    }
+
+    int width = 0;
+    int height = 0;
+
+    while (stream >> width >> height) {
+        if (width > 0 && height > 0) {
+            sizes.push_back({static_cast<int16_t>(width), static_cast<int16_t>(height)});
+        }
+    }
+
+    return true;
+}
+
+std::vector<Size> synthetic() {
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_int_distribution<int> icon(8, 40);
+    std::uniform_int_distribution<int> sprite(30, 160);
+    std::uniform_int_distribution<int> background(200, 1024);
+
+    std::vector<Size> sizes;
+
+    for (size_t i = 0; i < 200000; i++) {
+        int k = kind(engine);
+        std::uniform_int_distribution<int> &side = k < 40 ? icon : k < 97 ? sprite : background;
+
+        sizes.push_back({static_cast<int16_t>(side(engine)),
+                         static_cast<int16_t>(std::min(side(engine), 600))});
+    }
+
+    return sizes;
+}
+
+void replay(const char *name, RectanglePacker &packer, const std::vector<Size> &sizes) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(sizes.size());
+
+    size_t pages = 0;
+    double utilisation = 0.0;
+    double waste = 0.0;
+    double area = static_cast<double>(PAGE_WIDTH) * PAGE_HEIGHT;
+
+    packer.clear();
+
+    for (const Size &size: sizes) {
+        int16_t x = 0;
+        int16_t y = 0;
+
+        auto start = Clock::now();
+        bool placed = packer.insert(size.width, size.height, x, y);
+
+        if (!placed) {
+            // Recycle the page, the same as GraphicsGL does with a cold one
+            pages++;
+            utilisation += packer.get_used() / area;
+            waste += packer.get_wasted() / area;
+
+            packer.clear();
+            placed = packer.insert(size.width, size.height, x, y);
+        }
+
+        auto end = Clock::now();
+
+        if (placed) {
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+
+    std::printf("%-9s inserts %zu, pages filled %zu, utilisation %.1f%%, wasted %.1f%%\n",
+                name,
+                latencies.size(),
+                pages,
+                pages ? 100.0 * utilisation / pages : 100.0 * packer.get_used() / area,
+                pages ? 100.0 * waste / pages : 100.0 * packer.get_wasted() / area);
+    std::printf("          insert ns p50 %lld, p90 %lld, p99 %lld, p99.9 %lld, max %lld\n",
+                static_cast<long long>(percentile(0.5)),
+                static_cast<long long>(percentile(0.9)),
+                static_cast<long long>(percentile(0.99)),
+                static_cast<long long>(percentile(0.999)),
+                static_cast<long long>(percentile(1.0)));
+}
+}  // namespace
+}  // namespace ms
+
+int main(int argc, char **argv) {
+    std::vector<ms::Size> sizes;
+
+    for (int i = 1; i < argc; i++) {
+        if (!ms::load(argv[i], sizes)) {
+            return 1;
+        }
+    }
+
+    if (argc == 1) {
+        sizes = ms::synthetic();
+    }
+
+    std::printf("%zu bitmaps, %dx%d pages\n", sizes.size(), ms::PAGE_WIDTH, ms::PAGE_HEIGHT);
+
+    ms::QuadTreePacker quadtree(ms::PAGE_WIDTH, ms::PAGE_HEIGHT);
+    ms::SkylinePacker skyline(ms::PAGE_WIDTH, ms::PAGE_HEIGHT);
+
+    ms::replay("QuadTree", quadtree, sizes);
+    ms::replay("Skyline", skyline, sizes);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "FootholdMap.h"
+#include "NxBuilder.h"
+
+#include "Configuration.h"
+#include "Gameplay/MapleMap/MapObjects.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+// Time per tick of MapObjects::update with every object moved on its own and
+// with the BatchedPhysics setting on.
+//
+// Usage: PhysicsBench [<mobs> [<drops>]]
+namespace ms {
+namespace {
+const size_t TICKS = 5000;
+
+// Walks along the footholds and turns around every now and then, split along
+// before_physics and after_physics like Mob. Size is the rough footprint of
+// the client's object.
+class Walker : public MapObject {
+public:
+    Walker(int32_t oid, Point<int16_t> position) : MapObject(oid, position) {
+        phobj_.set_flag(PhysicsObject::Flag::TURN_AT_EDGES);
+    }
+
+    void draw(double, double, float) const override {}
+
+    int8_t update(const Physics &physics) override {
+        if (PhysicsObject *phobj = before_physics(physics)) {
+            physics.move_object(*phobj);
+        }
+
+        return after_physics(physics);
+    }
+
+    PhysicsObject *before_physics(const Physics &) override {
+        steps_++;
+
+        if (steps_ % 180 == static_cast<uint32_t>(oid_ % 180)) {
+            left_ = !left_;
+        }
+
+        phobj_.hforce = left_ ? -0.1 : 0.1;
+
+        return &phobj_;
+    }
+
+    int8_t after_physics(const Physics &) override {
+        if (!phobj_.hmobile()) {
+            left_ = !left_;
+        }
+
+        return phobj_.fhlayer;
+    }
+
+private:
+    uint32_t steps_ = 0;
+    bool left_ = false;
+    char state_[1024] = {};
+};
+
+// Thrown up and left lying where it lands, like Drop
+class Dropped : public MapObject {
+public:
+    Dropped(int32_t oid, Point<int16_t> position) : MapObject(oid, position) {
+        phobj_.onground = false;
+        phobj_.vspeed = -5.0;
+        phobj_.hspeed = (oid % 5 - 2) * 0.5;
+    }
+
+    void draw(double, double, float) const override {}
+
+    int8_t update(const Physics &physics) override {
+        physics.move_object(*before_physics(physics));
+
+        return after_physics(physics);
+    }
+
+    PhysicsObject *before_physics(const Physics &) override {
+        return &phobj_;
+    }
+
+    int8_t after_physics(const Physics &) override {
+        if (phobj_.onground) {
+            phobj_.hspeed = 0.0;
+        }
+
+        return phobj_.fhlayer;
+    }
+
+private:
+    char state_[256] = {};
+};
+
+void fill(MapObjects &objects, size_t mobs, size_t drops) {
+    int32_t oid = 1000;
+
+    // Spread over the middle of the map, where the platforms are
+    for (size_t i = 0; i < mobs; i++, oid += 13) {
+        auto x = static_cast<int16_t>(-3500 + (i * 7919) % 7000);
+        objects.add(std::make_unique<Walker>(oid, Point<int16_t>(x, -600)));
+    }
+
+    for (size_t i = 0; i < drops; i++, oid += 13) {
+        auto x = static_cast<int16_t>(-3500 + (i * 6007) % 7000);
+        objects.add(std::make_unique<Dropped>(oid, Point<int16_t>(x, -600)));
+    }
+}
+
+double measure(const Physics &physics, size_t mobs, size_t drops, bool batched) {
+    Setting<BatchedPhysics>::get().save(batched);
+
+    MapObjects objects;
+    fill(objects, mobs, drops);
+
+    // Let the objects land before timing, as they would have long since in
+    // a game
+    for (size_t i = 0; i < 200; i++) {
+        objects.update(physics);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < TICKS; i++) {
+        objects.update(physics);
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / TICKS;
+}
+}  // namespace
+}  // namespace ms
+
+int main(int argc, char **argv) {
+    size_t mobs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300;
+    size_t drops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 600;
+
+    // Configuration saves its file into the working directory
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+    ms::NxBuilder builder;
+    ms::add_footholds(builder, ms::NxBuilder::ROOT, ms::make_footholds(400, 8000, 1));
+
+    std::string path = (std::filesystem::temp_directory_path() / "PhysicsBench.nx").string();
+    builder.write(path);
+
+    {
+        nl::file file(path);
+        ms::Physics physics(file.root()["foothold"]);
+
+        double single = ms::measure(physics, mobs, drops, false);
+        double batched = ms::measure(physics, mobs, drops, true);
+
+        std::printf("%zu mobs, %zu drops, us/tick\n", mobs, drops);
+        std::printf("per object  %8.2f\n", single);
+        std::printf("batched     %8.2f\n", batched);
+    }
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
\ No newline at end of file
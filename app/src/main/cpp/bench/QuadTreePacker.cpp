@@ -0,0 +1,151 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "QuadTreePacker.h"
+
+namespace ms {
+QuadTreePacker::QuadTreePacker(int16_t width, int16_t height) :
+        width_(width),
+        height_(height),
+        leftovers_([](const Leftover &first, const Leftover &second) {
+            bool width_comparison = first.width() >= second.width();
+            bool height_comparison = first.height() >= second.height();
+
+            if (width_comparison && height_comparison) {
+                return QuadTree<size_t, Leftover>::Direction::RIGHT;
+            }
+
+            if (width_comparison) {
+                return QuadTree<size_t, Leftover>::Direction::DOWN;
+            }
+
+            if (height_comparison) {
+                return QuadTree<size_t, Leftover>::Direction::UP;
+            }
+
+            return QuadTree<size_t, Leftover>::Direction::LEFT;
+        }) {
+    clear();
+}
+
+void QuadTreePacker::clear() {
+    border_x_ = 0;
+    border_y_ = 0;
+    row_bottom_ = 0;
+    row_height_ = 0;
+    used_ = 0;
+    wasted_ = 0;
+    rlid_ = 1;
+
+    leftovers_.clear();
+}
+
+void QuadTreePacker::add_leftover(int16_t x, int16_t y, int16_t width, int16_t height) {
+    leftovers_.add(rlid_, Leftover(x, y, width, height));
+    rlid_++;
+}
+
+bool QuadTreePacker::insert(int16_t width, int16_t height, int16_t &x, int16_t &y) {
+    if (width > width_ || height > height_) {
+        return false;
+    }
+
+    size_t lid = leftovers_.findnode(
+            Leftover(0, 0, width, height),
+            [](const Leftover &val, const Leftover &leaf) {
+                return val.width() <= leaf.width() && val.height() <= leaf.height();
+            });
+
+    if (lid > 0) {
+        const Leftover &leftover = leftovers_[lid];
+
+        x = leftover.left;
+        y = leftover.top;
+
+        int16_t width_delta = leftover.width() - width;
+        int16_t height_delta = leftover.height() - height;
+
+        leftovers_.erase(lid);
+
+        wasted_ -= width * height;
+
+        if (width_delta >= MINLOSIZE && height_delta >= MINLOSIZE) {
+            add_leftover(x + width, y + height, width_delta, height_delta);
+
+            if (width >= MINLOSIZE) {
+                add_leftover(x, y + height, width, height_delta);
+            }
+
+            if (height >= MINLOSIZE) {
+                add_leftover(x + width, y, width_delta, height);
+            }
+        } else if (width_delta >= MINLOSIZE) {
+            add_leftover(x + width, y, width_delta, height + height_delta);
+        } else if (height_delta >= MINLOSIZE) {
+            add_leftover(x, y + height, width + width_delta, height_delta);
+        }
+
+        used_ += width * height;
+
+        return true;
+    }
+
+    if (border_x_ + width > width_) {
+        border_x_ = 0;
+        border_y_ += row_height_;
+        row_bottom_ = 0;
+        row_height_ = 0;
+    }
+
+    // GraphicsGL cleared the whole atlas at this point
+    if (border_y_ + height > height_) {
+        return false;
+    }
+
+    x = border_x_;
+    y = border_y_;
+
+    border_x_ += width;
+
+    if (height > row_height_) {
+        if (x >= MINLOSIZE && height - row_height_ >= MINLOSIZE) {
+            add_leftover(0, row_bottom_, x, height - row_height_);
+        }
+
+        wasted_ += x * (height - row_height_);
+
+        row_bottom_ = y + height;
+        row_height_ = height;
+    } else if (height < row_bottom_ - y) {
+        if (width >= MINLOSIZE && row_bottom_ - y - height >= MINLOSIZE) {
+            add_leftover(x, y + height, width, row_bottom_ - y - height);
+        }
+
+        wasted_ += width * (row_bottom_ - y - height);
+    }
+
+    used_ += width * height;
+
+    return true;
+}
+
+size_t QuadTreePacker::get_used() const {
+    return used_;
+}
+
+size_t QuadTreePacker::get_wasted() const {
+    return wasted_ > 0 ? static_cast<size_t>(wasted_) : 0;
+}
+}  // namespace ms
\ No newline at end of file
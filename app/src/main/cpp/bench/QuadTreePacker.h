@@ -0,0 +1,75 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "QuadTree.h"
+
+#include "Util/RectanglePacker.h"
+
+namespace ms {
+// The atlas allocator GraphicsGL used before the skyline packer: bitmaps
+// are placed in rows, and the gaps left below shorter bitmaps are kept as
+// leftovers in a QuadTree. Kept here so the benchmark can compare the two.
+class QuadTreePacker : public RectanglePacker {
+public:
+    QuadTreePacker(int16_t width, int16_t height);
+
+    void clear() override;
+
+    bool insert(int16_t width, int16_t height, int16_t &x, int16_t &y) override;
+
+    size_t get_used() const override;
+
+    size_t get_wasted() const override;
+
+private:
+    struct Leftover {
+        int16_t left;
+        int16_t right;
+        int16_t top;
+        int16_t bottom;
+
+        Leftover(int16_t x, int16_t y, int16_t width, int16_t height) {
+            left = x;
+            right = x + width;
+            top = y;
+            bottom = y + height;
+        }
+
+        Leftover() : Leftover(0, 0, 0, 0) {}
+
+        int16_t width() const { return right - left; }
+
+        int16_t height() const { return bottom - top; }
+    };
+
+    void add_leftover(int16_t x, int16_t y, int16_t width, int16_t height);
+
+    static const int16_t MINLOSIZE = 32;
+
+    int16_t width_;
+    int16_t height_;
+    int16_t border_x_;
+    int16_t border_y_;
+    int16_t row_bottom_;
+    int16_t row_height_;
+    size_t used_;
+    // Filling a leftover subtracts from the waste, so this can go negative
+    int64_t wasted_;
+    size_t rlid_;
+    QuadTree<size_t, Leftover> leftovers_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,91 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "LegacyRandomizer.h"
+
+#include "Util/Randomizer.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Draws per second of the randomizer before and after it kept one engine
+// per thread. The mix follows the client's hot paths: mob AI picks moves
+// with next_int, damage lines roll below and next_real.
+namespace ms {
+namespace {
+template<typename R>
+double run(const R &randomizer, size_t rounds, int64_t &sink) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < rounds; i++) {
+        sink += randomizer.template next_int<int32_t>(0, 100);
+        sink += randomizer.below(0.3f) ? 1 : 0;
+        sink += static_cast<int64_t>(randomizer.template next_real<double>(10.0, 200.0));
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return 3 * rounds / elapsed.count();
+}
+
+// The rolls of a six-line attack, drawn one by one or in one batch
+double run_lines(bool batched, size_t rounds, double &sink) {
+    Randomizer randomizer;
+    std::array<float, 18> rolls;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < rounds; i++) {
+        if (batched) {
+            randomizer.next_reals(rolls.begin(), rolls.end(), 0.0f, 1.0f);
+        } else {
+            for (float &roll : rolls) {
+                roll = randomizer.next_real(1.0f);
+            }
+        }
+
+        sink += rolls[i % rolls.size()];
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return rolls.size() * rounds / elapsed.count();
+}
+}  // namespace
+}  // namespace ms
+
+int main(int argc, char **argv) {
+    size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+    int64_t sink = 0;
+    double reals = 0;
+
+    // The old randomizer makes a syscall per draw, give it fewer rounds
+    double before = ms::run(ms::LegacyRandomizer(), rounds / 1000, sink);
+    double after = ms::run(ms::Randomizer(), rounds, sink);
+
+    std::printf("before %10.3g draws/s\n", before);
+    std::printf("after  %10.3g draws/s (%.0fx)\n", after, after / before);
+
+    double single = ms::run_lines(false, rounds / 10, reals);
+    double batched = ms::run_lines(true, rounds / 10, reals);
+
+    std::printf("attack rolls one by one %10.3g draws/s, batched %10.3g draws/s\n",
+                single,
+                batched);
+
+    // Keep the draws from being optimized away
+    return sink + reals == 0.5 ? 1 : 0;
+}
\ No newline at end of file
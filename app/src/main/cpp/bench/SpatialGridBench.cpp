@@ -0,0 +1,126 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Box.h"
+
+#include "Gameplay/MapleMap/SpatialGrid.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Range query latency over a scan of every object and over the spatial grid,
+// with thousands of objects on a 6000x3000 map. The ranges are about the
+// size of an attack or a loot area.
+namespace ms {
+namespace {
+const size_t QUERIES = 20000;
+const size_t MOVES = 1000000;
+
+template<typename F>
+double per_query(const std::vector<Rectangle<int16_t>> &ranges, size_t &hits, F query) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto &range : ranges) {
+        hits += query(range);
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / ranges.size();
+}
+
+void measure(size_t count) {
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<int16_t> x(-3000, 3000);
+    std::uniform_int_distribution<int16_t> y(-1500, 1500);
+
+    std::vector<std::unique_ptr<Box>> boxes;
+    SpatialGrid grid;
+
+    for (size_t i = 0; i < count; i++) {
+        boxes.push_back(std::make_unique<Box>(static_cast<int32_t>(i),
+                                              Point<int16_t>(x(engine), y(engine)),
+                                              Rectangle<int16_t>(-30, 30, -80, 0)));
+        grid.insert(boxes.back().get());
+    }
+
+    std::vector<Rectangle<int16_t>> ranges;
+
+    for (size_t i = 0; i < QUERIES; i++) {
+        int16_t left = x(engine);
+        int16_t top = y(engine);
+        ranges.emplace_back(left, left + 300, top, top + 120);
+    }
+
+    size_t scan_hits = 0;
+    size_t grid_hits = 0;
+
+    double scan = per_query(ranges, scan_hits, [&](const Rectangle<int16_t> &range) {
+        size_t found = 0;
+
+        for (const auto &box : boxes) {
+            found += box->hits(range) ? 1 : 0;
+        }
+
+        return found;
+    });
+
+    double indexed = per_query(ranges, grid_hits, [&](const Rectangle<int16_t> &range) {
+        size_t found = 0;
+
+        grid.query(range, [&](const MapObject &object) {
+            found += static_cast<const Box &>(object).hits(range) ? 1 : 0;
+
+            return false;
+        });
+
+        return found;
+    });
+
+    if (scan_hits != grid_hits) {
+        std::fprintf(stderr, "the grid found %zu hits, the scan %zu\n", grid_hits, scan_hits);
+    }
+
+    // Objects walk a few pixels per update, like mobs do
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < MOVES; i++) {
+        Box &box = *boxes[i % count];
+        box.set_position(box.get_position() + Point<int16_t>(i % 2 ? 3 : -2, 0));
+        grid.update(&box);
+    }
+
+    std::chrono::duration<double, std::nano> moving = std::chrono::steady_clock::now() - start;
+
+    std::printf("%5zu objects: scan %7.2f us/query, grid %5.2f us/query, "
+                "%5.1f ns per grid update\n",
+                count,
+                scan,
+                indexed,
+                moving.count() / MOVES);
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    for (size_t count : { 100, 1000, 5000, 20000 }) {
+        ms::measure(count);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -15,46 +15,39 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "Audio.h"
 
-#include <bass.h>
-
 #include <nlnx/audio.hpp>
 #include <nlnx/nx.hpp>
 #include <utility>
 
 #include "../Configuration.h"
+#include "AudioBackend.h"
+#include "MusicPlayer.h"
+#include "SoundCache.h"
 
 namespace ms {
-Sound::Sound(Name name) : id_(soundids_[name]) {}
-
-Sound::Sound(int32_t itemid) {
-    auto fitemid = format_id(itemid);
-
-    if (itemids_.find(fitemid) != itemids_.end()) {
-        id_ = itemids_.at(fitemid);
-    } else {
-        auto pid = (10000 * (itemid / 10000));
-        auto fpid = format_id(pid);
+// Interface and game sounds are preferred when too many sounds play at once
+Sound::Sound(Name name) : id_(soundids_[name]), priority_(1) {}
 
-        if (itemids_.find(fpid) != itemids_.end()) {
-            id_ = itemids_.at(fpid);
-        } else {
-            id_ = itemids_.at("02000000");
-        }
-    }
-}
+Sound::Sound(int32_t itemid) : id_(find_item(itemid)), priority_(0) {}
 
-Sound::Sound(const nl::node &src) : id_(add_sound(src)) {}
+Sound::Sound(const nl::node &src) : id_(add_sound(src)), priority_(0) {}
 
-Sound::Sound() : id_(0) {}
+Sound::Sound() : id_(0), priority_(0) {}
 
 void Sound::play() const {
     if (id_ > 0) {
-        play(id_);
+        play(id_, priority_);
+    }
+}
+
+void Sound::prefetch() const {
+    if (id_ > 0 && Setting<SoundPrefetch>::get().load()) {
+        SoundCache::get().prefetch(id_);
     }
 }
 
 Error Sound::init() {
-    if (!BASS_Init(-1, 44100, 0, nullptr, 0)) {
+    if (!AudioBackend::get().init()) {
         return Error::Code::AUDIO;
     }
 
@@ -86,11 +79,10 @@ Error Sound::init() {
     add_sound(Sound::Name::LEVEL_UP, gamesrc["LevelUp"]);
     add_sound(Sound::Name::TOMBSTONE, gamesrc["Tombstone"]);
 
-    nl::node itemsrc = nl::nx::sound["Item.img"];
-
-    for (const auto &node : itemsrc) {
-        add_sound(node.name(), node["Use"]);
-    }
+    // Sounds are decoded when first played, item sounds are also looked up
+    // only when needed
+    size_t budget = Setting<SoundCacheSize>::get().load();
+    SoundCache::get().set_budget(budget * 1024);
 
     uint8_t volume = Setting<SFXVolume>::get().load();
 
@@ -102,61 +94,23 @@ Error Sound::init() {
 }
 
 void Sound::close() {
-    BASS_Free();
+    SoundCache::get().close();
+    MusicPlayer::get().close();
+    AudioBackend::get().close();
 }
 
 bool Sound::set_sfxvolume(uint8_t vol) {
-    return BASS_SetConfig(BASS_CONFIG_GVOL_SAMPLE, vol * 100) == TRUE;
+    return AudioBackend::get().set_sample_volume(vol);
 }
 
-void Sound::play(size_t id) {
-    if (!samples_.count(id)) {
-        return;
-    }
-
-    auto channel =
-        BASS_SampleGetChannel(static_cast<HSAMPLE>(samples_.at(id)), false);
-    BASS_ChannelPlay(channel, true);
+void Sound::play(size_t id, int8_t priority) {
+    SoundCache::get().play(id, 1.0f, 0.0f, priority);
 }
 
 size_t Sound::add_sound(const nl::node &src) {
     nl::audio ad = src;
 
-    const auto *data = reinterpret_cast<const void *>(ad.data());
-
-    if (data) {
-        size_t id = ad.id();
-
-        if (auto sample =
-                BASS_SampleLoad(true,
-                                data,
-                                82,  // not used when mem (1st param) is true
-                                static_cast<DWORD>(ad.length()),
-                                4,
-                                BASS_SAMPLE_OVER_POS);
-            sample != 0) {
-            samples_[id] = sample;
-        } else {
-            const auto *data2 = reinterpret_cast<const char *>(ad.data());
-            auto sample2 =
-                BASS_SampleLoad(true,
-                                reinterpret_cast<const void *>(data2 + 82),
-                                82,  // not used when mem (1st param) is true
-                                static_cast<DWORD>(ad.length()),
-                                4,
-                                BASS_SAMPLE_OVER_POS);
-
-            if (sample2 == 0) {
-//                auto ec = BASS_ErrorGetCode();
-            } else {
-                samples_[id] = sample2;
-            }
-        }
-
-        return id;
-    }
-
-    return 0;
+    return SoundCache::get().add(ad);
 }
 
 void Sound::add_sound(Name name, const nl::node &src) {
@@ -167,12 +121,25 @@ void Sound::add_sound(Name name, const nl::node &src) {
     }
 }
 
-void Sound::add_sound(const std::string &itemid, const nl::node &src) {
-    size_t id = add_sound(src);
+size_t Sound::find_item(int32_t itemid) {
+    int32_t group = 10000 * (itemid / 10000);
 
-    if (id) {
-        itemids_[itemid] = id;
+    for (int32_t id : { itemid, group, 2000000 }) {
+        std::string strid = format_id(id);
+        auto iter = itemids_.find(strid);
+
+        // Also remember items without a sound, as 0
+        if (iter == itemids_.end()) {
+            nl::node src = nl::nx::sound["Item.img"][strid]["Use"];
+            iter = itemids_.emplace(strid, add_sound(src)).first;
+        }
+
+        if (iter->second) {
+            return iter->second;
+        }
     }
+
+    return 0;
 }
 
 std::string Sound::format_id(int32_t itemid) {
@@ -182,7 +149,6 @@ std::string Sound::format_id(int32_t itemid) {
     return strid;
 }
 
-std::unordered_map<size_t, uint64_t> Sound::samples_;
 EnumMap<Sound::Name, size_t> Sound::soundids_;
 std::unordered_map<std::string, size_t> Sound::itemids_;
 
@@ -191,59 +157,15 @@ Music::Music(std::string p) {
 }
 
 void Music::play() const {
-    static HSTREAM stream = 0;
-    static std::string bgmpath = "";
-
-    if (path_ == bgmpath) {
-        return;
-    }
-
-    nl::audio ad = nl::nx::sound.resolve(path_);
-    const auto *data = reinterpret_cast<const void *>(ad.data());
-
-    if (data) {
-        if (stream) {
-            BASS_ChannelStop(stream);
-            BASS_StreamFree(stream);
-        }
-
-        stream = BASS_StreamCreateFile(true,
-                                       data,
-                                       82,
-                                       ad.length(),
-                                       BASS_SAMPLE_FLOAT | BASS_SAMPLE_LOOP);
-        BASS_ChannelPlay(stream, true);
-
-        bgmpath = path_;
-    }
+    MusicPlayer::get().play(path_, true);
 }
 
 void Music::play_once() const {
-    static HSTREAM stream = 0;
-    static std::string bgmpath = "";
-
-    if (path_ == bgmpath) {
-        return;
-    }
-
-    nl::audio ad = nl::nx::sound.resolve(path_);
-    const auto *data = reinterpret_cast<const void *>(ad.data());
-
-    if (data) {
-        if (stream) {
-            BASS_ChannelStop(stream);
-            BASS_StreamFree(stream);
-        }
-
-        stream = BASS_StreamCreateFile(true,
-                                       data,
-                                       82,
-                                       ad.length(),
-                                       BASS_SAMPLE_FLOAT);
-        BASS_ChannelPlay(stream, true);
+    MusicPlayer::get().play(path_, false);
+}
 
-        bgmpath = path_;
-    }
+void Music::prefetch() const {
+    MusicPlayer::get().prefetch(path_);
 }
 
 Error Music::init() {
@@ -257,8 +179,10 @@ Error Music::init() {
 }
 
 bool Music::set_bgmvolume(uint8_t vol) {
-    return BASS_SetConfig(BASS_CONFIG_GVOL_STREAM, vol * 100) == TRUE;
+    return AudioBackend::get().set_stream_volume(vol);
 }
 
-void Music::update_context() {}
+void Music::update_context() {
+    MusicPlayer::get().update();
+}
 }  // namespace ms
\ No newline at end of file
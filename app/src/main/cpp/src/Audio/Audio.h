@@ -64,22 +64,27 @@ public:
 
     void play() const;
 
+    // Decode the sound in the background so that it is ready when played.
+    void prefetch() const;
+
     static Error init();
     static void close();
     static bool set_sfxvolume(uint8_t volume);
 
 private:
     size_t id_;
+    int8_t priority_;
 
-    static void play(size_t id);
+    static void play(size_t id, int8_t priority);
 
     static size_t add_sound(const nl::node &src);
     static void add_sound(Name name, const nl::node &src);
-    static void add_sound(const std::string &itemid, const nl::node &src);
+
+    // Find the sound of an item, or of its group if it has none
+    static size_t find_item(int32_t itemid);
 
     static std::string format_id(int32_t itemid);
 
-    static std::unordered_map<size_t, uint64_t> samples_;
     static EnumMap<Name, size_t> soundids_;
     static std::unordered_map<std::string, size_t> itemids_;
 };
@@ -91,6 +96,9 @@ public:
     void play() const;
     void play_once() const;
 
+    // Decode the music in the background so that it is ready when played.
+    void prefetch() const;
+
     static Error init();
     static bool set_bgmvolume(uint8_t volume);
     static void update_context();
@@ -0,0 +1,52 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "AudioBackend.h"
+
+#include "../Configuration.h"
+#include "BassBackend.h"
+#include "MixerBackend.h"
+
+namespace ms {
+AudioBackend &AudioBackend::get() {
+    if (!instance_) {
+        instance_ = create(Setting<AudioOutput>::get().load());
+    }
+
+    return *instance_;
+}
+
+void AudioBackend::set(std::unique_ptr<AudioBackend> backend) {
+    if (instance_) {
+        instance_->close();
+    }
+
+    instance_ = std::move(backend);
+}
+
+std::unique_ptr<AudioBackend> AudioBackend::create(const std::string &name) {
+    if (name == "mixer") {
+        return std::make_unique<MixerBackend>(MixerBackend::Output::DEVICE);
+    }
+
+    if (name == "none") {
+        return std::make_unique<MixerBackend>(MixerBackend::Output::NONE);
+    }
+
+    return std::make_unique<BassBackend>();
+}
+
+std::unique_ptr<AudioBackend> AudioBackend::instance_;
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,102 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ms {
+// Interface to the library which decodes and plays audio
+// Samples are short sounds which are decoded once and can play several
+// times at once, streams are decoded while they play and are used for music.
+// Handles returned by a backend are never 0, 0 means failure.
+class AudioBackend {
+public:
+    // Decoding progress of a stream
+    struct StreamStats {
+        // Frames which are decoded ahead and waiting to play
+        size_t buffered;
+        // How often the stream had nothing decoded when it had to play
+        uint64_t underruns;
+    };
+
+    virtual ~AudioBackend() = default;
+
+    // Open the output, return false on failure.
+    virtual bool init() = 0;
+
+    // Stop all audio and close the output.
+    virtual void close() = 0;
+
+    // Create a sample from encoded audio data.
+    virtual uint64_t load_sample(const void *data, size_t length) = 0;
+
+    // Free a sample, stopping it if it is playing.
+    virtual void free_sample(uint64_t sample) = 0;
+
+    // Return the number of bytes used by a decoded sample.
+    virtual size_t get_sample_size(uint64_t sample) const = 0;
+
+    // Return whether a sample is still playing anywhere.
+    virtual bool is_sample_playing(uint64_t sample) const = 0;
+
+    // Play a sample with a gain from 0 to 1 and a pan from -1 (left) to 1
+    // (right). Sounds with a higher priority replace others when too many
+    // play at once.
+    virtual void play_sample(uint64_t sample,
+                             float gain,
+                             float pan,
+                             int8_t priority) = 0;
+
+    // Create a stream from encoded audio data.
+    virtual uint64_t create_stream(const void *data,
+                                   size_t length,
+                                   bool loop) = 0;
+
+    // Start playing a stream.
+    virtual void play_stream(uint64_t stream) = 0;
+
+    // Stop and free a stream.
+    virtual void free_stream(uint64_t stream) = 0;
+
+    // Set the gain of one stream from 0 to 1, used for fading music.
+    virtual void set_stream_gain(uint64_t stream, float gain) = 0;
+
+    virtual StreamStats get_stream_stats(uint64_t stream) const = 0;
+
+    // Set the volume of all samples, from 0 to 100.
+    virtual bool set_sample_volume(uint8_t volume) = 0;
+
+    // Set the volume of all streams, from 0 to 100.
+    virtual bool set_stream_volume(uint8_t volume) = 0;
+
+    // Return the backend used for all sounds and music.
+    // It is created from the AudioOutput setting when first needed.
+    static AudioBackend &get();
+
+    // Replace the backend used for all sounds and music.
+    static void set(std::unique_ptr<AudioBackend> backend);
+
+    // Create a backend by name: "bass", "mixer" or "none".
+    // Unknown names create the bass backend.
+    static std::unique_ptr<AudioBackend> create(const std::string &name);
+
+private:
+    static std::unique_ptr<AudioBackend> instance_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,157 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "BassBackend.h"
+
+#include <bass.h>
+
+namespace ms {
+bool BassBackend::init() {
+    return BASS_Init(-1, 44100, 0, nullptr, nullptr) == TRUE;
+}
+
+void BassBackend::close() {
+    BASS_Free();
+}
+
+uint64_t BassBackend::load_sample(const void *data, size_t length) {
+    const auto *bytes = reinterpret_cast<const char *>(data);
+    auto size = static_cast<DWORD>(length);
+
+    // The offset is not used when loading from memory
+    HSAMPLE sample =
+        BASS_SampleLoad(true, bytes, 82, size, 4, BASS_SAMPLE_OVER_POS);
+
+    if (!sample && size > 82) {
+        // Skip the header which precedes some sounds
+        sample = BASS_SampleLoad(true,
+                                 bytes + 82,
+                                 82,
+                                 size - 82,
+                                 4,
+                                 BASS_SAMPLE_OVER_POS);
+    }
+
+    return sample;
+}
+
+void BassBackend::free_sample(uint64_t sample) {
+    BASS_SampleFree(static_cast<HSAMPLE>(sample));
+}
+
+size_t BassBackend::get_sample_size(uint64_t sample) const {
+    BASS_SAMPLE info = {};
+
+    if (!BASS_SampleGetInfo(static_cast<HSAMPLE>(sample), &info)) {
+        return 0;
+    }
+
+    return info.length;
+}
+
+bool BassBackend::is_sample_playing(uint64_t sample) const {
+    // Samples are loaded with at most 4 channels, which stay with their
+    // sample after they end until they are reused
+    HCHANNEL channels[4];
+    DWORD count =
+        BASS_SampleGetChannels(static_cast<HSAMPLE>(sample), channels);
+
+    if (count == static_cast<DWORD>(-1)) {
+        return false;
+    }
+
+    for (DWORD i = 0; i < count; i++) {
+        if (BASS_ChannelIsActive(channels[i]) == BASS_ACTIVE_PLAYING) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void BassBackend::play_sample(uint64_t sample,
+                              float gain,
+                              float pan,
+                              int8_t) {
+    // BASS limits how often each sample plays at once by itself
+    HCHANNEL channel =
+        BASS_SampleGetChannel(static_cast<HSAMPLE>(sample), false);
+
+    if (gain != 1.0f) {
+        BASS_ChannelSetAttribute(channel, BASS_ATTRIB_VOL, gain);
+    }
+
+    if (pan != 0.0f) {
+        BASS_ChannelSetAttribute(channel, BASS_ATTRIB_PAN, pan);
+    }
+
+    BASS_ChannelPlay(channel, true);
+}
+
+uint64_t BassBackend::create_stream(const void *data,
+                                    size_t length,
+                                    bool loop) {
+    DWORD flags = BASS_SAMPLE_FLOAT;
+
+    if (loop) {
+        flags |= BASS_SAMPLE_LOOP;
+    }
+
+    return BASS_StreamCreateFile(true, data, 82, length, flags);
+}
+
+void BassBackend::play_stream(uint64_t stream) {
+    BASS_ChannelPlay(static_cast<HSTREAM>(stream), true);
+}
+
+void BassBackend::free_stream(uint64_t stream) {
+    BASS_ChannelStop(static_cast<HSTREAM>(stream));
+    BASS_StreamFree(static_cast<HSTREAM>(stream));
+}
+
+void BassBackend::set_stream_gain(uint64_t stream, float gain) {
+    // BASS ramps volume changes by itself
+    BASS_ChannelSetAttribute(static_cast<HSTREAM>(stream),
+                             BASS_ATTRIB_VOL,
+                             gain);
+}
+
+AudioBackend::StreamStats BassBackend::get_stream_stats(
+    uint64_t stream) const {
+    auto handle = static_cast<HSTREAM>(stream);
+    BASS_CHANNELINFO info = {};
+
+    if (!BASS_ChannelGetInfo(handle, &info) || info.chans == 0) {
+        return { 0, 0 };
+    }
+
+    // BASS decodes into its playback buffer but does not count underruns
+    DWORD bytes = BASS_ChannelGetData(handle, nullptr, BASS_DATA_AVAILABLE);
+
+    if (bytes == static_cast<DWORD>(-1)) {
+        return { 0, 0 };
+    }
+
+    return { bytes / (sizeof(float) * info.chans), 0 };
+}
+
+bool BassBackend::set_sample_volume(uint8_t volume) {
+    return BASS_SetConfig(BASS_CONFIG_GVOL_SAMPLE, volume * 100) == TRUE;
+}
+
+bool BassBackend::set_stream_volume(uint8_t volume) {
+    return BASS_SetConfig(BASS_CONFIG_GVOL_STREAM, volume * 100) == TRUE;
+}
+}  // namespace ms
\ No newline at end of file
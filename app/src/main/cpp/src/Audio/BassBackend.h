@@ -0,0 +1,57 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "AudioBackend.h"
+
+namespace ms {
+// Plays audio with the BASS library, which also does the mixing
+class BassBackend : public AudioBackend {
+public:
+    bool init() override;
+
+    void close() override;
+
+    uint64_t load_sample(const void *data, size_t length) override;
+
+    void free_sample(uint64_t sample) override;
+
+    size_t get_sample_size(uint64_t sample) const override;
+
+    bool is_sample_playing(uint64_t sample) const override;
+
+    void play_sample(uint64_t sample,
+                     float gain,
+                     float pan,
+                     int8_t priority) override;
+
+    uint64_t create_stream(const void *data,
+                           size_t length,
+                           bool loop) override;
+
+    void play_stream(uint64_t stream) override;
+
+    void free_stream(uint64_t stream) override;
+
+    void set_stream_gain(uint64_t stream, float gain) override;
+
+    StreamStats get_stream_stats(uint64_t stream) const override;
+
+    bool set_sample_volume(uint8_t volume) override;
+
+    bool set_stream_volume(uint8_t volume) override;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,386 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Mixer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ms {
+namespace {
+// Four floats which the compiler maps to SSE or NEON registers
+using float4 = float __attribute__((vector_size(16)));
+
+float4 load(const float *src) {
+    float4 value;
+    std::memcpy(&value, src, sizeof(value));
+
+    return value;
+}
+
+void store(float *dst, float4 value) {
+    std::memcpy(dst, &value, sizeof(value));
+}
+}  // namespace
+
+double Mixer::Stats::cost() const {
+    if (frames == 0) {
+        return 0.0;
+    }
+
+    double seconds = static_cast<double>(frames) / RATE;
+
+    return mix_time / 1000.0 / seconds;
+}
+
+Mixer::Mixer(size_t max_voices) :
+    max_voices_(max_voices),
+    sample_gain_(1.0f),
+    stream_gain_(1.0f),
+    next_order_(0),
+    next_stream_(1),
+    peak_voices_(0),
+    played_(0),
+    stolen_(0),
+    dropped_(0),
+    frames_(0),
+    mix_time_(0) {}
+
+bool Mixer::play(std::shared_ptr<const Pcm> pcm,
+                 float gain,
+                 float pan,
+                 int8_t priority) {
+    if (!pcm || pcm->empty()) {
+        return false;
+    }
+
+    pan = std::clamp(pan, -1.0f, 1.0f);
+
+    Voice voice = { std::move(pcm),
+                    0,
+                    gain * (pan > 0.0f ? 1.0f - pan : 1.0f),
+                    gain * (pan < 0.0f ? 1.0f + pan : 1.0f),
+                    priority,
+                    0 };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    voice.order = next_order_++;
+    size_t victim = find_victim(voice.pcm.get(), priority);
+
+    if (victim < voices_.size()) {
+        voices_[victim] = std::move(voice);
+        stolen_++;
+    } else if (voices_.size() < max_voices_) {
+        voices_.push_back(std::move(voice));
+        peak_voices_ = std::max(peak_voices_, voices_.size());
+    } else {
+        dropped_++;
+
+        return false;
+    }
+
+    played_++;
+
+    return true;
+}
+
+size_t Mixer::find_victim(const Pcm *pcm, int8_t priority) const {
+    // Called with the mutex held
+    size_t count = voices_.size();
+    size_t instances = 0;
+    size_t oldest_instance = count;
+
+    for (size_t i = 0; i < count; i++) {
+        if (voices_[i].pcm.get() == pcm) {
+            instances++;
+
+            if (oldest_instance == count
+                || voices_[i].order < voices_[oldest_instance].order) {
+                oldest_instance = i;
+            }
+        }
+    }
+
+    // Restart the oldest copy of a sound which already plays too often
+    if (instances >= MAX_INSTANCES) {
+        return oldest_instance;
+    }
+
+    if (count < max_voices_) {
+        return count;
+    }
+
+    size_t victim = count;
+
+    for (size_t i = 0; i < count; i++) {
+        const Voice &voice = voices_[i];
+
+        if (voice.priority > priority) {
+            continue;
+        }
+
+        if (victim == count || voice.priority < voices_[victim].priority
+            || (voice.priority == voices_[victim].priority
+                && voice.order < voices_[victim].order)) {
+            victim = i;
+        }
+    }
+
+    return victim;
+}
+
+void Mixer::stop(const Pcm *pcm) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    voices_.erase(std::remove_if(voices_.begin(),
+                                 voices_.end(),
+                                 [pcm](const Voice &voice) {
+                                     return voice.pcm.get() == pcm;
+                                 }),
+                  voices_.end());
+}
+
+bool Mixer::is_playing(const Pcm *pcm) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return std::any_of(voices_.begin(),
+                       voices_.end(),
+                       [pcm](const Voice &voice) {
+                           return voice.pcm.get() == pcm;
+                       });
+}
+
+uint64_t Mixer::add_stream(Source source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t id = next_stream_++;
+    streams_.push_back({ id,
+                         std::make_shared<Source>(std::move(source)),
+                         false,
+                         1.0f,
+                         1.0f });
+
+    return id;
+}
+
+void Mixer::start_stream(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (Stream &stream : streams_) {
+        if (stream.id == id) {
+            stream.playing = true;
+        }
+    }
+}
+
+void Mixer::remove_stream(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    streams_.erase(std::remove_if(streams_.begin(),
+                                  streams_.end(),
+                                  [id](const Stream &stream) {
+                                      return stream.id == id;
+                                  }),
+                   streams_.end());
+}
+
+void Mixer::set_stream_gain(uint64_t id, float gain) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (Stream &stream : streams_) {
+        if (stream.id == id) {
+            stream.target = gain;
+        }
+    }
+}
+
+void Mixer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    voices_.clear();
+    streams_.clear();
+}
+
+void Mixer::set_sample_gain(float gain) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    sample_gain_ = gain;
+}
+
+void Mixer::set_stream_gain(float gain) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stream_gain_ = gain;
+}
+
+void Mixer::set_max_voices(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    max_voices_ = count;
+
+    if (voices_.size() > max_voices_) {
+        voices_.resize(max_voices_);
+    }
+}
+
+void Mixer::mix(float *out, size_t frames) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::fill(out, out + frames * 2, 0.0f);
+
+    float stream_gain;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (size_t i = 0; i < voices_.size();) {
+            Voice &voice = voices_[i];
+            size_t length = voice.pcm->size() / 2;
+            size_t count = std::min(frames, length - voice.position);
+
+            accumulate(out,
+                       voice.pcm->data() + voice.position * 2,
+                       count,
+                       voice.left * sample_gain_,
+                       voice.right * sample_gain_);
+
+            voice.position += count;
+
+            if (voice.position >= length) {
+                voices_[i] = std::move(voices_.back());
+                voices_.pop_back();
+            } else {
+                i++;
+            }
+        }
+
+        for (const Stream &stream : streams_) {
+            if (stream.playing) {
+                playing_.push_back({ stream.id,
+                                     stream.source,
+                                     stream.gain,
+                                     stream.target,
+                                     false });
+            }
+        }
+
+        stream_gain = stream_gain_;
+    }
+
+    scratch_.resize(frames * 2);
+
+    for (Playing &stream : playing_) {
+        size_t count = (*stream.source)(scratch_.data(), frames);
+        float gain = stream_gain * stream.gain;
+
+        if (stream.gain != stream.target) {
+            ramp(scratch_.data(), count, stream.gain, stream.target);
+            gain = stream_gain;
+        }
+
+        accumulate(out, scratch_.data(), count, gain, gain);
+        stream.ended = count < frames;
+    }
+
+    clip(out, frames);
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // The streams may have changed while their sources ran
+        for (const Playing &playing : playing_) {
+            auto iter = std::find_if(streams_.begin(),
+                                     streams_.end(),
+                                     [&](const Stream &stream) {
+                                         return stream.id == playing.id;
+                                     });
+
+            if (iter == streams_.end()) {
+                continue;
+            }
+
+            if (playing.ended) {
+                streams_.erase(iter);
+            } else {
+                iter->gain = playing.target;
+            }
+        }
+
+        frames_ += frames;
+        mix_time_ +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count();
+    }
+
+    playing_.clear();
+}
+
+Mixer::Stats Mixer::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return { voices_.size(), peak_voices_, played_,   stolen_,
+             dropped_,       frames_,      mix_time_ };
+}
+
+void Mixer::accumulate(float *out,
+                       const float *in,
+                       size_t frames,
+                       float left,
+                       float right) {
+    const float4 gain = { left, right, left, right };
+    size_t count = frames * 2;
+    size_t i = 0;
+
+    // Two frames at a time, then the last one if the count is odd
+    for (; i + 4 <= count; i += 4) {
+        store(out + i, load(out + i) + load(in + i) * gain);
+    }
+
+    for (; i < count; i += 2) {
+        out[i] += in[i] * left;
+        out[i + 1] += in[i + 1] * right;
+    }
+}
+
+void Mixer::clip(float *out, size_t frames) {
+    size_t count = frames * 2;
+
+    // Simple enough for the compiler to vectorize by itself
+    for (size_t i = 0; i < count; i++) {
+        float value = out[i];
+        value = value < -1.0f ? -1.0f : value;
+        value = value > 1.0f ? 1.0f : value;
+        out[i] = value;
+    }
+}
+
+void Mixer::ramp(float *out, size_t frames, float from, float to) {
+    if (frames == 0) {
+        return;
+    }
+
+    float step = (to - from) / frames;
+
+    for (size_t i = 0; i < frames; i++) {
+        float gain = from + step * i;
+        out[i * 2] *= gain;
+        out[i * 2 + 1] *= gain;
+    }
+}
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,167 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ms {
+// Mixes decoded sounds and streamed music into one stereo signal
+// All audio is interleaved stereo floats at RATE. The number of sounds which
+// play at once is limited, a new sound replaces the one with the lowest
+// priority, or the oldest among those. Stream sources are called without
+// holding the lock, so that a slow source does not hold up the game thread.
+class Mixer {
+public:
+    static constexpr uint32_t RATE = 44100;
+
+    // Decoded audio of a sound
+    using Pcm = std::vector<float>;
+
+    // Writes up to the requested number of frames of a stream and returns
+    // how many it wrote. Fewer frames mean the stream has ended. A mix in
+    // progress may still call the source of a stream which was just removed,
+    // so sources should own what they read.
+    using Source = std::function<size_t(float *out, size_t frames)>;
+
+    // Counters for profiling the mixer
+    struct Stats {
+        size_t voices;
+        size_t peak_voices;
+        uint64_t played;
+        uint64_t stolen;
+        uint64_t dropped;
+        uint64_t frames;
+        // Nanoseconds spent mixing
+        int64_t mix_time;
+
+        // Return microseconds spent mixing per second of audio.
+        double cost() const;
+    };
+
+    Mixer(size_t max_voices = 16);
+
+    // Play a sound, return false if it was dropped for lack of voices.
+    bool play(std::shared_ptr<const Pcm> pcm,
+              float gain,
+              float pan,
+              int8_t priority);
+
+    // Stop all voices which play a sound.
+    void stop(const Pcm *pcm);
+
+    // Return whether any voice plays a sound.
+    bool is_playing(const Pcm *pcm) const;
+
+    // Add a stream which starts paused, return its id.
+    uint64_t add_stream(Source source);
+
+    // Start or resume a stream.
+    void start_stream(uint64_t id);
+
+    // Stop and remove a stream.
+    void remove_stream(uint64_t id);
+
+    // Set the gain of one stream. The change is spread over the next mix
+    // so that fades do not click.
+    void set_stream_gain(uint64_t id, float gain);
+
+    // Stop all sounds and streams.
+    void clear();
+
+    void set_sample_gain(float gain);
+
+    void set_stream_gain(float gain);
+
+    void set_max_voices(size_t count);
+
+    // Mix the given number of frames into a buffer of twice that many
+    // floats.
+    void mix(float *out, size_t frames);
+
+    Stats get_stats() const;
+
+    // Add a signal multiplied by left and right gains to another.
+    static void accumulate(float *out,
+                           const float *in,
+                           size_t frames,
+                           float left,
+                           float right);
+
+    // Limit a signal to the range from -1 to 1.
+    static void clip(float *out, size_t frames);
+
+    // Multiply a signal by a gain which changes linearly between two values.
+    static void ramp(float *out, size_t frames, float from, float to);
+
+private:
+    struct Voice {
+        std::shared_ptr<const Pcm> pcm;
+        size_t position;
+        float left;
+        float right;
+        int8_t priority;
+        uint64_t order;
+    };
+
+    struct Stream {
+        uint64_t id;
+        std::shared_ptr<Source> source;
+        bool playing;
+        float gain;
+        float target;
+    };
+
+    // A playing stream as taken by one mix
+    struct Playing {
+        uint64_t id;
+        std::shared_ptr<Source> source;
+        float gain;
+        float target;
+        bool ended;
+    };
+
+    // Return the voice to replace with a sound of the given priority, or
+    // the number of voices if the sound should be dropped.
+    size_t find_victim(const Pcm *pcm, int8_t priority) const;
+
+    // How often one sound may play at once
+    static constexpr size_t MAX_INSTANCES = 4;
+
+    mutable std::mutex mutex_;
+    std::vector<Voice> voices_;
+    std::vector<Stream> streams_;
+    // Only used by mix
+    std::vector<Playing> playing_;
+    std::vector<float> scratch_;
+    size_t max_voices_;
+    float sample_gain_;
+    float stream_gain_;
+    uint64_t next_order_;
+    uint64_t next_stream_;
+
+    size_t peak_voices_;
+    uint64_t played_;
+    uint64_t stolen_;
+    uint64_t dropped_;
+    uint64_t frames_;
+    int64_t mix_time_;
+};
+}  // namespace ms
\ No newline at end of file
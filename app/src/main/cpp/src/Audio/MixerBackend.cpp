@@ -0,0 +1,518 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "MixerBackend.h"
+
+#include <bass.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "../Template/SpscQueue.h"
+
+namespace ms {
+namespace {
+// Reads a BASS decoding channel as interleaved stereo at Mixer::RATE
+class Decoder {
+public:
+    Decoder(HSTREAM handle, bool loop) :
+        handle_(handle),
+        loop_(loop),
+        channels_(2),
+        step_(1.0),
+        position_(0.0) {
+        BASS_CHANNELINFO info = {};
+
+        if (BASS_ChannelGetInfo(handle_, &info)) {
+            channels_ = info.chans > 0 ? info.chans : 2;
+            step_ = static_cast<double>(info.freq) / Mixer::RATE;
+        }
+    }
+
+    ~Decoder() { BASS_StreamFree(handle_); }
+
+    Decoder(const Decoder &) = delete;
+    Decoder &operator=(const Decoder &) = delete;
+
+    // Write up to the requested frames, fewer if the audio has ended
+    size_t read(float *out, size_t frames) {
+        size_t written = 0;
+
+        while (written < frames) {
+            auto index = static_cast<size_t>(position_);
+
+            // Interpolate between two frames, keep the last for the next read
+            if (index + 1 >= input_.size() / 2) {
+                if (!fill()) {
+                    break;
+                }
+
+                continue;
+            }
+
+            auto weight = static_cast<float>(position_ - index);
+            const float *first = input_.data() + index * 2;
+
+            out[written * 2] = first[0] + (first[2] - first[0]) * weight;
+            out[written * 2 + 1] = first[1] + (first[3] - first[1]) * weight;
+
+            position_ += step_;
+            written++;
+        }
+
+        return written;
+    }
+
+private:
+    bool fill() {
+        static constexpr size_t CHUNK = 2048;
+
+        size_t kept = 0;
+
+        if (input_.size() >= 2) {
+            size_t last = input_.size() / 2 - 1;
+            float left = input_[last * 2];
+            float right = input_[last * 2 + 1];
+
+            position_ -= static_cast<double>(last);
+            input_.assign({ left, right });
+            kept = 1;
+        }
+
+        buffer_.resize(CHUNK * channels_);
+
+        DWORD bytes = static_cast<DWORD>(buffer_.size() * sizeof(float));
+        DWORD got = BASS_ChannelGetData(handle_,
+                                        buffer_.data(),
+                                        bytes | BASS_DATA_FLOAT);
+
+        if ((got == static_cast<DWORD>(-1) || got == 0) && loop_) {
+            BASS_ChannelSetPosition(handle_, 0, BASS_POS_BYTE);
+            got = BASS_ChannelGetData(handle_,
+                                      buffer_.data(),
+                                      bytes | BASS_DATA_FLOAT);
+        }
+
+        if (got == static_cast<DWORD>(-1) || got == 0) {
+            return false;
+        }
+
+        size_t frames = got / sizeof(float) / channels_;
+        input_.resize((kept + frames) * 2);
+
+        for (size_t i = 0; i < frames; i++) {
+            const float *frame = buffer_.data() + i * channels_;
+            float *dst = input_.data() + (kept + i) * 2;
+
+            dst[0] = frame[0];
+            dst[1] = channels_ > 1 ? frame[1] : frame[0];
+        }
+
+        return true;
+    }
+
+    HSTREAM handle_;
+    bool loop_;
+    uint32_t channels_;
+    double step_;
+    double position_;
+    std::vector<float> buffer_;
+    std::vector<float> input_;
+};
+
+// Open encoded audio for decoding, also trying past the header which
+// precedes some sounds
+HSTREAM open_decoder(const void *data, size_t length) {
+    const auto *bytes = reinterpret_cast<const char *>(data);
+    DWORD flags = BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT;
+
+    HSTREAM handle = BASS_StreamCreateFile(true, bytes, 0, length, flags);
+
+    if (!handle && length > 82) {
+        handle = BASS_StreamCreateFile(true, bytes + 82, 0, length - 82, flags);
+    }
+
+    return handle;
+}
+
+DWORD CALLBACK play_mix(HSTREAM, void *buffer, DWORD length, void *user) {
+    auto *mixer = static_cast<Mixer *>(user);
+    size_t frames = length / (2 * sizeof(float));
+    mixer->mix(static_cast<float *>(buffer), frames);
+
+    return static_cast<DWORD>(frames * 2 * sizeof(float));
+}
+}  // namespace
+
+struct MixerBackend::Channel {
+    // Frames decoded ahead, about three quarters of a second
+    static constexpr size_t CAPACITY = 32768;
+
+    Channel(const void *data, size_t length, bool loop) :
+        data(data),
+        length(length),
+        loop(loop),
+        stream(0),
+        primed(false),
+        finished(false),
+        underruns(0) {}
+
+    // Decode until the queue is full or the audio has ended.
+    // Only called from the decoder thread.
+    void fill(std::vector<float> &buffer) {
+        if (finished.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        if (!decoder) {
+            HSTREAM handle = open_decoder(data, length);
+
+            if (!handle) {
+                finished.store(true, std::memory_order_release);
+                return;
+            }
+
+            decoder = std::make_unique<Decoder>(handle, loop);
+        }
+
+        size_t frames = buffer.size() / 2;
+
+        while (CAPACITY * 2 - queue.size() >= buffer.size()) {
+            size_t count = decoder->read(buffer.data(), frames);
+            queue.push(buffer.data(), count * 2);
+
+            if (count < frames) {
+                // Free the decoder here rather than on the mixing thread
+                decoder.reset();
+                finished.store(true, std::memory_order_release);
+                break;
+            }
+        }
+
+        primed.store(true, std::memory_order_release);
+    }
+
+    // Write the requested frames, padded with silence if the decoder fell
+    // behind. Fewer frames are written once the audio has ended.
+    // Only called from the mixing thread.
+    size_t read(float *out, size_t frames) {
+        size_t count = frames * 2;
+        bool ended = finished.load(std::memory_order_acquire);
+
+        // Stay silent until the decoder has had a chance to get ahead
+        if (!ended && !primed.load(std::memory_order_acquire)) {
+            std::fill(out, out + count, 0.0f);
+            return frames;
+        }
+
+        size_t popped = queue.pop(out, count);
+
+        if (popped == count || ended) {
+            return popped / 2;
+        }
+
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        std::fill(out + popped, out + count, 0.0f);
+
+        return frames;
+    }
+
+    const void *data;
+    size_t length;
+    bool loop;
+    uint64_t stream;
+    std::unique_ptr<Decoder> decoder;
+    SpscQueue<float, CAPACITY * 2> queue;
+    std::atomic<bool> primed;
+    std::atomic<bool> finished;
+    std::atomic<uint64_t> underruns;
+};
+
+MixerBackend::MixerBackend(Output output) :
+    output_(output),
+    device_stream_(0),
+    next_sample_(1),
+    decoding_(false),
+    closed_(false) {}
+
+MixerBackend::~MixerBackend() {
+    stop_decoder();
+}
+
+bool MixerBackend::init() {
+    // Without output BASS is still needed for decoding
+    int device = output_ == Output::DEVICE ? -1 : 0;
+
+    if (!BASS_Init(device, Mixer::RATE, 0, nullptr, nullptr)) {
+        return false;
+    }
+
+    if (output_ == Output::DEVICE) {
+        device_stream_ = BASS_StreamCreate(Mixer::RATE,
+                                           2,
+                                           BASS_SAMPLE_FLOAT,
+                                           &play_mix,
+                                           &mixer_);
+
+        if (!device_stream_) {
+            return false;
+        }
+
+        BASS_ChannelPlay(device_stream_, false);
+    }
+
+    return true;
+}
+
+void MixerBackend::close() {
+    stop_decoder();
+
+    if (device_stream_) {
+        BASS_StreamFree(device_stream_);
+        device_stream_ = 0;
+    }
+
+    mixer_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.clear();
+    BASS_Free();
+}
+
+uint64_t MixerBackend::load_sample(const void *data, size_t length) {
+    HSTREAM handle = open_decoder(data, length);
+
+    if (!handle) {
+        return 0;
+    }
+
+    auto pcm = std::make_shared<Mixer::Pcm>();
+    Decoder decoder(handle, false);
+
+    static constexpr size_t BLOCK = 4096;
+    size_t frames = 0;
+    size_t read = 0;
+
+    do {
+        pcm->resize((frames + BLOCK) * 2);
+        read = decoder.read(pcm->data() + frames * 2, BLOCK);
+        frames += read;
+    } while (read == BLOCK);
+
+    pcm->resize(frames * 2);
+    pcm->shrink_to_fit();
+
+    if (pcm->empty()) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t sample = next_sample_++;
+    samples_.emplace(sample, std::move(pcm));
+
+    return sample;
+}
+
+void MixerBackend::free_sample(uint64_t sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter = samples_.find(sample);
+
+    if (iter != samples_.end()) {
+        mixer_.stop(iter->second.get());
+        samples_.erase(iter);
+    }
+}
+
+size_t MixerBackend::get_sample_size(uint64_t sample) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter = samples_.find(sample);
+
+    if (iter == samples_.end()) {
+        return 0;
+    }
+
+    return iter->second->size() * sizeof(float);
+}
+
+bool MixerBackend::is_sample_playing(uint64_t sample) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter = samples_.find(sample);
+
+    return iter != samples_.end() && mixer_.is_playing(iter->second.get());
+}
+
+void MixerBackend::play_sample(uint64_t sample,
+                               float gain,
+                               float pan,
+                               int8_t priority) {
+    std::shared_ptr<const Mixer::Pcm> pcm;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto iter = samples_.find(sample);
+
+        if (iter == samples_.end()) {
+            return;
+        }
+
+        pcm = iter->second;
+    }
+
+    mixer_.play(std::move(pcm), gain, pan, priority);
+}
+
+uint64_t MixerBackend::create_stream(const void *data,
+                                     size_t length,
+                                     bool loop) {
+    // Opening and decoding are left to the decoder thread
+    auto channel = std::make_shared<Channel>(data, length, loop);
+    channel->stream = mixer_.add_stream([channel](float *out, size_t frames) {
+        return channel->read(out, frames);
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(channel_mutex_);
+        channels_.push_back(channel);
+        start_decoder();
+    }
+
+    condition_.notify_one();
+
+    return channel->stream;
+}
+
+void MixerBackend::play_stream(uint64_t stream) {
+    mixer_.start_stream(stream);
+}
+
+void MixerBackend::free_stream(uint64_t stream) {
+    mixer_.remove_stream(stream);
+
+    std::lock_guard<std::mutex> lock(channel_mutex_);
+
+    channels_.erase(std::remove_if(channels_.begin(),
+                                   channels_.end(),
+                                   [stream](const auto &channel) {
+                                       return channel->stream == stream;
+                                   }),
+                    channels_.end());
+}
+
+void MixerBackend::set_stream_gain(uint64_t stream, float gain) {
+    mixer_.set_stream_gain(stream, gain);
+}
+
+AudioBackend::StreamStats MixerBackend::get_stream_stats(
+    uint64_t stream) const {
+    std::shared_ptr<Channel> channel = find_channel(stream);
+
+    if (!channel) {
+        return { 0, 0 };
+    }
+
+    return { channel->queue.size() / 2,
+             channel->underruns.load(std::memory_order_relaxed) };
+}
+
+bool MixerBackend::set_sample_volume(uint8_t volume) {
+    mixer_.set_sample_gain(volume / 100.0f);
+
+    return true;
+}
+
+bool MixerBackend::set_stream_volume(uint8_t volume) {
+    mixer_.set_stream_gain(volume / 100.0f);
+
+    return true;
+}
+
+void MixerBackend::render(float *out, size_t frames) {
+    mixer_.mix(out, frames);
+}
+
+Mixer::Stats MixerBackend::get_stats() const {
+    return mixer_.get_stats();
+}
+
+void MixerBackend::start_decoder() {
+    // Called with the channel mutex held
+    if (decoding_ || closed_) {
+        return;
+    }
+
+    decoding_ = true;
+    decoder_ = std::thread(&MixerBackend::decode, this);
+}
+
+void MixerBackend::stop_decoder() {
+    {
+        std::lock_guard<std::mutex> lock(channel_mutex_);
+        decoding_ = false;
+        closed_ = true;
+        channels_.clear();
+    }
+
+    condition_.notify_all();
+
+    if (decoder_.joinable()) {
+        decoder_.join();
+    }
+}
+
+void MixerBackend::decode() {
+    static constexpr size_t CHUNK = 2048;
+
+    std::vector<float> buffer(CHUNK * 2);
+    std::unique_lock<std::mutex> lock(channel_mutex_);
+
+    while (decoding_) {
+        std::vector<std::shared_ptr<Channel>> channels = channels_;
+
+        lock.unlock();
+
+        for (auto &channel : channels) {
+            channel->fill(buffer);
+        }
+
+        // Freeing the last reference here keeps decoders off other threads
+        channels.clear();
+
+        lock.lock();
+
+        // Top up the queues regularly, or sooner when a stream is added
+        condition_.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+std::shared_ptr<MixerBackend::Channel> MixerBackend::find_channel(
+    uint64_t stream) const {
+    std::lock_guard<std::mutex> lock(channel_mutex_);
+
+    for (const auto &channel : channels_) {
+        if (channel->stream == stream) {
+            return channel;
+        }
+    }
+
+    return nullptr;
+}
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,109 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "AudioBackend.h"
+#include "Mixer.h"
+
+namespace ms {
+// Decodes audio with BASS and mixes it in-process
+// With the DEVICE output the mix is played through a BASS stream. With NONE
+// nothing is played and the mix can be rendered into a buffer instead, for
+// headless builds and benchmarks. Music is decoded ahead on a background
+// thread so that the mix never waits for a decoder.
+class MixerBackend : public AudioBackend {
+public:
+    enum Output { DEVICE, NONE };
+
+    explicit MixerBackend(Output output);
+
+    ~MixerBackend() override;
+
+    bool init() override;
+
+    void close() override;
+
+    uint64_t load_sample(const void *data, size_t length) override;
+
+    void free_sample(uint64_t sample) override;
+
+    size_t get_sample_size(uint64_t sample) const override;
+
+    bool is_sample_playing(uint64_t sample) const override;
+
+    void play_sample(uint64_t sample,
+                     float gain,
+                     float pan,
+                     int8_t priority) override;
+
+    uint64_t create_stream(const void *data,
+                           size_t length,
+                           bool loop) override;
+
+    void play_stream(uint64_t stream) override;
+
+    void free_stream(uint64_t stream) override;
+
+    void set_stream_gain(uint64_t stream, float gain) override;
+
+    StreamStats get_stream_stats(uint64_t stream) const override;
+
+    bool set_sample_volume(uint8_t volume) override;
+
+    bool set_stream_volume(uint8_t volume) override;
+
+    // Mix the given number of frames into a buffer of twice that many
+    // floats.
+    void render(float *out, size_t frames);
+
+    Mixer::Stats get_stats() const;
+
+private:
+    // A stream and the audio decoded ahead of it
+    struct Channel;
+
+    void start_decoder();
+
+    void stop_decoder();
+
+    void decode();
+
+    std::shared_ptr<Channel> find_channel(uint64_t stream) const;
+
+    Output output_;
+    uint32_t device_stream_;
+    Mixer mixer_;
+
+    // Samples are also loaded from the background thread of SoundCache
+    mutable std::mutex mutex_;
+    uint64_t next_sample_;
+    std::unordered_map<uint64_t, std::shared_ptr<const Mixer::Pcm>> samples_;
+
+    mutable std::mutex channel_mutex_;
+    std::condition_variable condition_;
+    std::thread decoder_;
+    bool decoding_;
+    bool closed_;
+    std::vector<std::shared_ptr<Channel>> channels_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,145 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "MusicPlayer.h"
+
+#include <nlnx/audio.hpp>
+#include <nlnx/node.hpp>
+#include <nlnx/nx.hpp>
+
+#include <algorithm>
+
+#include "../Constants.h"
+#include "AudioBackend.h"
+
+namespace ms {
+MusicPlayer::MusicPlayer() :
+    current_ { "", 0, false, 0.0f },
+    previous_ { "", 0, false, 0.0f },
+    next_ { "", 0, false, 0.0f } {}
+
+void MusicPlayer::play(const std::string &path, bool loop) {
+    if (path == current_.path && loop == current_.loop) {
+        return;
+    }
+
+    AudioBackend &backend = AudioBackend::get();
+
+    // Going back to the track which is fading out fades it in again
+    if (previous_.stream && path == previous_.path && loop == previous_.loop) {
+        std::swap(current_, previous_);
+        return;
+    }
+
+    Track track;
+
+    if (next_.stream && path == next_.path && loop == next_.loop) {
+        track = next_;
+        next_ = { "", 0, false, 0.0f };
+    } else {
+        track = open(path, loop);
+
+        if (!track.stream) {
+            return;
+        }
+    }
+
+    free(previous_);
+    previous_ = current_;
+    current_ = track;
+
+    // The first track starts at full volume, later ones fade in
+    current_.gain = previous_.stream ? 0.0f : 1.0f;
+
+    backend.set_stream_gain(current_.stream, current_.gain);
+    backend.play_stream(current_.stream);
+}
+
+void MusicPlayer::prefetch(const std::string &path) {
+    if (path == current_.path || path == previous_.path
+        || path == next_.path) {
+        return;
+    }
+
+    Track track = open(path, true);
+
+    if (track.stream) {
+        free(next_);
+        next_ = track;
+    }
+}
+
+void MusicPlayer::update() {
+    constexpr float step = static_cast<float>(Constants::TIMESTEP) / FADE_TIME;
+
+    AudioBackend &backend = AudioBackend::get();
+
+    if (current_.stream && current_.gain < 1.0f) {
+        current_.gain = std::min(current_.gain + step, 1.0f);
+        backend.set_stream_gain(current_.stream, current_.gain);
+    }
+
+    if (previous_.stream) {
+        previous_.gain = std::max(previous_.gain - step, 0.0f);
+
+        if (previous_.gain > 0.0f) {
+            backend.set_stream_gain(previous_.stream, previous_.gain);
+        } else {
+            free(previous_);
+        }
+    }
+}
+
+void MusicPlayer::close() {
+    free(current_);
+    free(previous_);
+    free(next_);
+}
+
+MusicPlayer::Stats MusicPlayer::get_stats() const {
+    AudioBackend::StreamStats stats = { 0, 0 };
+
+    if (current_.stream) {
+        stats = AudioBackend::get().get_stream_stats(current_.stream);
+    }
+
+    return { current_.path,
+             stats.buffered,
+             stats.underruns,
+             previous_.stream != 0 };
+}
+
+MusicPlayer::Track MusicPlayer::open(const std::string &path, bool loop) {
+    nl::audio ad = nl::nx::sound.resolve(path);
+    const auto *data = reinterpret_cast<const void *>(ad.data());
+
+    if (!data) {
+        return { "", 0, false, 0.0f };
+    }
+
+    uint64_t stream =
+        AudioBackend::get().create_stream(data, ad.length(), loop);
+
+    return { path, stream, loop, 0.0f };
+}
+
+void MusicPlayer::free(Track &track) {
+    if (track.stream) {
+        AudioBackend::get().free_stream(track.stream);
+    }
+
+    track = { "", 0, false, 0.0f };
+}
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,76 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../Template/Singleton.h"
+
+namespace ms {
+// Plays background music and crossfades from one track to the next
+// The next track can be opened ahead of time so that it is already decoded
+// when it starts. Playing the track which is already playing keeps its
+// stream, so the music continues without a gap.
+class MusicPlayer : public Singleton<MusicPlayer> {
+public:
+    // Counters for profiling the music which is playing
+    struct Stats {
+        std::string path;
+        // Frames decoded ahead of playback
+        size_t buffered;
+        uint64_t underruns;
+        bool fading;
+    };
+
+    MusicPlayer();
+
+    // Fade from the current track to the track at a path.
+    void play(const std::string &path, bool loop);
+
+    // Open a looping track so that it is decoded before it plays.
+    void prefetch(const std::string &path);
+
+    // Advance the crossfade, called once per update.
+    void update();
+
+    // Free all streams.
+    void close();
+
+    Stats get_stats() const;
+
+private:
+    struct Track {
+        std::string path;
+        uint64_t stream;
+        bool loop;
+        float gain;
+    };
+
+    // Open a stream for a path, the stream is 0 if there is no audio.
+    static Track open(const std::string &path, bool loop);
+
+    static void free(Track &track);
+
+    // Milliseconds for one track to fade into the next
+    static constexpr uint16_t FADE_TIME = 1000;
+
+    Track current_;
+    Track previous_;
+    Track next_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,247 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "SoundCache.h"
+
+#include "AudioBackend.h"
+
+namespace ms {
+SoundCache::SoundCache() :
+    running_(false),
+    closed_(false),
+    budget_(SIZE_MAX),
+    resident_bytes_(0),
+    hits_(0),
+    misses_(0),
+    evictions_(0),
+    prefetched_(0) {}
+
+SoundCache::~SoundCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+
+    condition_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+size_t SoundCache::add(const nl::audio &audio) {
+    if (!audio.data()) {
+        return 0;
+    }
+
+    size_t id = audio.id();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.emplace(id, audio);
+
+    return id;
+}
+
+void SoundCache::play(size_t id, float gain, float pan, int8_t priority) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto iter = samples_.find(id);
+
+    if (iter != samples_.end()) {
+        hits_++;
+        recent_.splice(recent_.begin(), recent_, iter->second.position);
+    } else {
+        auto source = sources_.find(id);
+
+        if (source == sources_.end()) {
+            return;
+        }
+
+        misses_++;
+        nl::audio audio = source->second;
+
+        lock.unlock();
+
+        uint64_t sample = decode(audio);
+
+        lock.lock();
+
+        if (!sample) {
+            return;
+        }
+
+        insert(id, sample);
+        iter = samples_.find(id);
+    }
+
+    AudioBackend::get().play_sample(iter->second.sample, gain, pan, priority);
+}
+
+void SoundCache::prefetch(size_t id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (closed_ || samples_.count(id) || !sources_.count(id)) {
+            return;
+        }
+
+        if (!queued_.insert(id).second) {
+            return;
+        }
+
+        start();
+        jobs_.push_back(id);
+    }
+
+    condition_.notify_one();
+}
+
+void SoundCache::set_budget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    budget_ = bytes;
+    evict(0);
+}
+
+void SoundCache::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        closed_ = true;
+        jobs_.clear();
+        queued_.clear();
+    }
+
+    condition_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto &entry : samples_) {
+        free(entry.second.sample);
+    }
+
+    samples_.clear();
+    recent_.clear();
+    resident_bytes_ = 0;
+}
+
+SoundCache::Stats SoundCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return { hits_,       misses_,         evictions_,
+             prefetched_, samples_.size(), resident_bytes_ };
+}
+
+void SoundCache::start() {
+    // Called with the mutex held
+    if (running_ || closed_) {
+        return;
+    }
+
+    running_ = true;
+    worker_ = std::thread(&SoundCache::work, this);
+}
+
+void SoundCache::work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        condition_.wait(lock, [&]() { return !running_ || !jobs_.empty(); });
+
+        if (!running_) {
+            return;
+        }
+
+        size_t id = jobs_.front();
+        jobs_.pop_front();
+
+        nl::audio audio = sources_.at(id);
+
+        lock.unlock();
+
+        uint64_t sample = decode(audio);
+
+        lock.lock();
+
+        queued_.erase(id);
+
+        if (sample) {
+            prefetched_++;
+            insert(id, sample);
+        }
+    }
+}
+
+uint64_t SoundCache::insert(size_t id, uint64_t sample) {
+    auto iter = samples_.find(id);
+
+    // Another thread decoded the same sound first
+    if (iter != samples_.end()) {
+        free(sample);
+
+        return iter->second.sample;
+    }
+
+    size_t bytes = AudioBackend::get().get_sample_size(sample);
+
+    recent_.push_front(id);
+    samples_[id] = { sample, bytes, recent_.begin() };
+    resident_bytes_ += bytes;
+
+    evict(id);
+
+    return sample;
+}
+
+void SoundCache::evict(size_t keep) {
+    AudioBackend &backend = AudioBackend::get();
+    auto position = recent_.end();
+
+    while (resident_bytes_ > budget_ && position != recent_.begin()) {
+        --position;
+
+        auto iter = samples_.find(*position);
+
+        // Freeing a playing sample would cut it off, it is left for a later
+        // eviction once it has ended
+        if (*position == keep
+            || backend.is_sample_playing(iter->second.sample)) {
+            continue;
+        }
+
+        free(iter->second.sample);
+        resident_bytes_ -= iter->second.bytes;
+        samples_.erase(iter);
+        position = recent_.erase(position);
+        evictions_++;
+    }
+}
+
+uint64_t SoundCache::decode(const nl::audio &audio) {
+    if (!audio.data()) {
+        return 0;
+    }
+
+    return AudioBackend::get().load_sample(audio.data(), audio.length());
+}
+
+void SoundCache::free(uint64_t sample) {
+    AudioBackend::get().free_sample(sample);
+}
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,116 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <nlnx/audio.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../Template/Singleton.h"
+
+namespace ms {
+// Decoded sound effects, loaded when they are first needed
+// Samples are kept in least recently used order and the oldest are freed
+// once their total size exceeds the budget. Sounds can also be queued for
+// decoding on a background thread before they are played.
+class SoundCache : public Singleton<SoundCache> {
+public:
+    // Counters for profiling the cache
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint64_t prefetched;
+        size_t samples;
+        size_t resident_bytes;
+    };
+
+    SoundCache();
+
+    ~SoundCache() override;
+
+    // Register a sound without decoding it and return its id.
+    // Returns 0 if the audio has no data.
+    size_t add(const nl::audio &audio);
+
+    // Play a sound, decoding it first if needed. The sample is handed to
+    // the backend with the cache locked, so it cannot be evicted in between.
+    void play(size_t id, float gain, float pan, int8_t priority);
+
+    // Queue a sound for decoding on the background thread.
+    void prefetch(size_t id);
+
+    // Change the number of bytes of samples which are kept.
+    void set_budget(size_t bytes);
+
+    // Stop the background thread and free all samples.
+    void close();
+
+    Stats get_stats() const;
+
+private:
+    struct Entry {
+        uint64_t sample;
+        size_t bytes;
+        std::list<size_t>::iterator position;
+    };
+
+    void start();
+
+    void work();
+
+    // Store a decoded sample and free others if over budget.
+    // Called with the mutex held.
+    uint64_t insert(size_t id, uint64_t sample);
+
+    // Free least recently used samples until within budget, but never the
+    // sample with the given id or one which is still playing. Called with
+    // the mutex held.
+    void evict(size_t keep);
+
+    // Create a sample from audio data.
+    static uint64_t decode(const nl::audio &audio);
+
+    // Free a sample.
+    static void free(uint64_t sample);
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread worker_;
+    bool running_;
+    bool closed_;
+
+    std::unordered_map<size_t, nl::audio> sources_;
+    std::unordered_map<size_t, Entry> samples_;
+    std::list<size_t> recent_;
+    std::deque<size_t> jobs_;
+    std::unordered_set<size_t> queued_;
+
+    size_t budget_;
+    size_t resident_bytes_;
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
+    uint64_t prefetched_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -176,11 +176,15 @@ void Char::show_effect_id(CharEffect::Id toshow) {
 void Char::add_recurring_effect(int16_t effect_id,
                                 const Animation &animation,
                                 int8_t z) {
-    recurring_effects_.add(animation, DrawArgument(0, -60));
+    recurring_effects_.add(effect_id, animation, DrawArgument(0, -60));
 }
 
 void Char::remove_recurring_effect() {
-    recurring_effects_ = RecurringEffect();
+    recurring_effects_.clear();
+}
+
+size_t Char::get_effect_count() const {
+    return effects_.size() + recurring_effects_.size();
 }
 
 void Char::show_iron_body() {
@@ -109,9 +109,12 @@ public:
                               const Animation &animation,
                               int8_t z);
 
-    // Remove a recurring animation.
+    // Remove all recurring animations.
     void remove_recurring_effect();
 
+    // Return the number of effects currently shown with the character.
+    size_t get_effect_count() const;
+
     // Display the iron body skill animation.
     void show_iron_body();
 
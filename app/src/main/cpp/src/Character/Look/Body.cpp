@@ -89,17 +89,17 @@ Body::Body(int32_t skin, const BodyDrawInfo &drawinfo) {
     name_ = (index < skintypes.size()) ? skintypes[index] : "";
 }
 
-void Body::draw(Stance::Id stance,
-                Layer layer,
-                uint8_t frame,
-                const DrawArgument &args) const {
+void Body::append(Stance::Id stance,
+                  Layer layer,
+                  uint8_t frame,
+                  DrawList &list) const {
     auto frameit = stances_[stance][layer].find(frame);
 
     if (frameit == stances_[stance][layer].end()) {
         return;
     }
 
-    frameit->second.draw(args);
+    list.add(frameit->second);
 }
 
 const std::string &Body::get_name() const {
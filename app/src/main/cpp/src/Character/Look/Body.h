@@ -19,6 +19,7 @@
 
 #include "../../Graphics/Texture.h"
 #include "BodyDrawInfo.h"
+#include "DrawList.h"
 
 namespace ms {
 class Body {
@@ -40,10 +41,11 @@ public:
 
     Body(int32_t skin, const BodyDrawInfo &drawinfo);
 
-    void draw(Stance::Id stance,
-              Layer layer,
-              uint8_t frame,
-              const DrawArgument &args) const;
+    // Add the texture of a layer to a draw list.
+    void append(Stance::Id stance,
+                Layer layer,
+                uint8_t frame,
+                DrawList &list) const;
 
     const std::string &get_name() const;
 
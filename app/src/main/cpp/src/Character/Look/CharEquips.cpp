@@ -22,13 +22,14 @@ CharEquips::CharEquips() {
     }
 }
 
-void CharEquips::draw(EquipSlot::Id slot,
-                      Stance::Id stance,
-                      Clothing::Layer layer,
-                      uint8_t frame,
-                      const DrawArgument &args) const {
+void CharEquips::append(EquipSlot::Id slot,
+                        Stance::Id stance,
+                        Clothing::Layer layer,
+                        uint8_t frame,
+                        DrawList &list,
+                        Point<int16_t> shift) const {
     if (const Clothing *cloth = clothes_[slot]) {
-        cloth->draw(stance, layer, frame, args);
+        cloth->append(stance, layer, frame, list, shift);
     }
 }
 
@@ -136,5 +137,9 @@ int32_t CharEquips::get_weapon() const {
     return get_equip(EquipSlot::Id::WEAPON);
 }
 
+const Clothing *CharEquips::get_cloth(EquipSlot::Id slot) const {
+    return clothes_[slot];
+}
+
 std::unordered_map<int32_t, Clothing> CharEquips::cloth_cache_;
 }  // namespace ms
\ No newline at end of file
@@ -27,12 +27,13 @@ public:
     // Initialize pointers with zero
     CharEquips();
 
-    // Draw an equip.
-    void draw(EquipSlot::Id slot,
-              Stance::Id stance,
-              Clothing::Layer layer,
-              uint8_t frame,
-              const DrawArgument &args) const;
+    // Add the textures of an equip to a draw list.
+    void append(EquipSlot::Id slot,
+                Stance::Id stance,
+                Clothing::Layer layer,
+                uint8_t frame,
+                DrawList &list,
+                Point<int16_t> shift = {}) const;
 
     // Add an equip, if not in cache, the equip is created from the files.
     void add_equip(int32_t itemid, const BodyDrawInfo &drawinfo);
@@ -70,6 +71,9 @@ public:
     // Return the item id of the equipped weapon.
     int32_t get_weapon() const;
 
+    // Return the equip at the specified slot, or nullptr.
+    const Clothing *get_cloth(EquipSlot::Id slot) const;
+
 private:
     EnumMap<EquipSlot::Id, const Clothing *> clothes_;
 
@@ -16,6 +16,7 @@
 #include "CharLook.h"
 
 #include "../../Data/WeaponData.h"
+#include "ImpostorCache.h"
 
 namespace ms {
     CharLook::CharLook(const LookEntry &entry) {
@@ -38,6 +39,8 @@ namespace ms {
         body_ = nullptr;
         hair_ = nullptr;
         face_ = nullptr;
+        look_id_ = 0;
+        look_id_generation_ = 0;
     }
 
     void CharLook::reset() {
@@ -56,75 +59,71 @@ namespace ms {
         exp_elapsed_ = 0;
     }
 
-    void CharLook::draw(const DrawArgument &args,
-                        Stance::Id interstance,
-                        Expression::Id interexpression,
-                        uint8_t interframe,
-                        uint8_t interexpframe) const {
+    void CharLook::build(DrawList &list,
+                         Stance::Id interstance,
+                         Expression::Id interexpression,
+                         uint8_t interframe,
+                         uint8_t interexpframe) const {
         Point<int16_t> faceshift = draw_info_.get_face_pos(interstance, interframe);
-        DrawArgument faceargs =
-                args + DrawArgument{faceshift, false, Point<int16_t>{}};
 
         if (Stance::Id::DEAD == interstance) {
             Point<int16_t> faceshift =
                     draw_info_.get_face_pos(Stance::Id::STAND1, 1);
-            DrawArgument faceargs =
-                    args + DrawArgument{faceshift, false, Point<int16_t>{}};
-
-            hair_->draw(interstance, Hair::Layer::BELOW_BODY, interframe, args);
-            equips_.draw(EquipSlot::Id::HAT,
-                         interstance,
-                         Clothing::Layer::CAP_BELOW_BODY,
-                         interframe,
-                         args);
-            body_->draw(interstance, Body::Layer::BODY, interframe, args);
-            hair_->draw(interstance, Hair::Layer::DEFAULT, interframe, args);
-            body_->draw(Stance::Id::STAND1, Body::Layer::HEAD, 1, args);
-            hair_->draw(interstance, Hair::Layer::SHADE, interframe, args);
-
-            hair_->draw(interstance, Hair::Layer::DEFAULT, interframe, args);
-            body_->draw(interstance, Body::Layer::HEAD, interframe, args);
-            hair_->draw(interstance, Hair::Layer::SHADE, interframe, args);
-            face_->draw(interexpression, interexpframe, faceargs);
+
+            hair_->append(interstance, Hair::Layer::BELOW_BODY, interframe, list);
+            equips_.append(EquipSlot::Id::HAT,
+                           interstance,
+                           Clothing::Layer::CAP_BELOW_BODY,
+                           interframe,
+                           list);
+            body_->append(interstance, Body::Layer::BODY, interframe, list);
+            hair_->append(interstance, Hair::Layer::DEFAULT, interframe, list);
+            body_->append(Stance::Id::STAND1, Body::Layer::HEAD, 1, list);
+            hair_->append(interstance, Hair::Layer::SHADE, interframe, list);
+
+            hair_->append(interstance, Hair::Layer::DEFAULT, interframe, list);
+            body_->append(interstance, Body::Layer::HEAD, interframe, list);
+            hair_->append(interstance, Hair::Layer::SHADE, interframe, list);
+            face_->append(interexpression, interexpframe, list, faceshift);
 
             switch (equips_.getcaptype()) {
                 case CharEquips::CapType::NONE:
-                    hair_->draw(interstance,
-                                Hair::Layer::OVER_HEAD,
-                                interframe,
-                                args);
+                    hair_->append(interstance,
+                                  Hair::Layer::OVER_HEAD,
+                                  interframe,
+                                  list);
                     break;
                 case CharEquips::CapType::HEADBAND:
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 Stance::Id::STAND1,
-                                 Clothing::Layer::CAP,
-                                 1,
-                                 args);
-                    hair_->draw(Stance::Id::STAND1, Hair::Layer::DEFAULT, 1, args);
-                    hair_->draw(Stance::Id::STAND1,
-                                Hair::Layer::OVER_HEAD,
-                                1,
-                                args);
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 Stance::Id::STAND1,
-                                 Clothing::Layer::CAP_OVER_HAIR,
-                                 1,
-                                 args);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   Stance::Id::STAND1,
+                                   Clothing::Layer::CAP,
+                                   1,
+                                   list);
+                    hair_->append(Stance::Id::STAND1, Hair::Layer::DEFAULT, 1, list);
+                    hair_->append(Stance::Id::STAND1,
+                                  Hair::Layer::OVER_HEAD,
+                                  1,
+                                  list);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   Stance::Id::STAND1,
+                                   Clothing::Layer::CAP_OVER_HAIR,
+                                   1,
+                                   list);
                     break;
                 case CharEquips::CapType::HALF_COVER:
-                    hair_->draw(Stance::Id::STAND1, Hair::Layer::DEFAULT, 1, args);
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 Stance::Id::STAND1,
-                                 Clothing::Layer::CAP,
-                                 1,
-                                 args);
+                    hair_->append(Stance::Id::STAND1, Hair::Layer::DEFAULT, 1, list);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   Stance::Id::STAND1,
+                                   Clothing::Layer::CAP,
+                                   1,
+                                   list);
                     break;
                 case CharEquips::CapType::FULL_COVER:
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 Stance::Id::STAND1,
-                                 Clothing::Layer::CAP,
-                                 1,
-                                 args);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   Stance::Id::STAND1,
+                                   Clothing::Layer::CAP,
+                                   1,
+                                   list);
                     break;
             }
 
@@ -132,319 +131,399 @@ namespace ms {
         }
 
         if (Stance::is_climbing(interstance)) {
-            body_->draw(interstance, Body::Layer::BODY, interframe, args);
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::GLOVE,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::SHOES,
-                         interstance,
-                         Clothing::Layer::SHOES,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::BOTTOM_DEFAULT, interstance, Clothing::Layer::PANTS_DEFAULT,
-                         interframe, args);
-            equips_.draw(EquipSlot::Id::BOTTOM,
-                         interstance,
-                         Clothing::Layer::PANTS,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::TOP_DEFAULT, interstance, Clothing::Layer::TOP_DEFAULT, interframe, args);
-            equips_.draw(EquipSlot::Id::TOP,
-                         interstance,
-                         Clothing::Layer::TOP,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::TOP,
-                         interstance,
-                         Clothing::Layer::MAIL,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::CAPE,
-                         interstance,
-                         Clothing::Layer::CAPE,
-                         interframe,
-                         args);
-            body_->draw(interstance, Body::Layer::HEAD, interframe, args);
-            equips_.draw(EquipSlot::Id::EARACC,
-                         interstance,
-                         Clothing::Layer::EARRINGS,
-                         interframe,
-                         args);
+            body_->append(interstance, Body::Layer::BODY, interframe, list);
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::GLOVE,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::SHOES,
+                           interstance,
+                           Clothing::Layer::SHOES,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::BOTTOM_DEFAULT, interstance, Clothing::Layer::PANTS_DEFAULT,
+                           interframe, list);
+            equips_.append(EquipSlot::Id::BOTTOM,
+                           interstance,
+                           Clothing::Layer::PANTS,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::TOP_DEFAULT, interstance, Clothing::Layer::TOP_DEFAULT, interframe, list);
+            equips_.append(EquipSlot::Id::TOP,
+                           interstance,
+                           Clothing::Layer::TOP,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::TOP,
+                           interstance,
+                           Clothing::Layer::MAIL,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::CAPE,
+                           interstance,
+                           Clothing::Layer::CAPE,
+                           interframe,
+                           list);
+            body_->append(interstance, Body::Layer::HEAD, interframe, list);
+            equips_.append(EquipSlot::Id::EARACC,
+                           interstance,
+                           Clothing::Layer::EARRINGS,
+                           interframe,
+                           list);
 
             switch (equips_.getcaptype()) {
                 case CharEquips::CapType::NONE:
-                    hair_->draw(interstance, Hair::Layer::BACK, interframe, args);
+                    hair_->append(interstance, Hair::Layer::BACK, interframe, list);
                     break;
                 case CharEquips::CapType::HEADBAND:
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP,
-                                 interframe,
-                                 args);
-                    hair_->draw(interstance, Hair::Layer::BACK, interframe, args);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP,
+                                   interframe,
+                                   list);
+                    hair_->append(interstance, Hair::Layer::BACK, interframe, list);
                     break;
                 case CharEquips::CapType::HALF_COVER:
-                    hair_->draw(interstance,
-                                Hair::Layer::BELOW_CAP,
-                                interframe,
-                                args);
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP,
-                                 interframe,
-                                 args);
+                    hair_->append(interstance,
+                                  Hair::Layer::BELOW_CAP,
+                                  interframe,
+                                  list);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP,
+                                   interframe,
+                                   list);
                     break;
                 case CharEquips::CapType::FULL_COVER:
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP,
-                                 interframe,
-                                 args);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP,
+                                   interframe,
+                                   list);
                     break;
             }
 
-            equips_.draw(EquipSlot::Id::SHIELD,
-                         interstance,
-                         Clothing::Layer::BACK_SHIELD,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::WEAPON,
-                         interstance,
-                         Clothing::Layer::BACK_WEAPON,
-                         interframe,
-                         args);
+            equips_.append(EquipSlot::Id::SHIELD,
+                           interstance,
+                           Clothing::Layer::BACK_SHIELD,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::WEAPON,
+                           interstance,
+                           Clothing::Layer::BACK_WEAPON,
+                           interframe,
+                           list);
         } else {
-            hair_->draw(interstance, Hair::Layer::BELOW_BODY, interframe, args);
-            equips_.draw(EquipSlot::Id::CAPE,
-                         interstance,
-                         Clothing::Layer::CAPE,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::SHIELD,
-                         interstance,
-                         Clothing::Layer::SHIELD_BELOW_BODY,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::WEAPON,
-                         interstance,
-                         Clothing::Layer::WEAPON_BELOW_BODY,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::HAT,
-                         interstance,
-                         Clothing::Layer::CAP_BELOW_BODY,
-                         interframe,
-                         args);
-            body_->draw(interstance, Body::Layer::BODY, interframe, args);
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::WRIST_OVER_BODY,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::GLOVE_OVER_BODY,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::SHOES,
-                         interstance,
-                         Clothing::Layer::SHOES,
-                         interframe,
-                         args);
-            body_->draw(interstance, Body::Layer::ARM_BELOW_HEAD, interframe, args);
+            hair_->append(interstance, Hair::Layer::BELOW_BODY, interframe, list);
+            equips_.append(EquipSlot::Id::CAPE,
+                           interstance,
+                           Clothing::Layer::CAPE,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::SHIELD,
+                           interstance,
+                           Clothing::Layer::SHIELD_BELOW_BODY,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::WEAPON,
+                           interstance,
+                           Clothing::Layer::WEAPON_BELOW_BODY,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::HAT,
+                           interstance,
+                           Clothing::Layer::CAP_BELOW_BODY,
+                           interframe,
+                           list);
+            body_->append(interstance, Body::Layer::BODY, interframe, list);
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::WRIST_OVER_BODY,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::GLOVE_OVER_BODY,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::SHOES,
+                           interstance,
+                           Clothing::Layer::SHOES,
+                           interframe,
+                           list);
+            body_->append(interstance, Body::Layer::ARM_BELOW_HEAD, interframe, list);
 
             if (equips_.has_overall()) {
-                equips_.draw(EquipSlot::Id::TOP,
-                             interstance,
-                             Clothing::Layer::MAIL,
-                             interframe,
-                             args);
+                equips_.append(EquipSlot::Id::TOP,
+                               interstance,
+                               Clothing::Layer::MAIL,
+                               interframe,
+                               list);
             } else {
-                equips_.draw(EquipSlot::Id::BOTTOM_DEFAULT, interstance, Clothing::Layer::PANTS_DEFAULT, interframe, args);
-                equips_.draw(EquipSlot::Id::BOTTOM,
-                             interstance,
-                             Clothing::Layer::PANTS,
-                             interframe,
-                             args);
-                equips_.draw(EquipSlot::Id::TOP_DEFAULT, interstance, Clothing::Layer::TOP_DEFAULT, interframe, args);
-                equips_.draw(EquipSlot::Id::TOP,
-                             interstance,
-                             Clothing::Layer::TOP,
-                             interframe,
-                             args);
+                equips_.append(EquipSlot::Id::BOTTOM_DEFAULT, interstance, Clothing::Layer::PANTS_DEFAULT, interframe, list);
+                equips_.append(EquipSlot::Id::BOTTOM,
+                               interstance,
+                               Clothing::Layer::PANTS,
+                               interframe,
+                               list);
+                equips_.append(EquipSlot::Id::TOP_DEFAULT, interstance, Clothing::Layer::TOP_DEFAULT, interframe, list);
+                equips_.append(EquipSlot::Id::TOP,
+                               interstance,
+                               Clothing::Layer::TOP,
+                               interframe,
+                               list);
             }
 
-            body_->draw(interstance,
-                        Body::Layer::ARM_BELOW_HEAD_OVER_MAIL,
-                        interframe,
-                        args);
-            hair_->draw(interstance, Hair::Layer::DEFAULT, interframe, args);
-            equips_.draw(EquipSlot::Id::SHIELD,
-                         interstance,
-                         Clothing::Layer::SHIELD_OVER_HAIR,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::EARACC,
-                         interstance,
-                         Clothing::Layer::EARRINGS,
-                         interframe,
-                         args);
-            body_->draw(interstance, Body::Layer::HEAD, interframe, args);
-            hair_->draw(interstance, Hair::Layer::SHADE, interframe, args);
-            face_->draw(interexpression, interexpframe, faceargs);
-            equips_.draw(EquipSlot::Id::FACE,
-                         interstance,
-                         Clothing::Layer::FACE_ACC,
-                         0,
-                         faceargs);
-            equips_.draw(EquipSlot::Id::EYE_ACC,
-                         interstance,
-                         Clothing::Layer::EYE_ACC,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::SHIELD,
-                         interstance,
-                         Clothing::Layer::SHIELD,
-                         interframe,
-                         args);
+            body_->append(interstance,
+                          Body::Layer::ARM_BELOW_HEAD_OVER_MAIL,
+                          interframe,
+                          list);
+            hair_->append(interstance, Hair::Layer::DEFAULT, interframe, list);
+            equips_.append(EquipSlot::Id::SHIELD,
+                           interstance,
+                           Clothing::Layer::SHIELD_OVER_HAIR,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::EARACC,
+                           interstance,
+                           Clothing::Layer::EARRINGS,
+                           interframe,
+                           list);
+            body_->append(interstance, Body::Layer::HEAD, interframe, list);
+            hair_->append(interstance, Hair::Layer::SHADE, interframe, list);
+            face_->append(interexpression, interexpframe, list, faceshift);
+            equips_.append(EquipSlot::Id::FACE,
+                           interstance,
+                           Clothing::Layer::FACE_ACC,
+                           0,
+                           list, faceshift);
+            equips_.append(EquipSlot::Id::EYE_ACC,
+                           interstance,
+                           Clothing::Layer::EYE_ACC,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::SHIELD,
+                           interstance,
+                           Clothing::Layer::SHIELD,
+                           interframe,
+                           list);
 
             switch (equips_.getcaptype()) {
                 case CharEquips::CapType::NONE:
-                    hair_->draw(interstance,
-                                Hair::Layer::OVER_HEAD,
-                                interframe,
-                                args);
+                    hair_->append(interstance,
+                                  Hair::Layer::OVER_HEAD,
+                                  interframe,
+                                  list);
                     break;
                 case CharEquips::CapType::HEADBAND:
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP,
-                                 interframe,
-                                 args);
-                    hair_->draw(interstance,
-                                Hair::Layer::DEFAULT,
-                                interframe,
-                                args);
-                    hair_->draw(interstance,
-                                Hair::Layer::OVER_HEAD,
-                                interframe,
-                                args);
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP_OVER_HAIR,
-                                 interframe,
-                                 args);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP,
+                                   interframe,
+                                   list);
+                    hair_->append(interstance,
+                                  Hair::Layer::DEFAULT,
+                                  interframe,
+                                  list);
+                    hair_->append(interstance,
+                                  Hair::Layer::OVER_HEAD,
+                                  interframe,
+                                  list);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP_OVER_HAIR,
+                                   interframe,
+                                   list);
                     break;
                 case CharEquips::CapType::HALF_COVER:
-                    hair_->draw(interstance,
-                                Hair::Layer::DEFAULT,
-                                interframe,
-                                args);
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP,
-                                 interframe,
-                                 args);
+                    hair_->append(interstance,
+                                  Hair::Layer::DEFAULT,
+                                  interframe,
+                                  list);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP,
+                                   interframe,
+                                   list);
                     break;
                 case CharEquips::CapType::FULL_COVER:
-                    equips_.draw(EquipSlot::Id::HAT,
-                                 interstance,
-                                 Clothing::Layer::CAP,
-                                 interframe,
-                                 args);
+                    equips_.append(EquipSlot::Id::HAT,
+                                   interstance,
+                                   Clothing::Layer::CAP,
+                                   interframe,
+                                   list);
                     break;
             }
 
-            equips_.draw(EquipSlot::Id::WEAPON,
-                         interstance,
-                         Clothing::Layer::WEAPON_BELOW_ARM,
-                         interframe,
-                         args);
+            equips_.append(EquipSlot::Id::WEAPON,
+                           interstance,
+                           Clothing::Layer::WEAPON_BELOW_ARM,
+                           interframe,
+                           list);
             bool twohanded = is_twohanded(interstance);
 
             if (twohanded) {
-                equips_.draw(EquipSlot::Id::TOP,
-                             interstance,
-                             Clothing::Layer::MAILARM,
-                             interframe,
-                             args);
-                body_->draw(interstance, Body::Layer::ARM, interframe, args);
-                equips_.draw(EquipSlot::Id::WEAPON,
-                             interstance,
-                             Clothing::Layer::WEAPON,
-                             interframe,
-                             args);
+                equips_.append(EquipSlot::Id::TOP,
+                               interstance,
+                               Clothing::Layer::MAILARM,
+                               interframe,
+                               list);
+                body_->append(interstance, Body::Layer::ARM, interframe, list);
+                equips_.append(EquipSlot::Id::WEAPON,
+                               interstance,
+                               Clothing::Layer::WEAPON,
+                               interframe,
+                               list);
             } else {
-                equips_.draw(EquipSlot::Id::WEAPON,
-                             interstance,
-                             Clothing::Layer::WEAPON,
-                             interframe,
-                             args);
-                body_->draw(interstance, Body::Layer::ARM, interframe, args);
-                equips_.draw(EquipSlot::Id::TOP,
-                             interstance,
-                             Clothing::Layer::MAILARM,
-                             interframe,
-                             args);
+                equips_.append(EquipSlot::Id::WEAPON,
+                               interstance,
+                               Clothing::Layer::WEAPON,
+                               interframe,
+                               list);
+                body_->append(interstance, Body::Layer::ARM, interframe, list);
+                equips_.append(EquipSlot::Id::TOP,
+                               interstance,
+                               Clothing::Layer::MAILARM,
+                               interframe,
+                               list);
             }
 
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::WRIST,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::GLOVE,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::WEAPON,
-                         interstance,
-                         Clothing::Layer::WEAPON_OVER_GLOVE,
-                         interframe,
-                         args);
-
-            body_->draw(interstance,
-                        Body::Layer::HAND_BELOW_WEAPON,
-                        interframe,
-                        args);
-
-            body_->draw(interstance, Body::Layer::ARM_OVER_HAIR, interframe, args);
-            body_->draw(interstance,
-                        Body::Layer::ARM_OVER_HAIR_BELOW_WEAPON,
-                        interframe,
-                        args);
-            equips_.draw(EquipSlot::Id::WEAPON,
-                         interstance,
-                         Clothing::Layer::WEAPON_OVER_HAND,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::WEAPON,
-                         interstance,
-                         Clothing::Layer::WEAPON_OVER_BODY,
-                         interframe,
-                         args);
-            body_->draw(interstance, Body::Layer::HAND_OVER_HAIR, interframe, args);
-            body_->draw(interstance,
-                        Body::Layer::HAND_OVER_WEAPON,
-                        interframe,
-                        args);
-
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::WRIST_OVER_HAIR,
-                         interframe,
-                         args);
-            equips_.draw(EquipSlot::Id::GLOVES,
-                         interstance,
-                         Clothing::Layer::GLOVE_OVER_HAIR,
-                         interframe,
-                         args);
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::WRIST,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::GLOVE,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::WEAPON,
+                           interstance,
+                           Clothing::Layer::WEAPON_OVER_GLOVE,
+                           interframe,
+                           list);
+
+            body_->append(interstance,
+                          Body::Layer::HAND_BELOW_WEAPON,
+                          interframe,
+                          list);
+
+            body_->append(interstance, Body::Layer::ARM_OVER_HAIR, interframe, list);
+            body_->append(interstance,
+                          Body::Layer::ARM_OVER_HAIR_BELOW_WEAPON,
+                          interframe,
+                          list);
+            equips_.append(EquipSlot::Id::WEAPON,
+                           interstance,
+                           Clothing::Layer::WEAPON_OVER_HAND,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::WEAPON,
+                           interstance,
+                           Clothing::Layer::WEAPON_OVER_BODY,
+                           interframe,
+                           list);
+            body_->append(interstance, Body::Layer::HAND_OVER_HAIR, interframe, list);
+            body_->append(interstance,
+                          Body::Layer::HAND_OVER_WEAPON,
+                          interframe,
+                          list);
+
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::WRIST_OVER_HAIR,
+                           interframe,
+                           list);
+            equips_.append(EquipSlot::Id::GLOVES,
+                           interstance,
+                           Clothing::Layer::GLOVE_OVER_HAIR,
+                           interframe,
+                           list);
+        }
+    }
+
+    void CharLook::draw(const DrawArgument &args,
+                        Stance::Id interstance,
+                        Expression::Id interexpression,
+                        uint8_t interframe,
+                        uint8_t interexpframe) const {
+        uint64_t key = get_draw_key(interstance,
+                                    interexpression,
+                                    interframe,
+                                    interexpframe);
+        const DrawList &list = get_draw_list(key,
+                                             interstance,
+                                             interexpression,
+                                             interframe,
+                                             interexpframe);
+
+        ImpostorCache &impostors = ImpostorCache::get();
+
+        if (!impostors.is_enabled() || !impostors.draw(key, list, args)) {
+            list.draw(args);
         }
     }
 
+    uint64_t CharLook::get_draw_key(Stance::Id interstance,
+                                    Expression::Id interexpression,
+                                    uint8_t interframe,
+                                    uint8_t interexpframe) const {
+        return static_cast<uint64_t>(get_look_id()) << 32
+               | static_cast<uint64_t>(interstance) << 24
+               | static_cast<uint64_t>(interexpression) << 16
+               | static_cast<uint64_t>(interframe) << 8
+               | interexpframe;
+    }
+
+    const DrawList &CharLook::get_draw_list(uint64_t key,
+                                            Stance::Id interstance,
+                                            Expression::Id interexpression,
+                                            uint8_t interframe,
+                                            uint8_t interexpframe) const {
+        auto iter = draw_lists_.find(key);
+
+        if (iter != draw_lists_.end()) {
+            draw_hits_++;
+            return iter->second;
+        }
+
+        // Rebuilding all lists is cheaper than tracking which are in use
+        if (draw_lists_.size() >= MAX_DRAW_LISTS) {
+            clear_draw_cache();
+        }
+
+        draw_misses_++;
+
+        DrawList &list = draw_lists_[key];
+        build(list, interstance, interexpression, interframe, interexpframe);
+
+        return list;
+    }
+
+    uint32_t CharLook::get_look_id() const {
+        if (look_id_ == 0 || look_id_generation_ != look_ids_generation_) {
+            std::vector<const void *> parts = { body_, hair_, face_ };
+
+            for (size_t i = 0; i < EquipSlot::Id::LENGTH; i++) {
+                auto slot = static_cast<EquipSlot::Id>(i);
+                parts.push_back(equips_.get_cloth(slot));
+            }
+
+            auto inserted = look_ids_.emplace(std::move(parts), next_look_id_);
+
+            if (inserted.second) {
+                next_look_id_++;
+            }
+
+            look_id_ = inserted.first->second;
+            look_id_generation_ = look_ids_generation_;
+        }
+
+        return look_id_;
+    }
+
     void CharLook::draw(const DrawArgument &args, float alpha) const {
         if (!body_ || !hair_ || !face_) {
             return;
@@ -589,6 +668,7 @@ namespace ms {
         }
 
         body_ = &iter->second;
+        look_id_ = 0;
     }
 
     void CharLook::set_hair(int32_t hair_id) {
@@ -603,6 +683,7 @@ namespace ms {
         }
 
         hair_ = &iter->second;
+        look_id_ = 0;
     }
 
     void CharLook::set_face(int32_t face_id) {
@@ -613,6 +694,7 @@ namespace ms {
         }
 
         face_ = &iter->second;
+        look_id_ = 0;
     }
 
     void CharLook::updatetwohanded() {
@@ -622,11 +704,13 @@ namespace ms {
 
     void CharLook::add_equip(int32_t itemid) {
         equips_.add_equip(itemid, draw_info_);
+        look_id_ = 0;
         updatetwohanded();
     }
 
     void CharLook::remove_equip(EquipSlot::Id slot) {
         equips_.remove_equip(slot);
+        look_id_ = 0;
 
         if (slot == EquipSlot::Id::WEAPON) {
             updatetwohanded();
@@ -855,8 +939,24 @@ namespace ms {
         draw_info_.init();
     }
 
+    CharLook::DrawCacheStats CharLook::get_draw_cache_stats() {
+        return { draw_hits_, draw_misses_, draw_lists_.size() };
+    }
+
+    void CharLook::clear_draw_cache() {
+        draw_lists_.clear();
+        look_ids_.clear();
+        look_ids_generation_++;
+    }
+
     BodyDrawInfo CharLook::draw_info_;
     std::unordered_map<int32_t, Hair> CharLook::hair_styles_;
     std::unordered_map<int32_t, Face> CharLook::face_types_;
     std::unordered_map<int32_t, Body> CharLook::body_types_;
+    std::map<std::vector<const void *>, uint32_t> CharLook::look_ids_;
+    uint32_t CharLook::next_look_id_ = 1;
+    uint32_t CharLook::look_ids_generation_ = 0;
+    std::unordered_map<uint64_t, DrawList> CharLook::draw_lists_;
+    uint64_t CharLook::draw_hits_ = 0;
+    uint64_t CharLook::draw_misses_ = 0;
 }  // namespace ms
\ No newline at end of file
@@ -15,18 +15,29 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include <map>
+#include <vector>
+
 #include "../../Net/Login.h"
 #include "../../Template/Interpolated.h"
 #include "../../Util/Randomizer.h"
 #include "../../Util/TimedBool.h"
 #include "Body.h"
 #include "CharEquips.h"
+#include "DrawList.h"
 #include "Face.h"
 #include "Hair.h"
 
 namespace ms {
 class CharLook {
 public:
+    // Counters for profiling the cache of draw lists
+    struct DrawCacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t lists;
+    };
+
     CharLook(const LookEntry &entry);
 
     CharLook();
@@ -86,6 +97,13 @@ public:
     // Initialize drawinfo
     static void init();
 
+    static DrawCacheStats get_draw_cache_stats();
+
+    // Drop all draw lists and look ids, they are rebuilt when next drawn.
+    // Ids are never handed out twice, so keys made from an old id cannot
+    // match another look.
+    static void clear_draw_cache();
+
 private:
     void updatetwohanded();
 
@@ -95,6 +113,31 @@ private:
               uint8_t interframe,
               uint8_t interfcframe) const;
 
+    // Add the textures of a frame to a list in the order they are drawn.
+    void build(DrawList &list,
+               Stance::Id interstance,
+               Expression::Id interexp,
+               uint8_t interframe,
+               uint8_t interfcframe) const;
+
+    // Return a key which identifies a frame of the look.
+    uint64_t get_draw_key(Stance::Id interstance,
+                          Expression::Id interexp,
+                          uint8_t interframe,
+                          uint8_t interfcframe) const;
+
+    // Return the textures of a frame, shared by all characters which look
+    // the same.
+    const DrawList &get_draw_list(uint64_t key,
+                                  Stance::Id interstance,
+                                  Expression::Id interexp,
+                                  uint8_t interframe,
+                                  uint8_t interfcframe) const;
+
+    // Return an id which is equal for characters with the same body, hair,
+    // face and equips.
+    uint32_t get_look_id() const;
+
     uint16_t get_delay(Stance::Id stance, uint8_t frame) const;
 
     uint8_t getnextframe(Stance::Id stance, uint8_t frame) const;
@@ -120,6 +163,11 @@ private:
     const Face *face_;
     CharEquips equips_;
 
+    // 0 until needed, reset whenever the look changes. Only valid while its
+    // generation matches that of the look ids.
+    mutable uint32_t look_id_;
+    mutable uint32_t look_id_generation_;
+
     Randomizer randomizer_;
     TimedBool alerted_;
 
@@ -127,5 +175,15 @@ private:
     static std::unordered_map<int32_t, Hair> hair_styles_;
     static std::unordered_map<int32_t, Face> face_types_;
     static std::unordered_map<int32_t, Body> body_types_;
+
+    // Draw lists kept before they are all rebuilt
+    static constexpr size_t MAX_DRAW_LISTS = 8192;
+
+    static std::map<std::vector<const void *>, uint32_t> look_ids_;
+    static uint32_t next_look_id_;
+    static uint32_t look_ids_generation_;
+    static std::unordered_map<uint64_t, DrawList> draw_lists_;
+    static uint64_t draw_hits_;
+    static uint64_t draw_misses_;
 };
 }  // namespace ms
\ No newline at end of file
@@ -181,14 +181,15 @@ Clothing::Clothing(int32_t id, const BodyDrawInfo &drawinfo) : item_id_(id) {
     transparent_ = transparents.count(item_id_) > 0;
 }
 
-void Clothing::draw(Stance::Id stance,
-                    Layer layer,
-                    uint8_t frame,
-                    const DrawArgument &args) const {
+void Clothing::append(Stance::Id stance,
+                      Layer layer,
+                      uint8_t frame,
+                      DrawList &list,
+                      Point<int16_t> shift) const {
     auto range = stances_[stance][layer].equal_range(frame);
 
     for (auto iter = range.first; iter != range.second; ++iter) {
-        iter->second.draw(args);
+        list.add(iter->second, shift);
     }
 }
 
@@ -17,6 +17,7 @@
 
 #include "../../Graphics/Texture.h"
 #include "BodyDrawInfo.h"
+#include "DrawList.h"
 #include "EquipSlot.h"
 
 namespace ms {
@@ -67,11 +68,12 @@ public:
     // Construct a new equip.
     Clothing(int32_t itemid, const BodyDrawInfo &drawinfo);
 
-    // Draw the equip.
-    void draw(Stance::Id stance,
-              Layer layer,
-              uint8_t frame,
-              const DrawArgument &args) const;
+    // Add the textures of a layer of the equip to a draw list.
+    void append(Stance::Id stance,
+                Layer layer,
+                uint8_t frame,
+                DrawList &list,
+                Point<int16_t> shift) const;
 
     // Check if a part of the equip lies on the specified layer while in the
     // specified stance.
@@ -0,0 +1,45 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "DrawList.h"
+
+namespace ms {
+void DrawList::add(const Texture &texture, Point<int16_t> shift) {
+    parts_.push_back({ &texture, shift });
+}
+
+void DrawList::draw(const DrawArgument &args) const {
+    for (const Part &part : parts_) {
+        if (part.shift == Point<int16_t>()) {
+            part.texture->draw(args);
+        } else {
+            part.texture->draw(
+                args + DrawArgument { part.shift, false, Point<int16_t> {} });
+        }
+    }
+}
+
+void DrawList::clear() {
+    parts_.clear();
+}
+
+size_t DrawList::size() const {
+    return parts_.size();
+}
+
+const std::vector<DrawList::Part> &DrawList::get_parts() const {
+    return parts_;
+}
+}  // namespace ms
\ No newline at end of file
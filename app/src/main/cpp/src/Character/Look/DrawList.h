@@ -0,0 +1,46 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <vector>
+
+#include "../../Graphics/Texture.h"
+
+namespace ms {
+// The textures of one frame of a character in the order they are drawn
+// Each texture has an offset from the character's position, used for the
+// parts which follow the face.
+class DrawList {
+public:
+    struct Part {
+        const Texture *texture;
+        Point<int16_t> shift;
+    };
+
+    void add(const Texture &texture, Point<int16_t> shift = {});
+
+    void draw(const DrawArgument &args) const;
+
+    void clear();
+
+    size_t size() const;
+
+    const std::vector<Part> &get_parts() const;
+
+private:
+    std::vector<Part> parts_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -64,13 +64,14 @@ Face::Face(int32_t faceid) {
                                       [std::to_string(faceid)]["name"]);
 }
 
-void Face::draw(Expression::Id expression,
-                uint8_t frame,
-                const DrawArgument &args) const {
+void Face::append(Expression::Id expression,
+                  uint8_t frame,
+                  DrawList &list,
+                  Point<int16_t> shift) const {
     auto frameit = expressions_[expression].find(frame);
 
     if (frameit != expressions_[expression].end()) {
-        frameit->second.texture.draw(args);
+        list.add(frameit->second.texture, shift);
     }
 }
 
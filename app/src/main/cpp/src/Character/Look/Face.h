@@ -19,6 +19,7 @@
 
 #include "../../Graphics/Texture.h"
 #include "BodyDrawInfo.h"
+#include "DrawList.h"
 
 namespace ms {
 class Expression {
@@ -60,9 +61,11 @@ class Face {
 public:
     Face(int32_t faceid);
 
-    void draw(Expression::Id expression,
-              uint8_t frame,
-              const DrawArgument &args) const;
+    // Add the texture of an expression to a draw list.
+    void append(Expression::Id expression,
+                uint8_t frame,
+                DrawList &list,
+                Point<int16_t> shift) const;
 
     uint8_t nextframe(Expression::Id expression, uint8_t frame) const;
 
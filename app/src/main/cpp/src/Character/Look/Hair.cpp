@@ -70,17 +70,17 @@ Hair::Hair(int32_t hairid, const BodyDrawInfo &drawinfo) {
     color_ = (index < haircolors.size()) ? haircolors[index] : "";
 }
 
-void Hair::draw(Stance::Id stance,
-                Layer layer,
-                uint8_t frame,
-                const DrawArgument &args) const {
+void Hair::append(Stance::Id stance,
+                  Layer layer,
+                  uint8_t frame,
+                  DrawList &list) const {
     auto frameit = stances_[stance][layer].find(frame);
 
     if (frameit == stances_[stance][layer].end()) {
         return;
     }
 
-    frameit->second.draw(args);
+    list.add(frameit->second);
 }
 
 const std::string &Hair::get_name() const {
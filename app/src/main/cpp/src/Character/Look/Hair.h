@@ -19,6 +19,7 @@
 
 #include "../../Graphics/Texture.h"
 #include "BodyDrawInfo.h"
+#include "DrawList.h"
 
 namespace ms {
 class Hair {
@@ -36,10 +37,11 @@ public:
 
     Hair(int32_t hairid, const BodyDrawInfo &drawinfo);
 
-    void draw(Stance::Id stance,
-              Layer layer,
-              uint8_t frame,
-              const DrawArgument &args) const;
+    // Add the texture of a layer to a draw list.
+    void append(Stance::Id stance,
+                Layer layer,
+                uint8_t frame,
+                DrawList &list) const;
 
     const std::string &get_name() const;
 
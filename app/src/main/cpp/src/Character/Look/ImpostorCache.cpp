@@ -0,0 +1,289 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "ImpostorCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../../Configuration.h"
+#include "../../Graphics/GraphicsGL.h"
+
+namespace ms {
+ImpostorCache::ImpostorCache() :
+    threshold_(Setting<ImpostorThreshold>::get().load()),
+    active_(false),
+    enabled_(false),
+    budget_(0),
+    next_id_(1),
+    hits_(0),
+    misses_(0),
+    evictions_(0),
+    fallbacks_(0),
+    quads_saved_(0) {}
+
+void ImpostorCache::update(size_t characters) {
+    active_ = threshold_ > 0 && characters >= threshold_;
+    budget_ = COMPOSE_BUDGET;
+}
+
+void ImpostorCache::set_enabled(bool enabled) {
+    enabled_ = enabled && active_;
+}
+
+bool ImpostorCache::is_enabled() const {
+    return enabled_;
+}
+
+bool ImpostorCache::draw(uint64_t key,
+                         const DrawList &list,
+                         const DrawArgument &args) {
+    // One image would not look the same when rotated, scaled or translucent
+    if (args.get_angle() != 0.0f || args.get_yscale() != 1.0f
+        || std::abs(args.get_xscale()) != 1.0f
+        || args.get_stretch() != Point<int16_t>()
+        || args.get_color().a() < 1.0f) {
+        fallbacks_++;
+        return false;
+    }
+
+    GraphicsGL &graphics = GraphicsGL::get();
+    auto iter = images_.find(key);
+
+    if (iter != images_.end()) {
+        Image &image = iter->second;
+        recent_.splice(recent_.end(), recent_, image.position);
+
+        if (image.failed) {
+            fallbacks_++;
+            return false;
+        }
+
+        // Fails if the atlas page of the image has been recycled
+        if (image.id
+            && graphics.draw_image(image.id,
+                                   args.get_rectangle(image.origin,
+                                                      image.dimensions),
+                                   args.get_color(),
+                                   0.0f)) {
+            hits_++;
+            quads_saved_ += list.size() - 1;
+            return true;
+        }
+    }
+
+    if (budget_ == 0) {
+        fallbacks_++;
+        return false;
+    }
+
+    budget_--;
+    misses_++;
+
+    if (iter == images_.end()) {
+        if (images_.size() >= MAX_IMAGES) {
+            evict();
+        }
+
+        recent_.push_back(key);
+        iter = images_
+                   .emplace(key, Image { 0, false, {}, {}, --recent_.end() })
+                   .first;
+    }
+
+    Image &image = iter->second;
+    create(list, image);
+
+    if (image.failed
+        || !graphics.draw_image(image.id,
+                                args.get_rectangle(image.origin,
+                                                   image.dimensions),
+                                args.get_color(),
+                                0.0f)) {
+        fallbacks_++;
+        return false;
+    }
+
+    quads_saved_ += list.size() - 1;
+
+    return true;
+}
+
+void ImpostorCache::clear() {
+    GraphicsGL &graphics = GraphicsGL::get();
+
+    for (const auto &entry : images_) {
+        graphics.remove_image(entry.second.id);
+    }
+
+    images_.clear();
+    recent_.clear();
+}
+
+ImpostorCache::Stats ImpostorCache::get_stats() const {
+    return { hits_,      misses_,      evictions_,
+             fallbacks_, quads_saved_, images_.size() };
+}
+
+void ImpostorCache::compose(const std::vector<Layer> &layers,
+                            int16_t width,
+                            int16_t height,
+                            std::vector<uint8_t> &out) {
+    size_t count = static_cast<size_t>(width) * height;
+
+    // Blend with premultiplied colors, then divide by the alpha again
+    std::vector<float> sum(count * 4, 0.0f);
+
+    for (const Layer &layer : layers) {
+        int16_t left = std::max<int16_t>(layer.x, 0);
+        int16_t right = std::min<int16_t>(layer.x + layer.width, width);
+        int16_t top = std::max<int16_t>(layer.y, 0);
+        int16_t bottom = std::min<int16_t>(layer.y + layer.height, height);
+
+        for (int16_t y = top; y < bottom; y++) {
+            const uint8_t *src =
+                layer.pixels
+                + ((y - layer.y) * layer.width + (left - layer.x)) * 4;
+            float *dst = sum.data() + (y * width + left) * 4;
+
+            for (int16_t x = left; x < right; x++, src += 4, dst += 4) {
+                float alpha = src[3] / 255.0f;
+
+                if (alpha == 0.0f) {
+                    continue;
+                }
+
+                float keep = 1.0f - alpha;
+                dst[0] = src[0] * alpha + dst[0] * keep;
+                dst[1] = src[1] * alpha + dst[1] * keep;
+                dst[2] = src[2] * alpha + dst[2] * keep;
+                dst[3] = alpha + dst[3] * keep;
+            }
+        }
+    }
+
+    out.resize(count * 4);
+
+    for (size_t i = 0; i < count; i++) {
+        const float *src = sum.data() + i * 4;
+        uint8_t *dst = out.data() + i * 4;
+        float alpha = src[3];
+
+        if (alpha <= 0.0f) {
+            std::fill(dst, dst + 4, 0);
+            continue;
+        }
+
+        for (size_t c = 0; c < 3; c++) {
+            float value = std::min(src[c] / alpha, 255.0f);
+            dst[c] = static_cast<uint8_t>(value + 0.5f);
+        }
+
+        dst[3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+    }
+}
+
+void ImpostorCache::create(const DrawList &list, Image &image) {
+    image.id = 0;
+    image.failed = true;
+
+    const auto &parts = list.get_parts();
+
+    // Parts are placed the way Texture::draw places them, relative to the
+    // position of the character
+    int32_t left = std::numeric_limits<int16_t>::max();
+    int32_t top = std::numeric_limits<int16_t>::max();
+    int32_t right = std::numeric_limits<int16_t>::min();
+    int32_t bottom = std::numeric_limits<int16_t>::min();
+
+    for (const DrawList::Part &part : parts) {
+        if (!part.texture->is_valid()) {
+            continue;
+        }
+
+        Point<int16_t> corner = part.shift - part.texture->get_origin();
+        Point<int16_t> dimensions = part.texture->get_dimensions();
+
+        left = std::min<int32_t>(left, corner.x());
+        top = std::min<int32_t>(top, corner.y());
+        right = std::max<int32_t>(right, corner.x() + dimensions.x());
+        bottom = std::max<int32_t>(bottom, corner.y() + dimensions.y());
+    }
+
+    if (left >= right || top >= bottom || right - left > MAX_SIZE
+        || bottom - top > MAX_SIZE) {
+        return;
+    }
+
+    std::vector<Layer> layers;
+    decoded_.resize(std::max(decoded_.size(), parts.size()));
+
+    for (size_t i = 0; i < parts.size(); i++) {
+        const Texture &texture = *parts[i].texture;
+
+        if (!texture.is_valid()) {
+            continue;
+        }
+
+        const nl::bitmap &bitmap = texture.get_bitmap();
+        std::vector<uint8_t> &pixels = decoded_[i];
+
+        // The decoder may write a little past the end
+        pixels.resize(bitmap.length() + 0x20);
+
+        if (!bitmap.decode(pixels.data())) {
+            return;
+        }
+
+        Point<int16_t> corner = parts[i].shift - texture.get_origin();
+
+        layers.push_back({ pixels.data(),
+                           texture.width(),
+                           texture.height(),
+                           static_cast<int16_t>(corner.x() - left),
+                           static_cast<int16_t>(corner.y() - top) });
+    }
+
+    auto width = static_cast<int16_t>(right - left);
+    auto height = static_cast<int16_t>(bottom - top);
+
+    compose(layers, width, height, pixels_);
+
+    uint64_t id = next_id_++;
+
+    if (!GraphicsGL::get().add_image(id, width, height, pixels_.data())) {
+        return;
+    }
+
+    image.id = id;
+    image.failed = false;
+    image.origin = Point<int16_t>(-left, -top);
+    image.dimensions = Point<int16_t>(width, height);
+}
+
+void ImpostorCache::evict() {
+    uint64_t key = recent_.front();
+    recent_.pop_front();
+
+    auto iter = images_.find(key);
+
+    if (iter != images_.end()) {
+        GraphicsGL::get().remove_image(iter->second.id);
+        images_.erase(iter);
+        evictions_++;
+    }
+}
+}  // namespace ms
\ No newline at end of file
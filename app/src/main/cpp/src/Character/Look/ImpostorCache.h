@@ -0,0 +1,123 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Template/Singleton.h"
+#include "DrawList.h"
+
+namespace ms {
+// Draws the characters of other players as one image per frame
+// Each frame of a look is composed on the CPU from the bitmaps of its parts
+// and uploaded to the atlas once, so that it takes one quad instead of one
+// per part. Used on crowded maps, where the overlapping parts cost too much
+// fill rate. The least recently drawn images are dropped first.
+class ImpostorCache : public Singleton<ImpostorCache> {
+public:
+    // Counters for profiling the cache
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        // Draws which used the parts because no image could be used
+        uint64_t fallbacks;
+        // Quads which were not drawn because an image was drawn instead
+        uint64_t quads_saved;
+        size_t images;
+    };
+
+    // Straight alpha RGBA pixels of one part of an image
+    struct Layer {
+        const uint8_t *pixels;
+        int16_t width;
+        int16_t height;
+        // Position of the top left corner within the image
+        int16_t x;
+        int16_t y;
+    };
+
+    ImpostorCache();
+
+    // Decide whether images are used for the number of characters on the
+    // map and allow composing more images. Called once per update.
+    void update(size_t characters);
+
+    // Allow drawing with images, only while other players are drawn.
+    void set_enabled(bool enabled);
+
+    bool is_enabled() const;
+
+    // Draw a frame of a character as one image, composing it if needed.
+    // Returns false if the parts have to be drawn instead.
+    bool draw(uint64_t key, const DrawList &list, const DrawArgument &args);
+
+    // Drop all images.
+    void clear();
+
+    Stats get_stats() const;
+
+    // Blend layers over each other in order into an image of the given size.
+    static void compose(const std::vector<Layer> &layers,
+                        int16_t width,
+                        int16_t height,
+                        std::vector<uint8_t> &out);
+
+private:
+    struct Image {
+        // 0 until the image is uploaded
+        uint64_t id;
+        // Set if the frame can not be drawn as an image
+        bool failed;
+        Point<int16_t> origin;
+        Point<int16_t> dimensions;
+        std::list<uint64_t>::iterator position;
+    };
+
+    // Compose the parts of a frame and upload the result to the atlas.
+    void create(const DrawList &list, Image &image);
+
+    // Drop the least recently drawn image.
+    void evict();
+
+    // Images kept before the least recently drawn are dropped
+    static constexpr size_t MAX_IMAGES = 512;
+    // Images composed per update, the rest are drawn by parts until later
+    static constexpr uint8_t COMPOSE_BUDGET = 2;
+    // Largest width or height of an image
+    static constexpr int16_t MAX_SIZE = 512;
+
+    std::unordered_map<uint64_t, Image> images_;
+    std::list<uint64_t> recent_;
+    std::vector<std::vector<uint8_t>> decoded_;
+    std::vector<uint8_t> pixels_;
+
+    uint16_t threshold_;
+    bool active_;
+    bool enabled_;
+    uint8_t budget_;
+    uint64_t next_id_;
+
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
+    uint64_t fallbacks_;
+    uint64_t quads_saved_;
+};
+}  // namespace ms
\ No newline at end of file
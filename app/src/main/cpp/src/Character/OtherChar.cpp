@@ -30,34 +30,22 @@ OtherChar::OtherChar(int32_t id,
     job_ = jb;
     set_position(pos);
 
-    last_move_.xpos = pos.x();
-    last_move_.ypos = pos.y();
-    last_move_.newstate = st;
-    timer_ = 0;
+    playback_.reset(pos, st);
 
     attack_speed_ = 6;
     attacking_ = false;
 }
 
 int8_t OtherChar::update(const Physics &physics) {
-    if (timer_ > 1) {
-        timer_--;
-    } else if (timer_ == 1) {
-        if (!movements_.empty()) {
-            last_move_ = movements_.front();
-            movements_.pop();
-        } else {
-            timer_ = 0;
-        }
-    }
+    playback_.update();
 
     if (!attacking_) {
-        uint8_t laststate = last_move_.newstate;
+        uint8_t laststate = playback_.get_state();
         set_state(laststate);
     }
 
-    phobj_.hspeed = last_move_.xpos - phobj_.crnt_x();
-    phobj_.vspeed = last_move_.ypos - phobj_.crnt_y();
+    phobj_.hspeed = playback_.get_x() - phobj_.crnt_x();
+    phobj_.vspeed = playback_.get_y() - phobj_.crnt_y();
     phobj_.move();
 
     physics.get_fht().update_fh(phobj_);
@@ -72,12 +60,7 @@ int8_t OtherChar::update(const Physics &physics) {
 }
 
 void OtherChar::send_movement(const std::vector<Movement> &newmoves) {
-    movements_.push(newmoves.back());
-
-    if (timer_ == 0) {
-        constexpr uint16_t DELAY = 50;
-        timer_ = DELAY;
-    }
+    playback_.push(newmoves);
 }
 
 void OtherChar::update_skill(int32_t skillid, uint8_t skilllevel) {
@@ -91,10 +74,14 @@ void OtherChar::update_speed(uint8_t as) {
 void OtherChar::update_look(const LookEntry &newlook) {
     look_ = newlook;
 
-    uint8_t laststate = last_move_.newstate;
+    uint8_t laststate = playback_.get_state();
     set_state(laststate);
 }
 
+const MovementPlayback::Stats &OtherChar::get_playback_stats() const {
+    return playback_.get_stats();
+}
+
 int8_t OtherChar::get_integer_attackspeed() const {
     return attack_speed_;
 }
@@ -15,10 +15,9 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
-#include <queue>
 #include <vector>
 
-#include "../Gameplay/Movement.h"
+#include "../Gameplay/MovementPlayback.h"
 #include "Char.h"
 #include "Look/CharLook.h"
 
@@ -49,6 +48,9 @@ public:
     // Update the character look.
     void update_look(const LookEntry &look);
 
+    // Return the metrics of the movement playback.
+    const MovementPlayback::Stats &get_playback_stats() const;
+
     // Return the character's attacking speed.
     int8_t get_integer_attackspeed() const override;
 
@@ -61,9 +63,7 @@ public:
 private:
     uint16_t level_;
     int16_t job_;
-    std::queue<Movement> movements_;
-    Movement last_move_;
-    uint16_t timer_;
+    MovementPlayback playback_;
 
     std::unordered_map<int32_t, uint8_t> skill_levels_;
     uint8_t attack_speed_;
@@ -24,10 +24,6 @@
 
 namespace ms {
 namespace {
-auto fn_move_player = [](auto&&... args) {
-    MovePlayerPacket(std::forward<decltype(args)>(args)...).dispatch();
-};
-
 auto fn_use_item = [](auto&&... args) {
     UseItemPacket(std::forward<decltype(args)>(args)...).dispatch();
 };
@@ -78,9 +74,18 @@ void Player::respawn(Point<int16_t> pos, bool uw) {
     keys_down_.clear();
     attacking_ = false;
     ladder_ = {};
+    movement_.clear();
     nullstate.update_state(*this);
 }
 
+void Player::flush_movement() {
+    movement_.flush();
+}
+
+const MovementRecorder::Stats &Player::get_movement_stats() const {
+    return movement_.get_stats();
+}
+
 void Player::send_action(KeyAction::Id action, bool down) {
     const PlayerState *pst = get_state(state_);
 
@@ -169,13 +174,7 @@ int8_t Player::update(const Physics &physics) {
     }
 
     uint8_t stancebyte = facing_right_ ? state_ : state_ + 1;
-    Movement newmove(phobj_, stancebyte);
-    bool needupdate = last_move_.hasmoved(newmove);
-
-    if (needupdate) {
-        fn_move_player(newmove);
-        last_move_ = newmove;
-    }
+    movement_.record(Movement(phobj_, stancebyte));
 
     return get_layer();
 }
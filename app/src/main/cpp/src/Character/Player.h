@@ -18,6 +18,7 @@
 #include "../Gameplay/Combat/Skill.h"
 #include "../Gameplay/MapleMap/Layer.h"
 #include "../Gameplay/MapleMap/MapInfo.h"
+#include "../Gameplay/MovementRecorder.h"
 #include "../Gameplay/Physics/Physics.h"
 #include "../Gameplay/Playable.h"
 #include "ActiveBuffs.h"
@@ -52,6 +53,12 @@ public:
     // Respawn the player at the given position
     void respawn(Point<int16_t> position, bool underwater);
 
+    // Send the movement collected so far to the server.
+    void flush_movement();
+
+    // Return the counters of movement packets sent to the server.
+    const MovementRecorder::Stats &get_movement_stats() const;
+
     // Sends a Keyaction to the player's state, to apply forces, change the
     // state and other behaviour.
     void send_action(KeyAction::Id action, bool pressed) override;
@@ -201,7 +208,7 @@ private:
 
     std::map<KeyAction::Id, bool> keys_down_;
 
-    Movement last_move_;
+    MovementRecorder movement_;
 
     Randomizer randomizer_;
 
@@ -22,14 +22,21 @@ namespace ms {
 Configuration::Configuration() {
     settings.emplace<ServerIP>();
     settings.emplace<ServerPort>();
+    settings.emplace<NetworkThread>();
+    settings.emplace<MovementInterval>();
+    settings.emplace<BatchedPhysics>();
     settings.emplace<Fullscreen>();
     settings.emplace<Width>();
     settings.emplace<Height>();
     settings.emplace<VSync>();
+    settings.emplace<ImpostorThreshold>();
     settings.emplace<FontPathNormal>();
     settings.emplace<FontPathBold>();
     settings.emplace<BGMVolume>();
     settings.emplace<SFXVolume>();
+    settings.emplace<AudioOutput>();
+    settings.emplace<SoundCacheSize>();
+    settings.emplace<SoundPrefetch>();
     settings.emplace<SaveLogin>();
     settings.emplace<DefaultAccount>();
     settings.emplace<DefaultWorld>();
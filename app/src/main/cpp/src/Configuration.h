@@ -281,6 +281,22 @@ struct ServerPort : public Configuration::StringEntry {
     ServerPort() : StringEntry("ServerPort", "8484") {}
 };
 
+// Whether to move socket reads and writes to a background thread
+struct NetworkThread : public Configuration::BoolEntry {
+    NetworkThread() : BoolEntry("NetworkThread", "false") {}
+};
+
+// Milliseconds for which player movement is collected before it is sent
+// 0 sends every change immediately, the maximum is 1000
+struct MovementInterval : public Configuration::ShortEntry {
+    MovementInterval() : ShortEntry("MovementInterval", "100") {}
+};
+
+// Whether mobs and drops are moved together in one physics pass per tick
+struct BatchedPhysics : public Configuration::BoolEntry {
+    BatchedPhysics() : BoolEntry("BatchedPhysics", "false") {}
+};
+
 // Whether to start in full screen mode
 struct Fullscreen : public Configuration::BoolEntry {
     Fullscreen() : BoolEntry("Fullscreen", "false") {}
@@ -301,6 +317,12 @@ struct VSync : public Configuration::BoolEntry {
     VSync() : BoolEntry("VSync", "true") {}
 };
 
+// Number of other players on a map from which each of them is drawn as one
+// image composed on the CPU, instead of one quad per part. 0 never does this.
+struct ImpostorThreshold : public Configuration::ShortEntry {
+    ImpostorThreshold() : ShortEntry("ImpostorThreshold", "30") {}
+};
+
 // The normal font which will be used
 struct FontPathNormal : public Configuration::StringEntry {
     FontPathNormal() :
@@ -325,6 +347,24 @@ struct SFXVolume : public Configuration::ByteEntry {
     SFXVolume() : ByteEntry("SFXVolume", "50") {}
 };
 
+// Which audio backend to use
+// "bass" plays through BASS, "mixer" mixes in-process and plays the result
+// through BASS, "none" mixes in-process without any output
+struct AudioOutput : public Configuration::StringEntry {
+    AudioOutput() : StringEntry("AudioOutput", "bass") {}
+};
+
+// Kilobytes of decoded sound effects which are kept in memory
+struct SoundCacheSize : public Configuration::IntEntry {
+    SoundCacheSize() : IntEntry("SoundCacheSize", "16384") {}
+};
+
+// Whether to decode the sounds of mobs and skills in the background as soon
+// as they appear, instead of when they are first played
+struct SoundPrefetch : public Configuration::BoolEntry {
+    SoundPrefetch() : BoolEntry("SoundPrefetch", "true") {}
+};
+
 // Whether to save the last used account name
 struct SaveLogin : public Configuration::BoolEntry {
     SaveLogin() : BoolEntry("SaveLogin", "false") {}
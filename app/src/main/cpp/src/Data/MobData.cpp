@@ -0,0 +1,141 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "MobData.h"
+
+#include <nlnx/nx.hpp>
+
+#include "StringHandling.h"
+
+namespace ms {
+MobData::MobData(int32_t id) : id_(id) {
+    std::string strid = string_format::extend_id(id, 7);
+    nl::node src = nl::nx::mob[strid + ".img"];
+
+    valid_ = src.size() > 0;
+
+    nl::node info = src["info"];
+
+    stats_.level = info["level"];
+    stats_.watk = info["PADamage"];
+    stats_.matk = info["MADamage"];
+    stats_.wdef = info["PDDamage"];
+    stats_.mdef = info["MDDamage"];
+    stats_.accuracy = info["acc"];
+    stats_.avoid = info["eva"];
+    stats_.knockback = info["pushed"];
+    stats_.speed = info["speed"];
+    stats_.fly_speed = info["flySpeed"];
+    stats_.touch_damage = info["bodyAttack"].get_bool();
+    stats_.undead = info["undead"].get_bool();
+    stats_.is_boss = info["boss"].get_bool();
+    stats_.no_flip = info["noFlip"].get_bool();
+    stats_.not_attack = info["notAttack"].get_bool();
+    stats_.can_jump = src["jump"].size() > 0;
+    stats_.can_fly = src["fly"].size() > 0;
+    stats_.can_move = src["move"].size() > 0 || stats_.can_fly;
+
+    stats_.speed += 100;
+    stats_.speed *= 0.001f;
+
+    stats_.fly_speed += 100;
+    stats_.fly_speed *= 0.0005f;
+
+    if (stats_.can_fly) {
+        animations_[Stance::STAND] = src["fly"];
+        animations_[Stance::MOVE] = src["fly"];
+    } else {
+        animations_[Stance::STAND] = src["stand"];
+        animations_[Stance::MOVE] = src["move"];
+    }
+
+    animations_[Stance::JUMP] = src["jump"];
+    animations_[Stance::HIT] = src["hit1"];
+    animations_[Stance::DIE] = src["die1"];
+
+    name_ = std::string(nl::nx::string["Mob.img"][std::to_string(id)]["name"]);
+
+    nl::node sndsrc = nl::nx::sound["Mob.img"][strid];
+
+    hit_sound_ = sndsrc["Damage"];
+    die_sound_ = sndsrc["Die"];
+    hit_sound_.prefetch();
+    die_sound_.prefetch();
+
+    for (const auto &skill : info["skill"]) {
+        auto skill_id = skill["skill"].get_integer();
+        auto action = skill["action"].get_integer();
+        skill_stands_.emplace(skill_id, src["skill" + std::to_string(action)]);
+    }
+
+    for (size_t i = 1; nl::node sub = src["attack" + std::to_string(i)]; i++) {
+        if (sub.size() == 0) {
+            break;
+        }
+
+        attack_stands_.emplace_back(sub);
+    }
+}
+
+bool MobData::is_valid() const {
+    return valid_;
+}
+
+int32_t MobData::get_id() const {
+    return id_;
+}
+
+const MobData::Stats &MobData::get_stats() const {
+    return stats_;
+}
+
+const std::string &MobData::get_name() const {
+    return name_;
+}
+
+const Animation &MobData::get_animation(Stance stance) const {
+    return animations_[stance];
+}
+
+const Animation &MobData::get_skill_stand(int32_t skill_id) const {
+    auto iter = skill_stands_.find(skill_id);
+
+    if (iter == skill_stands_.end()) {
+        return animations_[Stance::STAND];
+    }
+
+    return iter->second;
+}
+
+const Animation &MobData::get_attack_stand(size_t attack) const {
+    if (attack == 0 || attack > attack_stands_.size()) {
+        return animations_[Stance::STAND];
+    }
+
+    return attack_stands_[attack - 1];
+}
+
+size_t MobData::get_attack_count() const {
+    return attack_stands_.size();
+}
+
+const Sound &MobData::get_hit_sound() const {
+    return hit_sound_;
+}
+
+const Sound &MobData::get_die_sound() const {
+    return die_sound_;
+}
+}  // namespace ms
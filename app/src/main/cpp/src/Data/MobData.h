@@ -0,0 +1,104 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2019  Daniel Allendorf, Ryan Payton
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <vector>
+
+#include "../Audio/Audio.h"
+#include "../Graphics/Animation.h"
+#include "../Template/Cache.h"
+#include "../Template/EnumMap.h"
+
+namespace ms {
+// Contains the immutable data of a mob loaded from the game files.
+// Shared between all spawns of the same mob id.
+class MobData : public Cache<MobData> {
+public:
+    // Animations shared by all mobs
+    enum Stance { STAND, MOVE, JUMP, HIT, DIE, LENGTH };
+
+    // The stats of a mob
+    struct Stats {
+        uint16_t level;
+        uint16_t watk;
+        uint16_t matk;
+        uint16_t wdef;
+        uint16_t mdef;
+        uint16_t accuracy;
+        uint16_t avoid;
+        uint16_t knockback;
+        float speed;
+        float fly_speed;
+        bool undead;
+        bool touch_damage;
+        bool no_flip;
+        bool not_attack;
+        bool can_move;
+        bool can_jump;
+        bool can_fly;
+        bool is_boss;
+    };
+
+    // Return whether the mob was found in the game files.
+    bool is_valid() const;
+
+    // Return the mob id.
+    int32_t get_id() const;
+
+    // Return the stats of the mob.
+    const Stats &get_stats() const;
+
+    // Return the name of the mob.
+    const std::string &get_name() const;
+
+    // Return one of the mob's animations.
+    const Animation &get_animation(Stance stance) const;
+
+    // Return the animation used when casting a skill.
+    // Falls back to the standing animation if the mob has none for it.
+    const Animation &get_skill_stand(int32_t skill_id) const;
+
+    // Return the animation of an attack, starting at 1.
+    // Falls back to the standing animation if the mob has none for it.
+    const Animation &get_attack_stand(size_t attack) const;
+
+    // Return the number of attack animations.
+    size_t get_attack_count() const;
+
+    // Return the sound played when the mob is hit.
+    const Sound &get_hit_sound() const;
+
+    // Return the sound played when the mob dies.
+    const Sound &get_die_sound() const;
+
+private:
+    // Allow the cache to use the constructor
+    friend Cache<MobData>;
+
+    // Creates mob data from the game's Mob.nx with the specified id.
+    MobData(int32_t mobid);
+
+    int32_t id_;
+    bool valid_;
+    Stats stats_;
+    std::string name_;
+    EnumMap<Stance, Animation> animations_;
+    std::unordered_map<int32_t, Animation> skill_stands_;
+    std::vector<Animation> attack_stands_;
+    Sound hit_sound_;
+    Sound die_sound_;
+};
+}  // namespace ms
\ No newline at end of file
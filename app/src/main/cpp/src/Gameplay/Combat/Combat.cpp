@@ -143,6 +143,7 @@ void Combat::apply_move(const SpecialMove &move) {
         apply_use_movement(move);
         apply_result_movement(move, result);
 
+        player_.flush_movement();
         fn_attack(result);
 
         if (!reactor_targets.empty()) {
@@ -160,6 +161,7 @@ void Combat::apply_move(const SpecialMove &move) {
 
         int32_t moveid = move.get_id();
         int32_t level = player_.get_skills().get_level(moveid);
+        player_.flush_movement();
         fn_use_skill(moveid, level);
     }
 }
@@ -169,42 +171,24 @@ std::vector<int32_t> Combat::find_closest(MapObjects *objs,
                                           Point<int16_t> origin,
                                           uint8_t objcount,
                                           bool use_mobs) const {
-    std::multimap<uint16_t, int32_t> distances;
-
-    for (auto &mmo : *objs) {
-        if (use_mobs) {
-            const Mob *mob = static_cast<const Mob *>(mmo.second.get());
-
-            if (mob && mob->is_alive() && mob->is_in_range(range)) {
-                int32_t oid = mob->get_oid();
-                uint16_t distance = mob->get_position().distance(origin);
-                distances.emplace(distance, oid);
-            }
-        } else {
-            // Assume Reactor
-            const Reactor *reactor =
-                static_cast<const Reactor *>(mmo.second.get());
-
-            if (reactor && reactor->is_hittable()
-                && reactor->is_in_range(range)) {
-                int32_t oid = reactor->get_oid();
-                uint16_t distance = reactor->get_position().distance(origin);
-                distances.emplace(distance, oid);
-            }
-        }
-    }
-
-    std::vector<int32_t> targets;
-
-    for (auto &iter : distances) {
-        if (targets.size() >= objcount) {
-            break;
-        }
-
-        targets.push_back(iter.second);
+    if (use_mobs) {
+        return objs->find_closest<Mob>(
+            range,
+            origin,
+            objcount,
+            [&](const Mob &mob) {
+                return mob.is_alive() && mob.is_in_range(range);
+            });
     }
 
-    return targets;
+    // Assume Reactor
+    return objs->find_closest<Reactor>(
+        range,
+        origin,
+        objcount,
+        [&](const Reactor &reactor) {
+            return reactor.is_hittable() && reactor.is_in_range(range);
+        });
 }
 
 void Combat::apply_use_movement(const SpecialMove &move) {
@@ -51,7 +51,7 @@ void MobCombat::use_move(int oid, int move_id, int skill_id, uint8_t level) {
 void MobCombat::apply_move(const MobSkill &move, Mob &mob) {
     mob.update_movement(1, 1, 47, move.get_id(), move.get_level(), 0);
     if (move.is_buff()) {
-        mob.give_buff(move.get_buff());
+        mob.give_buff(move.get_id(), move.get_buff());
     }
     mob.use_skill(move);
     move.apply_useeffects(mob);
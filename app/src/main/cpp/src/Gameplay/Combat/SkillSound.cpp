@@ -23,6 +23,8 @@ SingleSkillSound::SingleSkillSound(const std::string &strid) {
 
     use_sound_ = soundsrc["Use"];
     hit_sound_ = soundsrc["Hit"];
+    use_sound_.prefetch();
+    hit_sound_.prefetch();
 }
 
 void SingleSkillSound::play_use() {
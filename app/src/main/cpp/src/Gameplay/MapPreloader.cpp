@@ -0,0 +1,198 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "MapPreloader.h"
+
+#include <nlnx/nx.hpp>
+
+#include <iostream>
+
+#include "../Graphics/BitmapDecoder.h"
+#include "../Graphics/GraphicsGL.h"
+#include "../Util/StringHandling.h"
+
+namespace ms {
+MapPreloader::MapPreloader() :
+    parsed_(false),
+    queued_(false),
+    done_(true),
+    mapid_(0),
+    resident_(0),
+    decode_start_(0),
+    upload_start_(0) {}
+
+MapPreloader::~MapPreloader() {
+    join();
+}
+
+void MapPreloader::join() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void MapPreloader::start(int32_t mapid) {
+    join();
+
+    mapid_ = mapid;
+    done_ = false;
+    parsed_ = false;
+    queued_ = false;
+    resident_ = 0;
+    bitmaps_.clear();
+
+    timings_ = Timings();
+    start_ = ContinuousTimer::get().start();
+    decode_start_ = BitmapDecoder::get().get_decode_time();
+    upload_start_ = GraphicsGL::get().get_upload_time();
+
+    worker_ = std::thread(&MapPreloader::parse, this, mapid);
+}
+
+bool MapPreloader::is_loading(int32_t mapid) const {
+    return mapid_ == mapid && !done_;
+}
+
+bool MapPreloader::update() {
+    if (done_) {
+        return true;
+    }
+
+    if (!parsed_) {
+        return false;
+    }
+
+    join();
+
+    GraphicsGL &graphics = GraphicsGL::get();
+
+    // The atlas is only read on this thread. Bitmaps shared with the last
+    // map are still there and need no decoding.
+    if (!queued_) {
+        queued_ = true;
+
+        std::vector<nl::bitmap> missing;
+
+        for (const nl::bitmap &bmp : bitmaps_) {
+            if (!graphics.is_resident(bmp)) {
+                missing.push_back(bmp);
+            }
+        }
+
+        BitmapDecoder::get().decode(missing);
+    }
+
+    // Uploaded bitmaps stay resident, so only recheck from the first miss
+    while (resident_ < bitmaps_.size() && graphics.is_resident(bitmaps_[resident_])) {
+        resident_++;
+    }
+
+    int64_t elapsed = ContinuousTimer::get().stop(start_);
+
+    if (resident_ < bitmaps_.size() && elapsed < TIMEOUT) {
+        return false;
+    }
+
+    done_ = true;
+
+    timings_.decode = BitmapDecoder::get().get_decode_time() - decode_start_;
+    timings_.upload = graphics.get_upload_time() - upload_start_;
+    timings_.total = elapsed;
+
+    std::cout << "Map " << mapid_ << " loaded " << resident_ << "/" << bitmaps_.size()
+              << " bitmaps in " << timings_.total / 1000 << " ms (parse "
+              << timings_.parse / 1000 << " ms, decode " << timings_.decode / 1000
+              << " ms, upload " << timings_.upload / 1000 << " ms)" << std::endl;
+
+    return true;
+}
+
+float MapPreloader::get_progress() const {
+    if (done_ || bitmaps_.empty()) {
+        return 1.0f;
+    }
+
+    return static_cast<float>(resident_) / bitmaps_.size();
+}
+
+const MapPreloader::Timings &MapPreloader::get_timings() const {
+    return timings_;
+}
+
+nl::node MapPreloader::get_map_node(int32_t mapid) {
+    if (mapid == -1) {
+        return nl::nx::ui["CashShopPreview.img"];
+    }
+
+    std::string strid = string_format::extend_id(mapid, 9);
+    std::string prefix = std::to_string(mapid / 100000000);
+
+    return nl::nx::map["Map"]["Map" + prefix][strid + ".img"];
+}
+
+void MapPreloader::parse(int32_t mapid) {
+    auto start = ContinuousTimer::get().start();
+
+    nl::node src = get_map_node(mapid);
+    nl::node tilesrc = nl::nx::map["Tile"];
+    nl::node objsrc = nl::nx::map["Obj"];
+    nl::node backsrc = nl::nx::map["Back"];
+
+    // Mirrors what MapTilesObjs and MapBackgrounds will construct
+    for (uint8_t layer = 0; layer < 8; layer++) {
+        nl::node layersrc = src[std::to_string(layer)];
+        nl::node tileset = tilesrc[layersrc["info"]["tS"] + ".img"];
+
+        for (const auto &tile : layersrc["tile"]) {
+            add_frames(tileset[tile["u"]][tile["no"]]);
+        }
+
+        for (const auto &obj : layersrc["obj"]) {
+            add_frames(objsrc[obj["oS"] + ".img"][obj["l0"]][obj["l1"]][obj["l2"]]);
+        }
+    }
+
+    for (const auto &back : src["back"]) {
+        bool animated = back["ani"].get_bool();
+
+        add_frames(backsrc[back["bS"] + ".img"][animated ? "ani" : "back"][back["no"]]);
+    }
+
+    add_frames(src["miniMap"]["canvas"]);
+
+    timings_.parse = ContinuousTimer::get().stop(start);
+
+    parsed_ = true;
+}
+
+void MapPreloader::add_frames(const nl::node &src) {
+    if (src.data_type() == nl::node::type::bitmap) {
+        add_bitmap(src);
+        return;
+    }
+
+    for (const auto &sub : src) {
+        if (sub.data_type() == nl::node::type::bitmap) {
+            add_bitmap(sub);
+        }
+    }
+}
+
+void MapPreloader::add_bitmap(nl::bitmap bmp) {
+    if (bmp.width() > 0 && bmp.height() > 0) {
+        bitmaps_.push_back(bmp);
+    }
+}
+}  // namespace ms
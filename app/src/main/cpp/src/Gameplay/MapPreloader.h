@@ -0,0 +1,90 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <nlnx/bitmap.hpp>
+#include <nlnx/node.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../Timer.h"
+
+namespace ms {
+// Collects the bitmaps of a map on a background thread and hands those which
+// are not in the atlas yet to the bitmap decoder, so that they are resident
+// by the time the stage needs them
+class MapPreloader {
+public:
+    // Time spent on each step of a map load, in microseconds
+    struct Timings {
+        int64_t parse = 0;
+        int64_t decode = 0;
+        int64_t upload = 0;
+        int64_t total = 0;
+    };
+
+    MapPreloader();
+
+    ~MapPreloader();
+
+    // Start collecting and decoding the bitmaps of a map
+    void start(int32_t mapid);
+
+    // Check whether the bitmaps of the map are resident, return true once they are
+    bool update();
+
+    // Return true if loading of the specified map was started
+    bool is_loading(int32_t mapid) const;
+
+    // Fraction of the map's bitmaps which are resident
+    float get_progress() const;
+
+    // Return the timings of the last completed load
+    const Timings &get_timings() const;
+
+    // Return the root node of a map
+    static nl::node get_map_node(int32_t mapid);
+
+private:
+    void join();
+
+    void parse(int32_t mapid);
+
+    void add_frames(const nl::node &src);
+
+    void add_bitmap(nl::bitmap bmp);
+
+    // Give up waiting on bitmaps after this many microseconds
+    static const int64_t TIMEOUT = 3000000;
+
+    std::thread worker_;
+    std::atomic<bool> parsed_;
+    bool queued_;
+    bool done_;
+    int32_t mapid_;
+
+    std::vector<nl::bitmap> bitmaps_;
+    size_t resident_;
+
+    ContinuousTimer::point start_;
+    int64_t decode_start_;
+    int64_t upload_start_;
+    Timings timings_;
+};
+}  // namespace ms
@@ -58,6 +58,14 @@ Drop::Drop(int32_t id,
 int8_t Drop::update(const Physics &physics) {
     physics.move_object(phobj_);
 
+    return after_physics(physics);
+}
+
+PhysicsObject *Drop::before_physics(const Physics &) {
+    return &phobj_;
+}
+
+int8_t Drop::after_physics(const Physics &) {
     if (state_ == Drop::State::DROPPED) {
         if (phobj_.onground) {
             phobj_.hspeed = 0.0;
@@ -119,4 +127,11 @@ Rectangle<int16_t> Drop::bounds() const {
 
     return Rectangle<int16_t>(lt, rb);
 }
+
+Rectangle<int16_t> Drop::get_bounds() const {
+    Rectangle<int16_t> area = bounds();
+    area.shift(-get_position());
+
+    return area;
+}
 }  // namespace ms
\ No newline at end of file
@@ -24,10 +24,16 @@ class Drop : public MapObject {
 public:
     int8_t update(const Physics &physics) override;
 
+    PhysicsObject *before_physics(const Physics &physics) override;
+
+    int8_t after_physics(const Physics &physics) override;
+
     void expire(int8_t, const PhysicsObject *);
 
     Rectangle<int16_t> bounds() const;
 
+    Rectangle<int16_t> get_bounds() const override;
+
 protected:
     Drop(int32_t oid,
          int32_t owner,
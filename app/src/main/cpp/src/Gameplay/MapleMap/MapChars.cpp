@@ -15,6 +15,7 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "MapChars.h"
 
+#include "../../Character/Look/ImpostorCache.h"
 #include "OptionalCreator.h"
 
 namespace ms {
@@ -22,7 +23,13 @@ void MapChars::draw(Layer::Id layer,
                     double viewx,
                     double viewy,
                     float alpha) const {
+    // Other players may be drawn as one image each when the map is crowded
+    ImpostorCache &impostors = ImpostorCache::get();
+    impostors.set_enabled(true);
+
     chars_.draw(layer, viewx, viewy, alpha);
+
+    impostors.set_enabled(false);
 }
 
 void MapChars::update(const Physics &physics) {
@@ -40,6 +47,8 @@ void MapChars::update(const Physics &physics) {
     }
 
     chars_.update(physics);
+
+    ImpostorCache::get().update(chars_.size());
 }
 
 void MapChars::spawn(CharSpawn &&spawn) {
@@ -79,13 +88,16 @@ std::optional<std::reference_wrapper<OtherChar>> MapChars::get_char(
 std::optional<std::reference_wrapper<OtherChar>> MapChars::get_char(
     Point<int16_t> position,
     Point<int16_t> viewpos) {
-    for (auto &chr : chars_) {
-        if (inrange(chr.second->get_position(), position, viewpos)) {
-            return create_optional<OtherChar>(chr.second.get());
-        }
-    }
-
-    return {};
+    // Characters are picked within 20 pixels to the side and 70 above
+    Point<int16_t> mappos = position - viewpos;
+    Rectangle<int16_t> area(mappos.x() - 20,
+                            mappos.x() + 20,
+                            mappos.y(),
+                            mappos.y() + 70);
+
+    return chars_.find_first<OtherChar>(area, [&](const OtherChar &candidate) {
+        return inrange(candidate.get_position(), position, viewpos);
+    });
 }
 
 bool MapChars::inrange(Point<int16_t> char_pos,
@@ -100,20 +100,18 @@ MapDrops::Loot MapDrops::find_loot_at(Point<int16_t> playerpos) {
         return { 0, {} };
     }
 
-    for (auto &mmo : drops_) {
-        // auto drop = mmo.second.get();
-        auto drop = create_optional<const Drop>(mmo.second.get());
+    Rectangle<int16_t> point(playerpos, playerpos);
 
-        if (drop && drop->get().bounds().contains(playerpos)) {
-            loot_enabled_ = false;
+    auto drop = drops_.find_first<Drop>(point, [&](const Drop &candidate) {
+        return candidate.bounds().contains(playerpos);
+    });
 
-            int32_t oid = mmo.first;
-            Point<int16_t> position = drop->get().get_position();
-
-            return { oid, position };
-        }
+    if (!drop) {
+        return { 0, {} };
     }
 
-    return { 0, {} };
+    loot_enabled_ = false;
+
+    return { drop->get().get_oid(), drop->get().get_position() };
 }
 }  // namespace ms
\ No newline at end of file
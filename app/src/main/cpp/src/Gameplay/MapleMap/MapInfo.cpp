@@ -31,9 +31,7 @@ MapInfo::MapInfo(const nl::node &src,
         map_borders_ = borders;
     }
 
-    std::string bgmpath = info["bgm"];
-    size_t split = bgmpath.find('/');
-    bgm_ = bgmpath.substr(0, split) + ".img/" + bgmpath.substr(split + 1);
+    bgm_ = find_bgm(src);
 
     cloud_ = info["cloud"].get_bool();
     field_limit_ = info["fieldLimit"];
@@ -61,6 +59,13 @@ std::string MapInfo::get_bgm() const {
     return bgm_;
 }
 
+std::string MapInfo::find_bgm(const nl::node &src) {
+    std::string bgmpath = src["info"]["bgm"];
+    size_t split = bgmpath.find('/');
+
+    return bgmpath.substr(0, split) + ".img/" + bgmpath.substr(split + 1);
+}
+
 Range<int16_t> MapInfo::get_walls() const {
     return map_walls_;
 }
@@ -64,6 +64,9 @@ public:
 
     std::string get_bgm() const;
 
+    // Return the path of the music of a map in Sound.nx
+    static std::string find_bgm(const nl::node &src);
+
     Range<int16_t> get_walls() const;
 
     Range<int16_t> get_borders() const;
@@ -138,18 +138,15 @@ int32_t MapMobs::find_colliding(const MovingObject &moveobj) const {
                                        static_cast<int16_t>(vertical.smaller() - 50),
                                        vertical.greater() };
 
-    auto iter =
-        std::find_if(mobs_.begin(), mobs_.end(), [&player_rect](auto &mmo) {
-            auto mob = create_optional<Mob>(mmo.second.get());
-            return mob && mob->get().is_alive()
-                   && mob->get().is_in_range(player_rect);
-        });
-
-    if (iter == mobs_.end()) {
+    auto mob = mobs_.find_first<Mob>(player_rect, [&](const Mob &candidate) {
+        return candidate.is_alive() && candidate.is_in_range(player_rect);
+    });
+
+    if (!mob) {
         return 0;
     }
 
-    return iter->second->get_oid();
+    return mob->get().get_oid();
 }
 
 MobAttack MapMobs::create_attack(int32_t oid) const {
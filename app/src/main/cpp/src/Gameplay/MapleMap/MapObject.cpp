@@ -27,6 +27,14 @@ int8_t MapObject::update(const Physics &physics) {
     return phobj_.fhlayer;
 }
 
+PhysicsObject *MapObject::before_physics(const Physics &) {
+    return nullptr;
+}
+
+int8_t MapObject::after_physics(const Physics &physics) {
+    return update(physics);
+}
+
 void MapObject::set_position(int16_t x, int16_t y) {
     phobj_.set_x(x);
     phobj_.set_y(y);
@@ -54,6 +62,18 @@ int8_t MapObject::get_layer() const {
     return phobj_.fhlayer;
 }
 
+Rectangle<int16_t> MapObject::get_bounds() const {
+    return {};
+}
+
+int16_t MapObject::get_reach() const {
+    return get_bounds().reach();
+}
+
+void MapObject::reach_changed() {
+    reach_changed_ = true;
+}
+
 int32_t MapObject::get_oid() const {
     return oid_;
 }
@@ -15,6 +15,7 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include "../../Template/Rectangle.h"
 #include "../Camera.h"
 #include "../Physics/Physics.h"
 
@@ -31,6 +32,15 @@ public:
     // Updates the object and returns the updated layer.
     virtual int8_t update(const Physics &physics);
 
+    // Updates the object up to its physics step and returns the physics
+    // object which should be moved, or null if there is nothing to move.
+    // The default defers the whole update to after_physics.
+    virtual PhysicsObject *before_physics(const Physics &physics);
+
+    // Finishes an update after a batched physics step and returns the
+    // updated layer.
+    virtual int8_t after_physics(const Physics &physics);
+
     // Reactivates the object.
     virtual void makeactive();
 
@@ -43,6 +53,14 @@ public:
     // Obtains the layer used to determine the drawing order on the map.
     virtual int8_t get_layer() const;
 
+    // Returns the area covered by the object, relative to its position.
+    virtual Rectangle<int16_t> get_bounds() const;
+
+    // Returns how far the bounds may extend from the position in the current
+    // state. Only read when the object is added to a spatial grid and after
+    // reach_changed.
+    virtual int16_t get_reach() const;
+
     // Changes the objects position.
     void set_position(int16_t x, int16_t y);
 
@@ -58,8 +76,20 @@ public:
 protected:
     MapObject(int32_t oid, Point<int16_t> position = {});
 
+    // Have the spatial grid read the reach again on its next update.
+    void reach_changed();
+
     PhysicsObject phobj_;
     int32_t oid_;
     bool active_;
+
+private:
+    friend class SpatialGrid;
+
+    // Cell of the spatial grid the object is filed under, if any
+    uint32_t grid_key_ = 0;
+    int16_t grid_reach_ = 0;
+    bool in_grid_ = false;
+    bool reach_changed_ = false;
 };
 }  // namespace ms
\ No newline at end of file
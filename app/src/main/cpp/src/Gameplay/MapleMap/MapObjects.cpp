@@ -15,49 +15,121 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "MapObjects.h"
 
+#include "../../Configuration.h"
+
 namespace ms {
+MapObjects::MapObjects() : batched_(Setting<BatchedPhysics>::get().load()) {}
+
 void MapObjects::draw(Layer::Id layer,
                       double viewx,
                       double viewy,
                       float alpha) const {
-    for (const auto &oid : layers_[layer]) {
-        auto mmo = get<MapObject>(oid);
+    for (const auto &drawn : layers_[layer]) {
+        MapObject *mmo = at(drawn.slot);
 
-        if (mmo && mmo->get().is_active()) {
-            mmo->get().draw(viewx, viewy, alpha);
+        if (mmo && mmo->is_active()) {
+            mmo->draw(viewx, viewy, alpha);
         }
     }
 }
 
 void MapObjects::update(const Physics &physics) {
-    for (auto iter = objects_.begin(); iter != objects_.end();) {
-        bool remove_mob = false;
-
-        if (auto &mmo = iter->second) {
-            int8_t oldlayer = mmo->get_layer();
-            int8_t newlayer = mmo->update(physics);
-
-            if (newlayer == -1) {
-                remove_mob = true;
-            } else if (newlayer != oldlayer) {
-                int32_t oid = iter->first;
-                layers_[oldlayer].erase(oid);
-                layers_[newlayer].insert(oid);
-            }
-        } else {
-            remove_mob = true;
+    if (batched_) {
+        update_batched(physics);
+
+        return;
+    }
+
+    for (size_t i = 0; i < objects_.size();) {
+        auto &mmo = objects_[i].second;
+
+        if (!mmo) {
+            erase(i);
+            continue;
+        }
+
+        int8_t oldlayer = mmo->get_layer();
+        int8_t newlayer = mmo->update(physics);
+
+        if (apply_layer(i, oldlayer, newlayer)) {
+            i++;
+        }
+    }
+}
+
+void MapObjects::update_batched(const Physics &physics) {
+    batch_.clear();
+    old_layers_.clear();
+
+    for (size_t i = 0; i < objects_.size();) {
+        auto &mmo = objects_[i].second;
+
+        if (!mmo) {
+            erase(i);
+            continue;
         }
 
-        if (remove_mob) {
-            iter = objects_.erase(iter);
+        old_layers_.push_back(mmo->get_layer());
+
+        if (PhysicsObject *phobj = mmo->before_physics(physics)) {
+            batch_.add(*phobj);
+        }
+
+        i++;
+    }
+
+    physics.move_objects(batch_);
+    batch_.clear();
+
+    for (size_t i = 0; i < objects_.size();) {
+        int8_t oldlayer = old_layers_[i];
+        int8_t newlayer = objects_[i].second->after_physics(physics);
+
+        if (apply_layer(i, oldlayer, newlayer)) {
+            i++;
         } else {
-            iter++;
+            // Follow the object which erase moved into this index
+            old_layers_[i] = old_layers_.back();
+            old_layers_.pop_back();
         }
     }
 }
 
+bool MapObjects::apply_layer(size_t index, int8_t oldlayer, int8_t newlayer) {
+    if (newlayer == -1) {
+        erase(index);
+
+        return false;
+    }
+
+    auto &mmo = objects_[index].second;
+    grid_.update(mmo.get());
+
+    if (newlayer != oldlayer) {
+        int32_t oid = objects_[index].first;
+        erase_drawn(oldlayer, oid);
+        insert_drawn(newlayer, oid, slot_of_[index]);
+    }
+
+    return true;
+}
+
 void MapObjects::clear() {
+    batched_ = Setting<BatchedPhysics>::get().load();
+
+    grid_.clear();
     objects_.clear();
+    slot_of_.clear();
+    slot_by_oid_.clear();
+
+    // Keep the slots so that old handles stay invalid
+    free_slots_.clear();
+
+    for (uint32_t slot = 0; slot < slots_.size(); slot++) {
+        slots_[slot].index = FREE;
+        slots_[slot].generation++;
+        free_slots_.push_back(slot);
+    }
 
     for (auto &layer : layers_) {
         layer.clear();
@@ -65,48 +137,122 @@ void MapObjects::clear() {
 }
 
 bool MapObjects::contains(int32_t oid) const {
-    return objects_.count(oid) > 0;
+    return slot_by_oid_.count(oid) > 0;
 }
 
 void MapObjects::add(std::unique_ptr<MapObject> toadd) {
     int32_t oid = toadd->get_oid();
     int8_t layer = toadd->get_layer();
-    objects_[oid] = std::move(toadd);
-    layers_[layer].insert(oid);
+    remove(oid);
+
+    uint32_t slot;
+
+    if (free_slots_.empty()) {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.push_back({ FREE, 1 });
+    } else {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    slots_[slot].index = static_cast<uint32_t>(objects_.size());
+    slot_of_.push_back(slot);
+    slot_by_oid_[oid] = slot;
+
+    grid_.insert(toadd.get());
+    objects_.emplace_back(oid, std::move(toadd));
+    insert_drawn(layer, oid, slot);
 }
 
 void MapObjects::remove(int32_t oid) {
-    auto iter = objects_.find(oid);
+    auto iter = slot_by_oid_.find(oid);
+
+    if (iter != slot_by_oid_.end()) {
+        erase(slots_[iter->second].index);
+    }
+}
+
+MapObjects::Handle MapObjects::get_handle(int32_t oid) const {
+    auto iter = slot_by_oid_.find(oid);
+
+    if (iter == slot_by_oid_.end()) {
+        return {};
+    }
+
+    return { iter->second, slots_[iter->second].generation };
+}
 
-    if (iter != objects_.end() && iter->second) {
-        int8_t layer = iter->second->get_layer();
-        objects_.erase(iter);
+MapObject *MapObjects::at(uint32_t slot) const {
+    uint32_t index = slots_[slot].index;
 
-        layers_[layer].erase(oid);
+    if (index == FREE) {
+        return nullptr;
     }
+
+    return objects_[index].second.get();
+}
+
+void MapObjects::erase(size_t index) {
+    int32_t oid = objects_[index].first;
+    uint32_t slot = slot_of_[index];
+
+    // The layer may have changed since the object was last drawn
+    auto &mmo = objects_[index].second;
+    int8_t layer = mmo ? mmo->get_layer() : -1;
+
+    if (layer < 0 || layer >= Layer::Id::LENGTH || !erase_drawn(layer, oid)) {
+        for (int8_t i = 0; i < Layer::Id::LENGTH; i++) {
+            erase_drawn(i, oid);
+        }
+    }
+
+    grid_.remove(mmo.get());
+
+    // Move the last object into the gap
+    size_t last = objects_.size() - 1;
+
+    if (index != last) {
+        objects_[index] = std::move(objects_[last]);
+        slot_of_[index] = slot_of_[last];
+        slots_[slot_of_[index]].index = static_cast<uint32_t>(index);
+    }
+
+    objects_.pop_back();
+    slot_of_.pop_back();
+    slot_by_oid_.erase(oid);
+
+    slots_[slot].index = FREE;
+    slots_[slot].generation++;
+    free_slots_.push_back(slot);
 }
 
-// std::optional<std::reference_wrapper<MapObject>> MapObjects::get(int32_t oid)
-// {
-//     auto iter = objects_.find(oid);
+void MapObjects::insert_drawn(int8_t layer, int32_t oid, uint32_t slot) {
+    auto &drawn = layers_[layer];
+    auto iter = std::lower_bound(
+        drawn.begin(),
+        drawn.end(),
+        oid,
+        [](const Drawn &entry, int32_t value) { return entry.oid < value; });
 
-//     if (iter != objects_.end()) {
-//         return create_optional<MapObject>(iter->second.get());
-//     }
+    drawn.insert(iter, { oid, slot });
+}
 
-//     return {};
-// }
+bool MapObjects::erase_drawn(int8_t layer, int32_t oid) {
+    auto &drawn = layers_[layer];
+    auto iter = std::lower_bound(
+        drawn.begin(),
+        drawn.end(),
+        oid,
+        [](const Drawn &entry, int32_t value) { return entry.oid < value; });
 
-// std::optional<std::reference_wrapper<const MapObject>> MapObjects::get(
-//     int32_t oid) const {
-//     auto iter = objects_.find(oid);
+    if (iter != drawn.end() && iter->oid == oid) {
+        drawn.erase(iter);
 
-//     if (iter != objects_.end()) {
-//         return create_optional<const MapObject>(iter->second.get());
-//     }
+        return true;
+    }
 
-//     return {};
-// }
+    return false;
+}
 
 MapObjects::underlying_t::iterator MapObjects::begin() {
     return objects_.begin();
@@ -15,18 +15,34 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include "Layer.h"
 #include "MapObject.h"
 #include "OptionalCreator.h"
+#include "SpatialGrid.h"
 
 namespace ms {
 // A collection of generic MapObjects
+// Objects are kept in a dense array which update walks in order, while each
+// layer keeps a list of slots sorted by oid for drawing.
 class MapObjects {
 public:
+    // Refers to an object without owning it. Resolving a handle to an object
+    // which was removed fails, even if its slot was reused.
+    struct Handle {
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+    };
+
+    MapObjects();
+
     // Draw all MapObjects that are on the specified layer
     void draw(Layer::Id layer, double viewx, double viewy, float alpha) const;
 
@@ -40,7 +56,8 @@ public:
     // Removes the mapobject with the given oid.
     void remove(int32_t oid);
 
-    // Removes all mapobjects of this type.
+    // Removes all mapobjects of this type, e.g. when a map is loaded.
+    // Also reads the physics setting again.
     void clear();
 
     // Check if a map object with the specified id exists on the map
@@ -59,8 +76,38 @@ public:
     template<typename T>
     std::optional<std::reference_wrapper<const T>> get(int32_t oid) const;
 
+    // Return a handle to the object with the given oid.
+    // The handle is invalid if there is no such object.
+    Handle get_handle(int32_t oid) const;
+
+    template<typename T>
+    std::optional<std::reference_wrapper<T>> get(Handle handle);
+
+    template<typename T>
+    std::optional<std::reference_wrapper<const T>> get(Handle handle) const;
+
+    template<typename T, typename F>
+    // Return the first object of type T near the range which matches.
+    std::optional<std::reference_wrapper<T>> find_first(
+        const Rectangle<int16_t> &range,
+        F &&matches);
+
+    template<typename T, typename F>
+    // Return the first object of type T near the range which matches.
+    std::optional<std::reference_wrapper<const T>> find_first(
+        const Rectangle<int16_t> &range,
+        F &&matches) const;
+
+    template<typename T, typename F>
+    // Return the oids of up to count matching objects of type T near the
+    // range, closest to the origin first.
+    std::vector<int32_t> find_closest(const Rectangle<int16_t> &range,
+                                      Point<int16_t> origin,
+                                      size_t count,
+                                      F &&matches) const;
+
     using underlying_t =
-        typename std::unordered_map<int32_t, std::unique_ptr<MapObject>>;
+        typename std::vector<std::pair<int32_t, std::unique_ptr<MapObject>>>;
 
     // Return a begin iterator.
     underlying_t::iterator begin();
@@ -78,16 +125,60 @@ public:
     underlying_t::size_type size() const;
 
 private:
-    std::unordered_map<int32_t, std::unique_ptr<MapObject>> objects_;
-    std::array<std::unordered_set<int32_t>, Layer::Id::LENGTH> layers_;
+    // Where an object lives in the dense array
+    struct Slot {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    // An entry of a layer's draw list. Trivially copyable, so that inserting
+    // and erasing in the middle of a list moves the tail in one block.
+    struct Drawn {
+        int32_t oid;
+        uint32_t slot;
+    };
+
+    // Return the object in a slot, or null if the slot is free.
+    MapObject *at(uint32_t slot) const;
+
+    // Update all objects with one physics pass shared between them.
+    void update_batched(const Physics &physics);
+
+    // Apply the layer returned by an object's update.
+    // Return false if the object was removed.
+    bool apply_layer(size_t index, int8_t oldlayer, int8_t newlayer);
+
+    // Remove the object at an index of the dense array.
+    void erase(size_t index);
+
+    // Add a slot to the draw list of a layer, keeping it sorted by oid.
+    void insert_drawn(int8_t layer, int32_t oid, uint32_t slot);
+
+    // Remove an oid from the draw list of a layer.
+    // Return false if the layer did not contain it.
+    bool erase_drawn(int8_t layer, int32_t oid);
+
+    // Value of Slot::index for free slots
+    static constexpr uint32_t FREE = UINT32_MAX;
+
+    underlying_t objects_;
+    std::vector<uint32_t> slot_of_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<int32_t, uint32_t> slot_by_oid_;
+    std::array<std::vector<Drawn>, Layer::Id::LENGTH> layers_;
+    SpatialGrid grid_;
+    PhysicsBatch batch_;
+    std::vector<int8_t> old_layers_;
+    bool batched_;
 };
 
 template<typename T>
 std::optional<std::reference_wrapper<T>> MapObjects::get(int32_t oid) {
-    auto iter = objects_.find(oid);
+    auto iter = slot_by_oid_.find(oid);
 
-    if (iter != objects_.end()) {
-        return create_optional<T>(iter->second.get());
+    if (iter != slot_by_oid_.end()) {
+        return create_optional<T>(at(iter->second));
     }
 
     return {};
@@ -96,12 +187,104 @@ std::optional<std::reference_wrapper<T>> MapObjects::get(int32_t oid) {
 template<typename T>
 std::optional<std::reference_wrapper<const T>> MapObjects::get(
     int32_t oid) const {
-    auto iter = objects_.find(oid);
+    auto iter = slot_by_oid_.find(oid);
 
-    if (iter != objects_.end()) {
-        return create_optional<const T>(iter->second.get());
+    if (iter != slot_by_oid_.end()) {
+        return create_optional<const T>(at(iter->second));
     }
 
     return {};
 }
+
+template<typename T>
+std::optional<std::reference_wrapper<T>> MapObjects::get(Handle handle) {
+    if (handle.slot >= slots_.size()
+        || slots_[handle.slot].generation != handle.generation) {
+        return {};
+    }
+
+    return create_optional<T>(at(handle.slot));
+}
+
+template<typename T>
+std::optional<std::reference_wrapper<const T>> MapObjects::get(
+    Handle handle) const {
+    if (handle.slot >= slots_.size()
+        || slots_[handle.slot].generation != handle.generation) {
+        return {};
+    }
+
+    return create_optional<const T>(at(handle.slot));
+}
+
+template<typename T, typename F>
+std::optional<std::reference_wrapper<T>> MapObjects::find_first(
+    const Rectangle<int16_t> &range,
+    F &&matches) {
+    T *found = nullptr;
+
+    grid_.query(range, [&](MapObject &object) {
+        auto &candidate = static_cast<T &>(object);
+
+        if (matches(candidate)) {
+            found = &candidate;
+        }
+
+        return found != nullptr;
+    });
+
+    return create_optional<T>(found);
+}
+
+template<typename T, typename F>
+std::optional<std::reference_wrapper<const T>> MapObjects::find_first(
+    const Rectangle<int16_t> &range,
+    F &&matches) const {
+    const T *found = nullptr;
+
+    grid_.query(range, [&](const MapObject &object) {
+        auto &candidate = static_cast<const T &>(object);
+
+        if (matches(candidate)) {
+            found = &candidate;
+        }
+
+        return found != nullptr;
+    });
+
+    return create_optional<const T>(found);
+}
+
+template<typename T, typename F>
+std::vector<int32_t> MapObjects::find_closest(const Rectangle<int16_t> &range,
+                                              Point<int16_t> origin,
+                                              size_t count,
+                                              F &&matches) const {
+    std::vector<std::pair<uint16_t, int32_t>> distances;
+
+    grid_.query(range, [&](const MapObject &object) {
+        auto &candidate = static_cast<const T &>(object);
+
+        if (matches(candidate)) {
+            uint16_t distance = candidate.get_position().distance(origin);
+            distances.emplace_back(distance, candidate.get_oid());
+        }
+
+        return false;
+    });
+
+    size_t found = std::min(count, distances.size());
+    std::partial_sort(distances.begin(),
+                      distances.begin() + found,
+                      distances.end());
+
+    std::vector<int32_t> oids;
+    oids.reserve(found);
+
+    for (size_t i = 0; i < found; i++) {
+        oids.push_back(distances[i].second);
+    }
+
+    return oids;
+}
 }  // namespace ms
\ No newline at end of file
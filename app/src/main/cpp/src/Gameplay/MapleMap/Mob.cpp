@@ -15,10 +15,9 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "Mob.h"
 
-#include <nlnx/nx.hpp>
+#include <cstdlib>
 
 #include "../../Net/Packets/GameplayPackets.h"
-#include "StringHandling.h"
 
 namespace ms {
 namespace {
@@ -35,71 +34,17 @@ Mob::Mob(int32_t oi,
          bool newspawn,
          int8_t tm,
          Point<int16_t> position) :
-    MapObject(oi) {
-    std::string strid = string_format::extend_id(mid, 7);
-    nl::node src = nl::nx::mob[strid + ".img"];
-
-    nl::node info = src["info"];
-
-    level_ = info["level"];
-    watk_ = info["PADamage"];
-    matk_ = info["MADamage"];
-    wdef_ = info["PDDamage"];
-    mdef_ = info["MDDamage"];
-    accuracy_ = info["acc"];
-    avoid_ = info["eva"];
-    knockback_ = info["pushed"];
-    speed_ = info["speed"];
-    fly_speed_ = info["flySpeed"];
-    touch_damage_ = info["bodyAttack"].get_bool();
-    undead_ = info["undead"].get_bool();
-    is_boss_ = info["boss"].get_bool();
-    no_flip_ = info["noFlip"].get_bool();
-    not_attack_ = info["notAttack"].get_bool();
-    can_jump_ = src["jump"].size() > 0;
-    can_fly_ = src["fly"].size() > 0;
-    can_move_ = src["move"].size() > 0 || can_fly_;
-
-    if (can_fly_) {
-        animations_[Stance::STAND] = src["fly"];
-        animations_[Stance::MOVE] = src["fly"];
-    } else {
-        animations_[Stance::STAND] = src["stand"];
-        animations_[Stance::MOVE] = src["move"];
-    }
-
-    animations_[Stance::JUMP] = src["jump"];
-    animations_[Stance::HIT] = src["hit1"];
-    animations_[Stance::DIE] = src["die1"];
-
-    name_ = std::string(nl::nx::string["Mob.img"][std::to_string(mid)]["name"]);
-
-    nl::node sndsrc = nl::nx::sound["Mob.img"][strid];
-
-    hit_sound_ = sndsrc["Damage"];
-    die_sound_ = sndsrc["Die"];
-
-    for (size_t i = 0; i < info["skill"].size(); i++) {
-        auto skill_id = info["skill"][i]["skill"].get_integer();
-        auto action = info["skill"][i]["action"].get_integer();
-        skill_stands_.insert(
-            { skill_id, src["skill" + std::to_string(action)] });
-    }
-
-    for (size_t i = 1; src["attack" + std::to_string(i)].size() > 0; i++) {
-        attack_stands_.insert({ i, src["attack" + std::to_string(i)] });
-    }
+    MapObject(oi), data_(MobData::get(mid)), stats_(data_.get_stats()) {
+    animations_[Stance::STAND] = data_.get_animation(MobData::Stance::STAND);
+    animations_[Stance::MOVE] = data_.get_animation(MobData::Stance::MOVE);
+    animations_[Stance::JUMP] = data_.get_animation(MobData::Stance::JUMP);
+    animations_[Stance::HIT] = data_.get_animation(MobData::Stance::HIT);
+    animations_[Stance::DIE] = data_.get_animation(MobData::Stance::DIE);
 
     // init or risk crash
     animations_[Stance::SKILL] = animations_[Stance::STAND];
 
-    speed_ += 100;
-    speed_ *= 0.001f;
-
-    fly_speed_ += 100;
-    fly_speed_ *= 0.0005f;
-
-    if (can_fly_) {
+    if (stats_.can_fly) {
         phobj_.type = PhysicsObject::Type::FLYING;
     }
 
@@ -117,12 +62,15 @@ Mob::Mob(int32_t oi,
     set_stance(st);
     fly_direction_ = STRAIGHT;
     counter_ = 0;
+    playback_fragment_ = 0;
+    moved_ = false;
+    aniend_ = false;
 
     name_label_ = Text(Text::Font::A13M,
                        Text::Alignment::CENTER,
                        Color::Name::WHITE,
                        Text::Background::NAMETAG,
-                       name_);
+                       data_.get_name());
 
     if (newspawn) {
         fade_in_ = true;
@@ -156,21 +104,32 @@ void Mob::set_stance(Stance newstance) {
         stance_ = newstance;
 
         animations_.at(stance_).reset();
+        reach_changed();
     }
 }
 
 int8_t Mob::update(const Physics &physics) {
+    if (PhysicsObject *phobj = before_physics(physics)) {
+        physics.move_object(*phobj);
+    }
+
+    return after_physics(physics);
+}
+
+PhysicsObject *Mob::before_physics(const Physics &physics) {
+    moved_ = false;
+
     if (!active_) {
-        return phobj_.fhlayer;
+        return nullptr;
     }
 
-    bool aniend = animations_.at(stance_).update();
+    aniend_ = animations_.at(stance_).update();
 
-    if (aniend && stance_ == Stance::SKILL) {
+    if (aniend_ && stance_ == Stance::SKILL) {
         set_stance(Stance::STAND);
     }
 
-    if (aniend && stance_ == Stance::DIE) {
+    if (aniend_ && stance_ == Stance::DIE) {
         dead_ = true;
     }
 
@@ -194,20 +153,32 @@ int8_t Mob::update(const Physics &physics) {
     if (dead_) {
         deactivate();
 
-        return -1;
+        return nullptr;
     }
 
     effects_.update();
     show_hp_.update();
 
-    // remove later
-    if (!buffs_.empty()) {
-        effects_.add(buffs_.at(0).anim,
-                     DrawArgument(get_head_position(Point<int16_t>()), false));
-    }
+    buff_effects_.update();
+
+    if (!dying_ && !control_ && playback_.is_active()) {
+        playback_.update();
+
+        // Skill and attack animations play out before the next fragment's
+        // stance is taken over
+        if (playback_fragment_ != playback_.get_fragment()
+            && stance_ != Stance::SKILL) {
+            playback_fragment_ = playback_.get_fragment();
+            set_stance(playback_.get_state());
+        }
 
-    if (!dying_) {
-        if (!can_fly_) {
+        phobj_.hspeed = playback_.get_x() - phobj_.crnt_x();
+        phobj_.vspeed = playback_.get_y() - phobj_.crnt_y();
+        phobj_.move();
+
+        physics.get_fht().update_fh(phobj_);
+    } else if (!dying_) {
+        if (!stats_.can_fly) {
             if (phobj_.is_flag_not_set(PhysicsObject::Flag::TURN_AT_EDGES)) {
                 flip_ = !flip_;
                 phobj_.set_flag(PhysicsObject::Flag::TURN_AT_EDGES);
@@ -220,24 +191,25 @@ int8_t Mob::update(const Physics &physics) {
 
         switch (stance_) {
             case Stance::MOVE:
-                if (can_fly_) {
-                    phobj_.hforce = flip_ ? fly_speed_ : -fly_speed_;
+                if (stats_.can_fly) {
+                    phobj_.hforce =
+                        flip_ ? stats_.fly_speed : -stats_.fly_speed;
 
                     switch (fly_direction_) {
                         case FlyDirection::UPWARDS:
-                            phobj_.vforce = -fly_speed_;
+                            phobj_.vforce = -stats_.fly_speed;
                             break;
                         case FlyDirection::DOWNWARDS:
-                            phobj_.vforce = fly_speed_;
+                            phobj_.vforce = stats_.fly_speed;
                             break;
                     }
                 } else {
-                    phobj_.hforce = flip_ ? speed_ : -speed_;
+                    phobj_.hforce = flip_ ? stats_.speed : -stats_.speed;
                 }
 
                 break;
             case Stance::HIT:
-                if (can_move_) {
+                if (stats_.can_move) {
                     double KBFORCE = phobj_.onground ? 0.2 : 0.1;
                     phobj_.hforce = flip_ ? -KBFORCE : KBFORCE;
                 }
@@ -246,35 +218,45 @@ int8_t Mob::update(const Physics &physics) {
             case Stance::JUMP: phobj_.vforce = -5.0; break;
         }
 
-        physics.move_object(phobj_);
+        moved_ = true;
 
-        if (control_) {
-            counter_++;
+        return &phobj_;
+    } else {
+        phobj_.normalize();
+        physics.get_fht().update_fh(phobj_);
+    }
 
-            bool next = false;
+    return nullptr;
+}
 
-            switch (stance_) {
-                case Stance::HIT: next = counter_ > 200; break;
-                case Stance::JUMP: next = phobj_.onground; break;
-                default: next = aniend && counter_ > 200; break;
-            }
+int8_t Mob::after_physics(const Physics &) {
+    if (dead_) {
+        return -1;
+    }
 
-            if (next) {
-                next_move();
-                update_movement();
-                counter_ = 0;
-            }
+    if (moved_ && control_) {
+        counter_++;
+
+        bool next = false;
+
+        switch (stance_) {
+            case Stance::HIT: next = counter_ > 200; break;
+            case Stance::JUMP: next = phobj_.onground; break;
+            default: next = aniend_ && counter_ > 200; break;
+        }
+
+        if (next) {
+            next_move();
+            update_movement();
+            counter_ = 0;
         }
-    } else {
-        phobj_.normalize();
-        physics.get_fht().update_fh(phobj_);
     }
 
     return phobj_.fhlayer;
 }
 
 void Mob::next_move() {
-    if (can_move_) {
+    if (stats_.can_move) {
         switch (stance_) {
             case Stance::HIT:
             case Stance::STAND:
@@ -283,7 +265,8 @@ void Mob::next_move() {
                 break;
             case Stance::MOVE:
             case Stance::JUMP:
-                if (can_jump_ && phobj_.onground && randomizer_.below(0.25f)) {
+                if (stats_.can_jump && phobj_.onground
+                    && randomizer_.below(0.25f)) {
                     set_stance(Stance::JUMP);
                 } else {
                     switch (randomizer_.next_int(3)) {
@@ -302,7 +285,7 @@ void Mob::next_move() {
                 break;
         }
 
-        if (stance_ == Stance::MOVE && can_fly_) {
+        if (stance_ == Stance::MOVE && stats_.can_fly) {
             fly_direction_ =
                 randomizer_.next_enum(FlyDirection::NUM_DIRECTIONS);
         }
@@ -340,40 +323,57 @@ void Mob::update_movement(int16_t type,
                 Movement(phobj_, value_of(stance_, flip_)));
 }
 
-void Mob::give_buff(const MobBuff &buff) {
-    buffs_.push_back(buff);
+void Mob::give_buff(int32_t skill_id, const MobBuff &buff) {
+    buff_effects_.add(skill_id, buff.anim);
 }
 
 void Mob::use_skill(const MobSkill &skill) {
-    animations_[Stance::SKILL] = skill_stands_.at(skill.get_id());
+    animations_[Stance::SKILL] = data_.get_skill_stand(skill.get_id());
     set_stance(Stance::SKILL);
-
-    if (skill.is_buff() && buffs_.empty()) {
-        buffs_.push_back(skill.get_buff());
-    }
+    reach_changed();
 }
 
 void Mob::use_attack(const MobSpecialAttack &attack) {
-    animations_[Stance::SKILL] = attack_stands_.at(attack.get_id());
+    animations_[Stance::SKILL] = data_.get_attack_stand(attack.get_id());
     set_stance(Stance::SKILL);
+    reach_changed();
 }
 
 void Mob::use_some_attack() {
-    if (stance_ == Stance::SKILL || attack_stands_.empty()) {
+    if (stance_ == Stance::SKILL || data_.get_attack_count() == 0) {
         return;
     }
 
-    animations_[Stance::SKILL] =
-        attack_stands_.at((std::rand() % attack_stands_.size()) + 1);
+    animations_[Stance::SKILL] = data_.get_attack_stand(
+        randomizer_.next_int(data_.get_attack_count()) + 1);
     set_stance(Stance::SKILL);
 }
 
-void Mob::cancel_buff(int32_t buff) {
-    buffs_.clear();
+void Mob::cancel_buff(int32_t skill_id) {
+    buff_effects_.remove(skill_id);
+}
+
+void Mob::apply_status(uint64_t status, int32_t skill_id) {
+    status_skills_[status] = skill_id;
+}
+
+void Mob::cancel_statuses(uint64_t statuses) {
+    for (auto iter = status_skills_.begin(); iter != status_skills_.end();) {
+        if (iter->first & statuses) {
+            cancel_buff(iter->second);
+            iter = status_skills_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
 }
 
 bool Mob::has_buff() const {
-    return !buffs_.empty();
+    return !buff_effects_.empty();
+}
+
+size_t Mob::get_effect_count() const {
+    return effects_.size() + buff_effects_.size();
 }
 
 void Mob::draw(double viewx, double viewy, float alpha) const {
@@ -386,7 +386,7 @@ void Mob::draw(double viewx, double viewy, float alpha) const {
         float interopc = opacity_.get(alpha);
 
         animations_.at(stance_).draw(
-            DrawArgument(absp, flip_ && !no_flip_, interopc),
+            DrawArgument(absp, flip_ && !stats_.no_flip, interopc),
             alpha);
 
         if (show_hp_) {
@@ -399,11 +399,16 @@ void Mob::draw(double viewx, double viewy, float alpha) const {
     }
 
     effects_.drawabove(absp, alpha);
+    buff_effects_.drawabove(headpos, alpha);
 }
 
 void Mob::set_control(int8_t mode) {
     control_ = mode > 0;
     aggro_ = mode == 2;
+
+    if (control_) {
+        playback_.clear();
+    }
 }
 
 void Mob::send_movement(Point<int16_t> start,
@@ -412,26 +417,27 @@ void Mob::send_movement(Point<int16_t> start,
         return;
     }
 
-    set_position(start);
-
-    movements_ = std::forward<decltype(in_movements)>(in_movements);
+    // Snap to the server's position when starting out or when far off
+    constexpr int16_t MAX_DRIFT = 100;
+    Point<int16_t> drift = start - playback_.get_destination();
 
-    if (movements_.empty()) {
-        return;
+    if (!playback_.is_active() || std::abs(drift.x()) > MAX_DRIFT
+        || std::abs(drift.y()) > MAX_DRIFT) {
+        set_position(start);
+        playback_.reset(start, value_of(stance_, flip_));
     }
 
-    const Movement &lastmove = movements_.front();
-
-    uint8_t laststance = lastmove.newstate;
-    set_stance(laststance);
+    playback_.push(in_movements);
+}
 
-    phobj_.fhid = lastmove.fh;
+const MovementPlayback::Stats &Mob::get_playback_stats() const {
+    return playback_.get_stats();
 }
 
 Point<int16_t> Mob::get_head_position(Point<int16_t> position) const {
     Point<int16_t> head = animations_.at(stance_).get_head();
 
-    position.shift_x((flip_ && !no_flip_) ? -head.x() : head.x());
+    position.shift_x((flip_ && !stats_.no_flip) ? -head.x() : head.x());
     position.shift_y(head.y());
 
     return position;
@@ -454,7 +460,7 @@ void Mob::kill(int8_t animation) {
 
 void Mob::show_hp(int8_t percent, uint16_t playerlevel) {
     if (hp_percent_ == 0) {
-        int16_t delta = playerlevel - level_;
+        int16_t delta = playerlevel - stats_.level;
 
         if (delta > 9) {
             name_label_.change_color(Color::Name::YELLOW);
@@ -498,7 +504,7 @@ float Mob::calculate_hitchance(int16_t leveldelta,
                                int32_t player_accuracy) const {
     float faccuracy = static_cast<float>(player_accuracy);
     float hitchance =
-        faccuracy / (((1.84f + 0.07f * leveldelta) * avoid_) + 1.0f);
+        faccuracy / (((1.84f + 0.07f * leveldelta) * stats_.avoid) + 1.0f);
 
     if (hitchance < 0.01f) {
         hitchance = 0.01f;
@@ -510,8 +516,9 @@ float Mob::calculate_hitchance(int16_t leveldelta,
 double Mob::calculate_mindamage(int16_t leveldelta,
                                 double damage,
                                 bool magic) const {
-    double mindamage = magic ? damage - (1 + 0.01 * leveldelta) * mdef_ * 0.6
-                             : damage * (1 - 0.01 * leveldelta) - wdef_ * 0.6;
+    double mindamage =
+        magic ? damage - (1 + 0.01 * leveldelta) * stats_.mdef * 0.6
+              : damage * (1 - 0.01 * leveldelta) - stats_.wdef * 0.6;
 
     return mindamage < 1.0 ? 1.0 : mindamage;
 }
@@ -519,8 +526,9 @@ double Mob::calculate_mindamage(int16_t leveldelta,
 double Mob::calculate_maxdamage(int16_t leveldelta,
                                 double damage,
                                 bool magic) const {
-    double maxdamage = magic ? damage - (1 + 0.01 * leveldelta) * mdef_ * 0.5
-                             : damage * (1 - 0.01 * leveldelta) - wdef_ * 0.5;
+    double maxdamage =
+        magic ? damage - (1 + 0.01 * leveldelta) * stats_.mdef * 0.5
+              : damage * (1 - 0.01 * leveldelta) - stats_.wdef * 0.5;
 
     return maxdamage < 1.0 ? 1.0 : maxdamage;
 }
@@ -531,7 +539,7 @@ std::vector<std::pair<int32_t, bool>> Mob::calculate_damage(
     double maxdamage;
     float hitchance;
     float critical;
-    int16_t leveldelta = level_ - attack.playerlevel;
+    int16_t leveldelta = stats_.level - attack.playerlevel;
 
     if (leveldelta < 0) {
         leveldelta = 0;
@@ -561,11 +569,19 @@ std::vector<std::pair<int32_t, bool>> Mob::calculate_damage(
             break;
     }
 
-    std::vector<std::pair<int32_t, bool>> result(attack.hitcount);
+    std::vector<double> rolls(attack.hitcount * 3);
+    randomizer_.next_reals(rolls.begin(), rolls.end(), 0.0, 1.0);
 
-    std::generate(result.begin(), result.end(), [&]() {
-        return next_damage(mindamage, maxdamage, hitchance, critical);
-    });
+    std::vector<std::pair<int32_t, bool>> result;
+    result.reserve(attack.hitcount);
+
+    for (size_t i = 0; i < attack.hitcount; i++) {
+        result.push_back(next_damage(mindamage,
+                                     maxdamage,
+                                     hitchance,
+                                     critical,
+                                     &rolls[i * 3]));
+    }
 
     update_movement();
 
@@ -575,8 +591,9 @@ std::vector<std::pair<int32_t, bool>> Mob::calculate_damage(
 std::pair<int32_t, bool> Mob::next_damage(double mindamage,
                                           double maxdamage,
                                           float hitchance,
-                                          float critical) const {
-    bool hit = randomizer_.below(hitchance);
+                                          float critical,
+                                          const double *rolls) const {
+    bool hit = rolls[0] < hitchance;
 
     if (!hit) {
         return std::pair<int32_t, bool>(0, false);
@@ -584,8 +601,13 @@ std::pair<int32_t, bool> Mob::next_damage(double mindamage,
 
     constexpr double DAMAGECAP = 999999.0;
 
-    double damage = randomizer_.next_real(mindamage, maxdamage);
-    bool iscritical = randomizer_.below(critical);
+    double damage = mindamage;
+
+    if (mindamage < maxdamage) {
+        damage += (maxdamage - mindamage) * rolls[1];
+    }
+
+    bool iscritical = rolls[2] < critical;
 
     if (iscritical) {
         damage *= 1.5;
@@ -603,11 +625,12 @@ std::pair<int32_t, bool> Mob::next_damage(double mindamage,
 }
 
 void Mob::apply_damage(int32_t damage, bool toleft) {
-    hit_sound_.play();
+    data_.get_hit_sound().play();
 
     if (dying_ && stance_ != Stance::DIE) {
         apply_death();
-    } else if (control_ && is_alive() && damage >= knockback_ && !is_boss_) {
+    } else if (control_ && is_alive() && damage >= stats_.knockback
+               && !stats_.is_boss) {
         flip_ = toleft;
         counter_ = 170;
         set_stance(Stance::HIT);
@@ -617,12 +640,12 @@ void Mob::apply_damage(int32_t damage, bool toleft) {
 }
 
 MobAttack Mob::create_touch_attack() const {
-    if (!touch_damage_) {
+    if (!stats_.touch_damage) {
         return MobAttack();
     }
 
-    int32_t minattack = static_cast<int32_t>(watk_ * 0.8f);
-    int32_t maxattack = watk_;
+    int32_t minattack = static_cast<int32_t>(stats_.watk * 0.8f);
+    int32_t maxattack = stats_.watk;
     int32_t attack = randomizer_.next_int(minattack, maxattack);
 
     return MobAttack(attack, get_position(), id_, oid_);
@@ -630,7 +653,7 @@ MobAttack Mob::create_touch_attack() const {
 
 void Mob::apply_death() {
     set_stance(Stance::DIE);
-    die_sound_.play();
+    data_.get_die_sound().play();
     dying_ = true;
 }
 
@@ -643,12 +666,20 @@ bool Mob::is_in_range(const Rectangle<int16_t> &range) const {
         return false;
     }
 
-    Rectangle<int16_t> bounds = animations_.at(stance_).get_bounds();
+    Rectangle<int16_t> bounds = get_bounds();
     bounds.shift(get_position());
 
     return range.overlaps(bounds);
 }
 
+Rectangle<int16_t> Mob::get_bounds() const {
+    return animations_.at(stance_).get_bounds();
+}
+
+int16_t Mob::get_reach() const {
+    return animations_.at(stance_).get_reach();
+}
+
 Point<int16_t> Mob::get_head_position() const {
     Point<int16_t> position = get_position();
 
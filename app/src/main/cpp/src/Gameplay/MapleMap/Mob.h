@@ -16,18 +16,20 @@
 #pragma once
 
 #include <array>
+#include <unordered_map>
 #include <vector>
 
-#include "../../Audio/Audio.h"
+#include "../../Data/MobData.h"
 #include "../../Graphics/EffectLayer.h"
 #include "../../Graphics/Geometry.h"
+#include "../../Graphics/RecurringEffect.h"
 #include "../../Util/Randomizer.h"
 #include "../../Util/TimedBool.h"
 #include "../Combat/Attack.h"
 #include "../Combat/Bullet.h"
 #include "../Combat/MobSkill.h"
 #include "../Combat/MobSpecialAttack.h"
-#include "../Movement.h"
+#include "../MovementPlayback.h"
 #include "MapObject.h"
 
 namespace ms {
@@ -76,6 +78,12 @@ public:
     // Update movement and animations.
     int8_t update(const Physics &physics) override;
 
+    // Update animations and movement forces before the physics step.
+    PhysicsObject *before_physics(const Physics &physics) override;
+
+    // Continue controlled movement after the physics step.
+    int8_t after_physics(const Physics &physics) override;
+
     // Change this mob's control mode:
     // 0 - no control, 1 - control, 2 - aggro
     void set_control(int8_t mode);
@@ -83,6 +91,9 @@ public:
     // Send movement to the mob.
     void send_movement(Point<int16_t> start, std::vector<Movement> &&movements);
 
+    // Return the metrics of the movement playback.
+    const MovementPlayback::Stats &get_playback_stats() const;
+
     // Kill the mob with the appropriate type:
     // 0 - make inactive 1 - death animation 2 - fade out
     void kill(int8_t killtype);
@@ -110,6 +121,12 @@ public:
     // Check if this mob collides with the specified rectangle.
     bool is_in_range(const Rectangle<int16_t> &range) const;
 
+    // Return the bounds of the current animation frame.
+    Rectangle<int16_t> get_bounds() const override;
+
+    // Return how far any frame of the current animation extends.
+    int16_t get_reach() const override;
+
     // Check if this mob is still alive.
     bool is_alive() const;
 
@@ -127,7 +144,8 @@ public:
                          int8_t skill_level,
                          int16_t option);
 
-    void give_buff(const MobBuff &buff);
+    // Show the animation of a buff from a mob skill until it is cancelled.
+    void give_buff(int32_t skill_id, const MobBuff &buff);
 
     void use_skill(const MobSkill &skill);
 
@@ -135,10 +153,20 @@ public:
 
     void use_some_attack();
 
-    void cancel_buff(int32_t stat);
+    // Remove the buff given by a mob skill.
+    void cancel_buff(int32_t skill_id);
+
+    // Remember which skill gave a status, as one bit of the status mask.
+    void apply_status(uint64_t status, int32_t skill_id);
+
+    // Remove the buffs of the skills which gave any of the statuses.
+    void cancel_statuses(uint64_t statuses);
 
     bool has_buff() const;
 
+    // Return the number of effects currently shown with the mob.
+    size_t get_effect_count() const;
+
 private:
     enum FlyDirection { STRAIGHT, UPWARDS, DOWNWARDS, NUM_DIRECTIONS };
 
@@ -170,52 +198,36 @@ private:
                                double maxdamage,
                                bool magic) const;
 
-    // Calculate a random damage line based on the specified values.
+    // Calculate a damage line based on the specified values.
+    // Uses three random rolls in [0, 1) for hit, damage and critical.
     std::pair<int32_t, bool> next_damage(double mindamage,
                                          double maxdamage,
                                          float hitchance,
-                                         float critical) const;
+                                         float critical,
+                                         const double *rolls) const;
 
     // Return the current 'head' position
     Point<int16_t> get_head_position(Point<int16_t> position) const;
 
+    const MobData &data_;
+    const MobData::Stats &stats_;
     std::map<Stance, Animation> animations_;
     std::unordered_map<int32_t, MobSkill> skills_;
     std::unordered_map<int32_t, MobSpecialAttack> attacks_;
-    std::unordered_map<int32_t, Animation> skill_stands_;
-    std::unordered_map<int32_t, Animation> attack_stands_;
-    std::vector<MobBuff> buffs_;
-    std::string name_;
-    Sound hit_sound_;
-    Sound die_sound_;
-    uint16_t level_;
-    float speed_;
-    float fly_speed_;
-    uint16_t watk_;
-    uint16_t matk_;
-    uint16_t wdef_;
-    uint16_t mdef_;
-    uint16_t accuracy_;
-    uint16_t avoid_;
-    uint16_t knockback_;
-    bool undead_;
-    bool touch_damage_;
-    bool no_flip_;
-    bool not_attack_;
-    bool can_move_;
-    bool can_jump_;
-    bool can_fly_;
-    bool is_boss_;
-
     EffectLayer effects_;
+    RecurringEffect buff_effects_;
+    std::unordered_map<uint64_t, int32_t> status_skills_;
     Text name_label_;
     MobHpBar hp_bar_;
     Randomizer randomizer_;
 
     TimedBool show_hp_;
 
-    std::vector<Movement> movements_;
+    MovementPlayback playback_;
+    uint32_t playback_fragment_;
     uint16_t counter_;
+    bool moved_;
+    bool aniend_;
 
     int32_t id_;
     int8_t effect_;
@@ -93,13 +93,17 @@ bool Reactor::is_in_range(const Rectangle<int16_t> &range) const {
         return false;
     }
 
-    Rectangle<int16_t> bounds(
+    Rectangle<int16_t> bounds = get_bounds();
+    bounds.shift(get_position());
+
+    return range.overlaps(bounds);
+}
+
+Rectangle<int16_t> Reactor::get_bounds() const {
+    return Rectangle<int16_t>(
         Point<int16_t>(-30, -normal_.get_dimensions().y()),
         Point<int16_t>(
             normal_.get_dimensions().x() - 10,
             0));  // normal.get_bounds(); //animations.at(stance).get_bounds();
-    bounds.shift(get_position());
-
-    return range.overlaps(bounds);
 }
 }  // namespace ms
\ No newline at end of file
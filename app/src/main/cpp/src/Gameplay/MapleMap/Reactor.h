@@ -40,6 +40,8 @@ public:
     // Check if this mob collides with the specified rectangle.
     bool is_in_range(const Rectangle<int16_t> &range) const;
 
+    Rectangle<int16_t> get_bounds() const override;
+
 private:
 //    int32_t oid_;
     int32_t rid_;
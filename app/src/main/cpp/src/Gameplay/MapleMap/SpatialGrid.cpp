@@ -0,0 +1,130 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "SpatialGrid.h"
+
+namespace ms {
+void SpatialGrid::insert(MapObject *object) {
+    uint32_t key = key_of(object->get_position());
+
+    cells_[key].push_back(object);
+    object->grid_key_ = key;
+    object->grid_reach_ = object->get_reach();
+    object->in_grid_ = true;
+    object->reach_changed_ = false;
+
+    add_reach(object->grid_reach_);
+}
+
+void SpatialGrid::update(MapObject *object) {
+    if (!object->in_grid_) {
+        insert(object);
+        return;
+    }
+
+    if (object->reach_changed_) {
+        remove_reach(object->grid_reach_);
+        object->grid_reach_ = object->get_reach();
+        object->reach_changed_ = false;
+        add_reach(object->grid_reach_);
+    }
+
+    uint32_t key = key_of(object->get_position());
+
+    if (key == object->grid_key_) {
+        return;
+    }
+
+    remove_from_cell(object);
+
+    cells_[key].push_back(object);
+    object->grid_key_ = key;
+}
+
+void SpatialGrid::remove(MapObject *object) {
+    if (!object || !object->in_grid_) {
+        return;
+    }
+
+    remove_from_cell(object);
+    remove_reach(object->grid_reach_);
+    object->in_grid_ = false;
+}
+
+void SpatialGrid::clear() {
+    for (auto &cell : cells_) {
+        for (MapObject *object : cell.second) {
+            object->in_grid_ = false;
+        }
+    }
+
+    cells_.clear();
+    reaches_.clear();
+    reach_ = 0;
+}
+
+void SpatialGrid::remove_from_cell(MapObject *object) {
+    auto cell = cells_.find(object->grid_key_);
+
+    if (cell == cells_.end()) {
+        return;
+    }
+
+    auto &objects = cell->second;
+    auto found = std::find(objects.begin(), objects.end(), object);
+
+    if (found != objects.end()) {
+        *found = objects.back();
+        objects.pop_back();
+    }
+
+    if (objects.empty()) {
+        cells_.erase(cell);
+    }
+}
+
+void SpatialGrid::add_reach(int16_t reach) {
+    reaches_[reach]++;
+    reach_ = std::max<int32_t>(reach_, reach);
+}
+
+void SpatialGrid::remove_reach(int16_t reach) {
+    auto iter = reaches_.find(reach);
+
+    if (iter == reaches_.end()) {
+        return;
+    }
+
+    if (--iter->second == 0) {
+        reaches_.erase(iter);
+        reach_ = reaches_.empty() ? 0 : reaches_.rbegin()->first;
+    }
+}
+
+int32_t SpatialGrid::cell_of(int32_t coordinate) {
+    // Round towards negative infinity so that cells do not straddle zero
+    return coordinate >= 0 ? coordinate / CELL_SIZE
+                           : (coordinate - CELL_SIZE + 1) / CELL_SIZE;
+}
+
+uint32_t SpatialGrid::key_of(int32_t x, int32_t y) {
+    return (static_cast<uint32_t>(x & 0xFFFF) << 16)
+           | static_cast<uint32_t>(y & 0xFFFF);
+}
+
+uint32_t SpatialGrid::key_of(Point<int16_t> position) {
+    return key_of(cell_of(position.x()), cell_of(position.y()));
+}
+}  // namespace ms
\ No newline at end of file
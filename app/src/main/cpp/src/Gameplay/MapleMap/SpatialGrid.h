@@ -0,0 +1,102 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "MapObject.h"
+
+namespace ms {
+// A uniform grid over map coordinates which buckets objects by position, so
+// that range queries only visit objects near the range
+// Queries are widened by the largest reach of the objects in the grid, which
+// is read when an object is added and again after it reports a change.
+class SpatialGrid {
+public:
+    // Add an object at its current position.
+    void insert(MapObject *object);
+
+    // Move an object to the cell of its current position.
+    void update(MapObject *object);
+
+    // Remove an object.
+    void remove(MapObject *object);
+
+    // Remove all objects. They must still be alive.
+    void clear();
+
+    template<typename F>
+    // Call fn with every object whose bounds may overlap the range, until it
+    // returns true. Callers still have to test the objects themselves.
+    void query(const Rectangle<int16_t> &range, F &&fn) const {
+        if (cells_.empty()) {
+            return;
+        }
+
+        int32_t margin = reach_ + SLACK;
+        int32_t left = cell_of(std::min(range.left(), range.right()) - margin);
+        int32_t right = cell_of(std::max(range.left(), range.right()) + margin);
+        int32_t top = cell_of(std::min(range.top(), range.bottom()) - margin);
+        int32_t bottom =
+            cell_of(std::max(range.top(), range.bottom()) + margin);
+
+        for (int32_t x = left; x <= right; x++) {
+            for (int32_t y = top; y <= bottom; y++) {
+                auto iter = cells_.find(key_of(x, y));
+
+                if (iter == cells_.end()) {
+                    continue;
+                }
+
+                for (MapObject *object : iter->second) {
+                    if (fn(*object)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    // Take an object out of the cell it is filed under.
+    void remove_from_cell(MapObject *object);
+
+    // Count an object's reach towards the largest one.
+    void add_reach(int16_t reach);
+
+    // Stop counting an object's reach.
+    void remove_reach(int16_t reach);
+
+    static int32_t cell_of(int32_t coordinate);
+
+    static uint32_t key_of(int32_t x, int32_t y);
+
+    static uint32_t key_of(Point<int16_t> position);
+
+    // Width and height of a cell in pixels
+    static constexpr int32_t CELL_SIZE = 128;
+    // Extra margin for objects which moved since the last update
+    static constexpr int32_t SLACK = 16;
+
+    std::unordered_map<uint32_t, std::vector<MapObject *>> cells_;
+    // Number of objects with each reach
+    std::map<int16_t, uint32_t> reaches_;
+    int32_t reach_ = 0;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,268 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "MovementPlayback.h"
+
+#include "../Constants.h"
+
+namespace ms {
+MovementPlayback::MovementPlayback() :
+    x_(0.0),
+    y_(0.0),
+    from_x_(0.0),
+    from_y_(0.0),
+    speed_x_(0.0),
+    speed_y_(0.0),
+    elapsed_(0),
+    waited_(0),
+    extrapolating_(0),
+    fragment_(0),
+    state_(0),
+    waiting_(false),
+    active_(false) {}
+
+void MovementPlayback::reset(Point<int16_t> position, uint8_t state) {
+    fragments_.clear();
+
+    x_ = position.x();
+    y_ = position.y();
+    from_x_ = x_;
+    from_y_ = y_;
+    speed_x_ = 0.0;
+    speed_y_ = 0.0;
+    elapsed_ = 0;
+    extrapolating_ = 0;
+    state_ = state;
+    waiting_ = false;
+    active_ = true;
+
+    stats_.depth = 0;
+    stats_.fragments = 0;
+}
+
+void MovementPlayback::clear() {
+    fragments_.clear();
+    active_ = false;
+
+    stats_.depth = 0;
+    stats_.fragments = 0;
+}
+
+void MovementPlayback::push(const std::vector<Movement> &movements) {
+    bool empty = fragments_.empty();
+    bool idle = empty
+                && (extrapolating_ >= MAX_EXTRAPOLATION
+                    || (speed_x_ == 0.0 && speed_y_ == 0.0));
+
+    Point<int16_t> last = get_destination();
+
+    for (const Movement &movement : movements) {
+        Fragment fragment = { 0.0, 0.0, movement.newstate, 0 };
+
+        switch (movement.type) {
+            case Movement::Type::ABSOLUTE:
+            case Movement::Type::CHAIR:
+            case Movement::Type::JUMPDOWN:
+                fragment.x = movement.xpos;
+                fragment.y = movement.ypos;
+                break;
+            case Movement::Type::RELATIVE:
+                fragment.x = last.x() + movement.xpos;
+                fragment.y = last.y() + movement.ypos;
+                break;
+            default: continue;
+        }
+
+        if (movement.duration > 0) {
+            fragment.duration = movement.duration;
+        }
+
+        last = Point<int16_t>(static_cast<int16_t>(fragment.x),
+                              static_cast<int16_t>(fragment.y));
+
+        fragments_.push_back(fragment);
+        stats_.depth += fragment.duration;
+    }
+
+    if (fragments_.empty()) {
+        return;
+    }
+
+    if (idle) {
+        waiting_ = true;
+        waited_ = 0;
+    }
+
+    if (stats_.depth > MAX_DEPTH) {
+        // Far behind, skip to the newest fragments
+        while (fragments_.size() > 1 && stats_.depth > JITTER_BUFFER) {
+            const Fragment &skipped = fragments_.front();
+            x_ = skipped.x;
+            y_ = skipped.y;
+            stats_.depth -= skipped.duration - elapsed_;
+            elapsed_ = 0;
+            fragments_.pop_front();
+        }
+
+        begin_fragment();
+    } else if (empty && !waiting_) {
+        // Continue from wherever extrapolation left off
+        begin_fragment();
+    }
+
+    stats_.fragments = fragments_.size();
+}
+
+void MovementPlayback::update() {
+    if (!active_) {
+        return;
+    }
+
+    if (waiting_) {
+        waited_ += Constants::TIMESTEP;
+
+        if (stats_.depth < JITTER_BUFFER && waited_ < JITTER_BUFFER) {
+            return;
+        }
+
+        waiting_ = false;
+        begin_fragment();
+    }
+
+    if (fragments_.empty()) {
+        extrapolate();
+        return;
+    }
+
+    // Play faster while more than the jitter buffer has piled up
+    uint16_t step = Constants::TIMESTEP;
+
+    if (stats_.depth > 3 * JITTER_BUFFER) {
+        step = Constants::TIMESTEP * 2;
+    } else if (stats_.depth > 2 * JITTER_BUFFER) {
+        step = Constants::TIMESTEP * 5 / 4;
+    }
+
+    while (step > 0 && !fragments_.empty()) {
+        const Fragment &fragment = fragments_.front();
+        uint16_t remaining = fragment.duration - elapsed_;
+
+        if (step < remaining) {
+            elapsed_ += step;
+            stats_.depth -= step;
+
+            double progress =
+                static_cast<double>(elapsed_) / fragment.duration;
+            x_ = from_x_ + (fragment.x - from_x_) * progress;
+            y_ = from_y_ + (fragment.y - from_y_) * progress;
+
+            step = 0;
+        } else {
+            step -= remaining;
+            stats_.depth -= remaining;
+
+            if (fragment.duration > 0) {
+                speed_x_ = (fragment.x - from_x_) / fragment.duration;
+                speed_y_ = (fragment.y - from_y_) / fragment.duration;
+            }
+
+            x_ = fragment.x;
+            y_ = fragment.y;
+            elapsed_ = 0;
+            fragments_.pop_front();
+
+            begin_fragment();
+        }
+    }
+
+    stats_.fragments = fragments_.size();
+
+    if (fragments_.empty()) {
+        extrapolating_ = 0;
+
+        if (speed_x_ != 0.0 || speed_y_ != 0.0) {
+            stats_.underruns++;
+        }
+    }
+}
+
+bool MovementPlayback::is_active() const {
+    return active_;
+}
+
+Point<int16_t> MovementPlayback::get_destination() const {
+    if (fragments_.empty()) {
+        return Point<int16_t>(static_cast<int16_t>(x_),
+                              static_cast<int16_t>(y_));
+    }
+
+    const Fragment &last = fragments_.back();
+
+    return Point<int16_t>(static_cast<int16_t>(last.x),
+                          static_cast<int16_t>(last.y));
+}
+
+double MovementPlayback::get_x() const {
+    return x_;
+}
+
+double MovementPlayback::get_y() const {
+    return y_;
+}
+
+uint8_t MovementPlayback::get_state() const {
+    return state_;
+}
+
+uint32_t MovementPlayback::get_fragment() const {
+    return fragment_;
+}
+
+const MovementPlayback::Stats &MovementPlayback::get_stats() const {
+    return stats_;
+}
+
+void MovementPlayback::begin_fragment() {
+    from_x_ = x_;
+    from_y_ = y_;
+    extrapolating_ = 0;
+
+    if (!fragments_.empty()) {
+        state_ = fragments_.front().state;
+        fragment_++;
+    }
+}
+
+void MovementPlayback::extrapolate() {
+    if (extrapolating_ >= MAX_EXTRAPOLATION) {
+        return;
+    }
+
+    if (speed_x_ == 0.0 && speed_y_ == 0.0) {
+        return;
+    }
+
+    x_ += speed_x_ * Constants::TIMESTEP;
+    y_ += speed_y_ * Constants::TIMESTEP;
+
+    extrapolating_ += Constants::TIMESTEP;
+    stats_.extrapolated += Constants::TIMESTEP;
+
+    if (extrapolating_ >= MAX_EXTRAPOLATION) {
+        speed_x_ = 0.0;
+        speed_y_ = 0.0;
+    }
+}
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,112 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "../Template/Point.h"
+#include "Movement.h"
+
+namespace ms {
+// Replays movement fragments received from the server on a smooth timeline.
+// Playback runs slightly behind the newest fragment to absorb jitter, and
+// continues along the last velocity for a short while when packets are late.
+class MovementPlayback {
+public:
+    // Playback metrics
+    struct Stats {
+        // Milliseconds of movement buffered ahead of playback
+        uint32_t depth = 0;
+        // Fragments waiting to be played
+        size_t fragments = 0;
+        // Total milliseconds spent extrapolating
+        uint64_t extrapolated = 0;
+        // Number of times playback ran out of fragments while moving
+        uint32_t underruns = 0;
+    };
+
+    MovementPlayback();
+
+    // Start playback at a position, discarding buffered movement.
+    void reset(Point<int16_t> position, uint8_t state);
+
+    // Stop playback until it is reset again.
+    void clear();
+
+    // Queue fragments received from the server.
+    void push(const std::vector<Movement> &movements);
+
+    // Advance playback by one tick.
+    void update();
+
+    // Return whether playback was started.
+    bool is_active() const;
+
+    // Return the position at the end of the queued movement.
+    Point<int16_t> get_destination() const;
+
+    double get_x() const;
+
+    double get_y() const;
+
+    uint8_t get_state() const;
+
+    // Return a number that changes whenever playback moves on to a new
+    // fragment.
+    uint32_t get_fragment() const;
+
+    const Stats &get_stats() const;
+
+private:
+    struct Fragment {
+        double x;
+        double y;
+        uint8_t state;
+        uint16_t duration;
+    };
+
+    // Make the first queued fragment the current one.
+    void begin_fragment();
+
+    // Continue along the last velocity while no fragments are queued.
+    void extrapolate();
+
+    // Milliseconds of movement buffered before playback starts
+    static constexpr uint16_t JITTER_BUFFER = 100;
+    // Longest time to continue moving without new fragments
+    static constexpr uint16_t MAX_EXTRAPOLATION = 150;
+    // Beyond this much buffered movement, skip ahead instead of catching up
+    static constexpr uint16_t MAX_DEPTH = 1000;
+
+    std::deque<Fragment> fragments_;
+    double x_;
+    double y_;
+    double from_x_;
+    double from_y_;
+    double speed_x_;
+    double speed_y_;
+    uint16_t elapsed_;
+    uint16_t waited_;
+    uint16_t extrapolating_;
+    uint32_t fragment_;
+    uint8_t state_;
+    bool waiting_;
+    bool active_;
+    Stats stats_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,128 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "MovementRecorder.h"
+
+#include <algorithm>
+
+#include "../Configuration.h"
+#include "../Constants.h"
+#include "../Net/Packets/GameplayPackets.h"
+
+namespace ms {
+MovementRecorder::MovementRecorder() :
+    interval_(load_interval()),
+    pending_time_(0),
+    window_time_(0),
+    window_packets_(0),
+    window_bytes_(0) {}
+
+void MovementRecorder::record(const Movement &movement) {
+    window_time_ += Constants::TIMESTEP;
+
+    if (window_time_ >= 1000) {
+        float seconds = window_time_ / 1000.0f;
+        stats_.packets_per_second = window_packets_ / seconds;
+        stats_.bytes_per_second = window_bytes_ / seconds;
+
+        window_time_ = 0;
+        window_packets_ = 0;
+        window_bytes_ = 0;
+    }
+
+    if (!fragments_.empty()) {
+        pending_time_ += Constants::TIMESTEP;
+    }
+
+    if (last_.hasmoved(movement)) {
+        bool newstance = movement.newstate != last_.newstate;
+
+        if (!newstance && continues(movement)) {
+            Movement &fragment = fragments_.back();
+            fragment.xpos = movement.xpos;
+            fragment.ypos = movement.ypos;
+            fragment.lastx = movement.lastx;
+            fragment.lasty = movement.lasty;
+            fragment.duration += Constants::TIMESTEP;
+        } else {
+            fragments_.push_back(movement);
+            fragments_.back().duration = Constants::TIMESTEP;
+        }
+
+        last_ = movement;
+
+        if (newstance || fragments_.size() >= MAX_FRAGMENTS) {
+            flush();
+            return;
+        }
+    }
+
+    if (fragments_.empty()) {
+        return;
+    }
+
+    if (pending_time_ >= interval_) {
+        flush();
+    }
+}
+
+void MovementRecorder::flush() {
+    if (fragments_.empty()) {
+        return;
+    }
+
+    MovePlayerPacket packet(fragments_);
+    size_t length = packet.length();
+    packet.dispatch();
+
+    stats_.packets++;
+    stats_.fragments += fragments_.size();
+    stats_.bytes += length;
+    window_packets_++;
+    window_bytes_ += length;
+
+    fragments_.clear();
+    pending_time_ = 0;
+}
+
+void MovementRecorder::clear() {
+    fragments_.clear();
+    pending_time_ = 0;
+    last_ = Movement();
+    interval_ = load_interval();
+}
+
+const MovementRecorder::Stats &MovementRecorder::get_stats() const {
+    return stats_;
+}
+
+uint16_t MovementRecorder::load_interval() {
+    uint16_t interval = Setting<MovementInterval>::get().load();
+
+    return std::min<uint16_t>(interval, MAX_INTERVAL);
+}
+
+bool MovementRecorder::continues(const Movement &movement) const {
+    if (fragments_.empty()) {
+        return false;
+    }
+
+    const Movement &fragment = fragments_.back();
+
+    return fragment.fh == movement.fh
+           && fragment.xpos - fragment.lastx == movement.xpos - movement.lastx
+           && fragment.ypos - fragment.lasty == movement.ypos - movement.lasty;
+}
+}  // namespace ms
\ No newline at end of file
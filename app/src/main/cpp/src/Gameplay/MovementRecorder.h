@@ -0,0 +1,76 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Movement.h"
+
+namespace ms {
+// Collects the player's movement into fragments and sends them to the server
+// in one packet per interval, instead of one packet per tick
+class MovementRecorder {
+public:
+    // Movement packets sent to the server
+    struct Stats {
+        uint64_t packets = 0;
+        uint64_t fragments = 0;
+        uint64_t bytes = 0;
+        float packets_per_second = 0.0f;
+        float bytes_per_second = 0.0f;
+    };
+
+    MovementRecorder();
+
+    // Record the movement of one tick. Sends the pending fragments when the
+    // interval has passed or the stance changed.
+    void record(const Movement &movement);
+
+    // Send the pending fragments immediately.
+    void flush();
+
+    // Drop the pending fragments, used when the player is placed on a new map.
+    // Also picks up a changed movement interval.
+    void clear();
+
+    // Return the counters of sent movement packets
+    const Stats &get_stats() const;
+
+private:
+    // Read the configured interval, capped at the longest allowed
+    static uint16_t load_interval();
+
+    // Return whether a movement continues the last fragment in a straight
+    // line, so that it can be merged into it
+    bool continues(const Movement &movement) const;
+
+    // A packet holds at most this many fragments
+    static constexpr size_t MAX_FRAGMENTS = 64;
+
+    // Fragments are never held back for longer than this many milliseconds
+    static constexpr uint16_t MAX_INTERVAL = 1000;
+
+    std::vector<Movement> fragments_;
+    Movement last_;
+    uint16_t interval_;
+    uint16_t pending_time_;
+    uint16_t window_time_;
+    uint64_t window_packets_;
+    uint64_t window_bytes_;
+    Stats stats_;
+};
+}  // namespace ms
\ No newline at end of file
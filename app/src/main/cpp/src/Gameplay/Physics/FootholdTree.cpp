@@ -15,6 +15,7 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "FootholdTree.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace ms {
@@ -45,12 +46,17 @@ FootholdTree::FootholdTree(const nl::node &src) {
                     continue;
                 }
 
-                const Foothold &foothold =
-                    footholds_
-                        .emplace(std::piecewise_construct,
-                                 std::forward_as_tuple(id),
-                                 std::forward_as_tuple(lastf, id, layer))
-                        .first->second;
+                if (id >= footholds_.size()) {
+                    footholds_.resize(id + 1);
+                }
+
+                // Keep the first foothold with this id
+                if (footholds_[id].id() == id) {
+                    continue;
+                }
+
+                footholds_[id] = Foothold(lastf, id, layer);
+                const Foothold &foothold = footholds_[id];
 
                 if (foothold.l() < leftw) {
                     leftw = foothold.l();
@@ -67,23 +73,66 @@ FootholdTree::FootholdTree(const nl::node &src) {
                 if (foothold.t() < topb) {
                     topb = foothold.t();
                 }
+            }
+        }
+    }
 
-                if (foothold.is_wall()) {
-                    continue;
-                }
+    walls_ = { leftw + 25, rightw - 25 };
+    borders_ = { topb - 300, botb + 100 };
 
-                int16_t start = foothold.l();
-                int16_t end = foothold.r();
+    build_columns();
+}
 
-                for (int i = start; i <= end; i++) {
-                    footholds_by_x_.emplace(i, id);
-                }
+void FootholdTree::build_columns() {
+    int32_t left = INT32_MAX;
+    int32_t right = INT32_MIN;
+
+    for (const Foothold &fh : footholds_) {
+        if (fh.id() && !fh.is_wall()) {
+            left = std::min<int32_t>(left, fh.l());
+            right = std::max<int32_t>(right, fh.r());
+        }
+    }
+
+    if (left > right) {
+        return;
+    }
+
+    columns_left_ = left;
+
+    size_t count = (right - left) / COLUMN_WIDTH + 1;
+    column_starts_.assign(count + 1, 0);
+
+    // Count the footholds of each column first, then fill them in place
+    for (const Foothold &fh : footholds_) {
+        if (fh.id() && !fh.is_wall()) {
+            int32_t first = (fh.l() - left) / COLUMN_WIDTH;
+            int32_t last = (fh.r() - left) / COLUMN_WIDTH;
+
+            for (int32_t i = first; i <= last; i++) {
+                column_starts_[i + 1]++;
             }
         }
     }
 
-    walls_ = { leftw + 25, rightw - 25 };
-    borders_ = { topb - 300, botb + 100 };
+    for (size_t i = 0; i < count; i++) {
+        column_starts_[i + 1] += column_starts_[i];
+    }
+
+    column_fhids_.resize(column_starts_[count]);
+    std::vector<uint32_t> fill(column_starts_.begin(),
+                               column_starts_.end() - 1);
+
+    for (const Foothold &fh : footholds_) {
+        if (fh.id() && !fh.is_wall()) {
+            int32_t first = (fh.l() - left) / COLUMN_WIDTH;
+            int32_t last = (fh.r() - left) / COLUMN_WIDTH;
+
+            for (int32_t i = first; i <= last; i++) {
+                column_fhids_[fill[i]++] = fh.id();
+            }
+        }
+    }
 }
 
 FootholdTree::FootholdTree() = default;
@@ -217,13 +266,11 @@ void FootholdTree::update_fh(PhysicsObject &phobj) const {
 }
 
 const Foothold &FootholdTree::get_fh(uint16_t fhid) const {
-    auto iter = footholds_.find(fhid);
-
-    if (iter == footholds_.end()) {
+    if (fhid >= footholds_.size()) {
         return null_fh_;
     }
 
-    return iter->second;
+    return footholds_[fhid];
 }
 
 double FootholdTree::get_wall(uint16_t curid, bool left, double fy) const {
@@ -303,10 +350,27 @@ uint16_t FootholdTree::get_fhid_below(double fx, double fy) const {
     double comp = borders_.second();
 
     auto x = static_cast<int16_t>(fx);
-    auto range = footholds_by_x_.equal_range(x);
 
-    for (auto iter = range.first; iter != range.second; ++iter) {
-        const Foothold &fh = footholds_.at(iter->second);
+    if (x < columns_left_) {
+        return 0;
+    }
+
+    size_t column = (x - columns_left_) / COLUMN_WIDTH;
+
+    if (column + 1 >= column_starts_.size()) {
+        return 0;
+    }
+
+    uint32_t first = column_starts_[column];
+    uint32_t last = column_starts_[column + 1];
+
+    for (uint32_t i = first; i < last; i++) {
+        const Foothold &fh = footholds_[column_fhids_[i]];
+
+        if (x < fh.l() || x > fh.r()) {
+            continue;
+        }
+
         double ycomp = fh.ground_below(fx);
 
         if (comp >= ycomp && ycomp >= fy) {
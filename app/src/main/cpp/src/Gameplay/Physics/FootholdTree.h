@@ -15,7 +15,7 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
-#include <unordered_map>
+#include <vector>
 
 #include "Foothold.h"
 #include "PhysicsObject.h"
@@ -54,8 +54,21 @@ private:
 
     const Foothold &get_fh(uint16_t fhid) const;
 
-    std::unordered_map<uint16_t, Foothold> footholds_;
-    std::unordered_multimap<int16_t, uint16_t> footholds_by_x_;
+    // Build the column index from the loaded footholds.
+    void build_columns();
+
+    // Width of a column in the index
+    static constexpr int32_t COLUMN_WIDTH = 64;
+
+    // Footholds indexed by their id, with gaps left as null footholds
+    std::vector<Foothold> footholds_;
+
+    // The ids of non-wall footholds which overlap each column, stored
+    // contiguously. Column i owns the ids from column_starts_[i] to
+    // column_starts_[i + 1].
+    std::vector<uint32_t> column_starts_;
+    std::vector<uint16_t> column_fhids_;
+    int32_t columns_left_ = 0;
 
     Foothold null_fh_;
     Range<int16_t> walls_;
@@ -56,6 +56,51 @@ void Physics::move_object(PhysicsObject &phobj) const {
     phobj.move();
 }
 
+void Physics::move_objects(PhysicsBatch &batch) const {
+    batch.resize();
+
+    // Determine platforms first, as they decide the forces below
+    for (size_t i = 0; i < batch.size(); i++) {
+        PhysicsObject &phobj = *batch.objects_[i];
+        fh_tree_.update_fh(phobj);
+
+        bool gravity = phobj.is_flag_not_set(PhysicsObject::Flag::NO_GRAVITY);
+
+        switch (phobj.type) {
+            case PhysicsObject::Type::NORMAL:
+                batch.gather(i,
+                             PhysicsBatch::Kind::GROUND,
+                             FRICTION,
+                             gravity ? GRAVFORCE : 0.0);
+                break;
+            case PhysicsObject::Type::FLYING:
+                batch.gather(i, PhysicsBatch::Kind::FLUID, FLYFRICTION, 0.0);
+                break;
+            case PhysicsObject::Type::SWIMMING:
+                batch.gather(i,
+                             PhysicsBatch::Kind::FLUID,
+                             SWIMFRICTION,
+                             gravity ? SWIMGRAVFORCE : 0.0);
+                break;
+            case PhysicsObject::Type::FIXATED:
+            default: batch.kind_[i] = PhysicsBatch::Kind::STILL; break;
+        }
+    }
+
+    move_batch(batch);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        PhysicsObject &phobj = *batch.objects_[i];
+
+        if (batch.kind_[i] != PhysicsBatch::Kind::STILL) {
+            batch.scatter(i);
+            fh_tree_.limit_movement(phobj);
+        }
+
+        phobj.move();
+    }
+}
+
 void Physics::move_normal(PhysicsObject &phobj) const {
     phobj.vacc = 0.0;
     phobj.hacc = 0.0;
@@ -136,6 +181,60 @@ void Physics::move_swimming(PhysicsObject &phobj) const {
     }
 }
 
+void Physics::move_batch(PhysicsBatch &batch) const {
+    size_t count = batch.size();
+    const PhysicsBatch::Kind *kind = batch.kind_.data();
+    const uint8_t *onground = batch.onground_.data();
+    double *hspeed = batch.hspeed_.data();
+    double *vspeed = batch.vspeed_.data();
+    double *hacc = batch.hacc_.data();
+    double *vacc = batch.vacc_.data();
+    const double *hforce = batch.hforce_.data();
+    const double *vforce = batch.vforce_.data();
+    const double *slope = batch.slope_.data();
+    const double *friction = batch.friction_.data();
+    const double *gravity = batch.gravity_.data();
+
+    // The steps of move_normal, move_flying and move_swimming, computed for
+    // every object and selected by kind so the loop has no branches
+    for (size_t i = 0; i < count; i++) {
+        double hs = hspeed[i];
+        double vs = vspeed[i];
+
+        // Ground
+        bool ground = onground[i] != 0;
+        double gha = ground ? hforce[i] : 0.0;
+        double gva = ground ? vforce[i] : gravity[i];
+
+        bool rest = gha == 0.0 && hs < 0.1 && hs > -0.1;
+        double inertia = hs / GROUNDSLIP;
+        double slopef = slope[i];
+        slopef = slopef > 0.5 ? 0.5 : slopef;
+        slopef = slopef < -0.5 ? -0.5 : slopef;
+
+        double drag =
+            (friction[i] + SLOPEFACTOR * (1.0 + slopef * -inertia)) * inertia;
+        gha = ground && !rest ? gha - drag : gha;
+
+        double ghs = (ground && rest ? 0.0 : hs) + gha;
+        double gvs = vs + gva;
+
+        // Flying and swimming
+        double fha = hforce[i] - friction[i] * hs;
+        double fva = vforce[i] - friction[i] * vs + gravity[i];
+        double fhs = hs + fha;
+        double fvs = vs + fva;
+        fhs = fha == 0.0 && fhs < 0.1 && fhs > -0.1 ? 0.0 : fhs;
+        fvs = fva == 0.0 && fvs < 0.1 && fvs > -0.1 ? 0.0 : fvs;
+
+        bool fluid = kind[i] == PhysicsBatch::Kind::FLUID;
+        hacc[i] = fluid ? fha : gha;
+        vacc[i] = fluid ? fva : gva;
+        hspeed[i] = fluid ? fhs : ghs;
+        vspeed[i] = fluid ? fvs : gvs;
+    }
+}
+
 Point<int16_t> Physics::get_y_below(Point<int16_t> position) const {
     int16_t ground = fh_tree_.get_y_below(position);
 
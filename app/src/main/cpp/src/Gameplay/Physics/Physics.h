@@ -16,6 +16,7 @@
 #pragma once
 
 #include "FootholdTree.h"
+#include "PhysicsBatch.h"
 
 namespace ms {
 // Class that uses physics engines and the collection of platforms to determine
@@ -29,6 +30,10 @@ public:
     // Move the specified object over the specified game-time.
     void move_object(PhysicsObject &tomove) const;
 
+    // Move all objects in a batch over the specified game-time.
+    // The result is the same as moving each object separately.
+    void move_objects(PhysicsBatch &batch) const;
+
     // Determine the point on the ground below the specified position.
     Point<int16_t> get_y_below(Point<int16_t> position) const;
 
@@ -42,6 +47,8 @@ private:
 
     void move_swimming(PhysicsObject &) const;
 
+    void move_batch(PhysicsBatch &) const;
+
     FootholdTree fh_tree_;
 };
 }  // namespace ms
\ No newline at end of file
@@ -0,0 +1,75 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "PhysicsBatch.h"
+
+namespace ms {
+void PhysicsBatch::add(PhysicsObject &phobj) {
+    objects_.push_back(&phobj);
+}
+
+void PhysicsBatch::clear() {
+    objects_.clear();
+}
+
+size_t PhysicsBatch::size() const {
+    return objects_.size();
+}
+
+bool PhysicsBatch::empty() const {
+    return objects_.empty();
+}
+
+void PhysicsBatch::resize() {
+    size_t count = objects_.size();
+    kind_.resize(count);
+    onground_.resize(count);
+    hspeed_.resize(count);
+    vspeed_.resize(count);
+    hforce_.resize(count);
+    vforce_.resize(count);
+    hacc_.resize(count);
+    vacc_.resize(count);
+    slope_.resize(count);
+    friction_.resize(count);
+    gravity_.resize(count);
+}
+
+void PhysicsBatch::gather(size_t i,
+                          Kind kind,
+                          double friction,
+                          double gravity) {
+    const PhysicsObject &phobj = *objects_[i];
+    kind_[i] = kind;
+    onground_[i] = phobj.onground;
+    hspeed_[i] = phobj.hspeed;
+    vspeed_[i] = phobj.vspeed;
+    hforce_[i] = phobj.hforce;
+    vforce_[i] = phobj.vforce;
+    slope_[i] = phobj.fhslope;
+    friction_[i] = friction;
+    gravity_[i] = gravity;
+}
+
+void PhysicsBatch::scatter(size_t i) {
+    PhysicsObject &phobj = *objects_[i];
+    phobj.hspeed = hspeed_[i];
+    phobj.vspeed = vspeed_[i];
+    phobj.hacc = hacc_[i];
+    phobj.vacc = vacc_[i];
+    phobj.hforce = 0.0;
+    phobj.vforce = 0.0;
+}
+}  // namespace ms
\ No newline at end of file
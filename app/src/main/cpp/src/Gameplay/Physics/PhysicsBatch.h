@@ -0,0 +1,71 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PhysicsObject.h"
+
+namespace ms {
+class Physics;
+
+// A set of physics objects which are moved together in one pass
+// The properties used by the integration are gathered into contiguous
+// arrays, stepped in one tight loop and written back afterwards.
+class PhysicsBatch {
+public:
+    // Queue an object for the next step.
+    void add(PhysicsObject &phobj);
+
+    // Remove all queued objects.
+    void clear();
+
+    // Return the number of queued objects.
+    size_t size() const;
+
+    // Return if no objects are queued.
+    bool empty() const;
+
+private:
+    friend Physics;
+
+    // How the forces on an object are integrated
+    enum Kind : uint8_t { STILL, GROUND, FLUID };
+
+    // Size the arrays to the number of queued objects.
+    void resize();
+
+    // Copy an object's properties into the arrays.
+    void gather(size_t index, Kind kind, double friction, double gravity);
+
+    // Copy the results back into an object.
+    void scatter(size_t index);
+
+    std::vector<PhysicsObject *> objects_;
+    std::vector<Kind> kind_;
+    std::vector<uint8_t> onground_;
+    std::vector<double> hspeed_;
+    std::vector<double> vspeed_;
+    std::vector<double> hforce_;
+    std::vector<double> vforce_;
+    std::vector<double> hacc_;
+    std::vector<double> vacc_;
+    std::vector<double> slope_;
+    std::vector<double> friction_;
+    std::vector<double> gravity_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -64,18 +64,36 @@ void Stage::init() {
     drops_.init();
 }
 
+void Stage::preload(int32_t mapid) {
+    if (!preloader_.is_loading(mapid)) {
+        preloader_.start(mapid);
+    }
+
+    // Decode the map's music while the screen fades out
+    Music(MapInfo::find_bgm(MapPreloader::get_map_node(mapid))).prefetch();
+}
+
 void Stage::load(int32_t mapid, int8_t portalid) {
     switch (state_) {
+        // A map change while the previous map is still loading starts over
         case State::INACTIVE:
+        case State::LOADING:
             load_map(mapid);
             respawn(portalid);
-            break;
+
+            // Stay hidden until the map's bitmaps are uploaded
+            state_ = preloader_.update() ? State::ACTIVE : State::LOADING;
+            return;
         case State::TRANSITION: respawn(portalid); break;
     }
 
     state_ = State::ACTIVE;
 }
 
+const MapPreloader::Timings &Stage::get_load_timings() const {
+    return preloader_.get_timings();
+}
+
 void Stage::load_player(const CharEntry &entry,
                         uint8_t wid,
                         uint8_t channel_id) {
@@ -102,12 +120,9 @@ void Stage::clear() {
 void Stage::load_map(int32_t mapid) {
     Stage::map_id_ = mapid;
 
-    std::string strid = string_format::extend_id(mapid, 9);
-    std::string prefix = std::to_string(mapid / 100000000);
+    preload(mapid);
 
-    nl::node src = mapid == -1
-                       ? nl::nx::ui["CashShopPreview.img"]
-                       : nl::nx::map["Map"]["Map" + prefix][strid + ".img"];
+    nl::node src = MapPreloader::get_map_node(mapid);
 
     tiles_objs_ = MapTilesObjs(src);
     backgrounds_ = MapBackgrounds(src["back"]);
@@ -158,6 +173,10 @@ void Stage::draw(float alpha) const {
 }
 
 void Stage::update() {
+    if (state_ == State::LOADING && preloader_.update()) {
+        state_ = State::ACTIVE;
+    }
+
     if (state_ != State::ACTIVE) {
         return;
     }
@@ -205,12 +224,15 @@ void Stage::check_portals() {
     Portal::WarpInfo warpinfo = portals_.find_warp_at(playerpos);
 
     if (warpinfo.intramap) {
+        player_.flush_movement();
+
         Point<int16_t> spawnpoint =
             portals_.get_portal_by_name(warpinfo.toname);
         Point<int16_t> startpos = physics_.get_y_below(spawnpoint);
 
         player_.respawn(startpos, map_info_.is_underwater());
     } else if (warpinfo.valid) {
+        player_.flush_movement();
         fn_change_map(false, -1, warpinfo.name, false);
 
         CharStats &stats = Stage::get().get_player().get_stats();
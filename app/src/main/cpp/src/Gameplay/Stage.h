@@ -31,6 +31,7 @@
 #include "MapleMap/MapPortals.h"
 #include "MapleMap/MapReactors.h"
 #include "MapleMap/MapTilesObjs.h"
+#include "MapPreloader.h"
 #include "Physics/Physics.h"
 
 namespace ms {
@@ -40,9 +41,15 @@ public:
 
     void init();
 
+    // Start decoding the bitmaps and music of a map before it is loaded
+    void preload(int32_t mapid);
+
     // Loads the map to display
     void load(int32_t mapid, int8_t portalid);
 
+    // Return the time spent on each step of the last map load
+    const MapPreloader::Timings &get_load_timings() const;
+
     // Remove all map objects and graphics.
     void clear();
 
@@ -130,7 +137,7 @@ private:
 
     void check_drops();
 
-    enum State { INACTIVE, TRANSITION, ACTIVE };
+    enum State { INACTIVE, TRANSITION, LOADING, ACTIVE };
 
     Camera camera_;
     Physics physics_;
@@ -150,6 +157,7 @@ private:
     MapMobs mobs_;
     MapDrops drops_;
     MapEffect effect_;
+    MapPreloader preloader_;
 
     Combat combat_;
     MobCombat mob_combat_;
@@ -15,7 +15,9 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "Animation.h"
 
+#include <algorithm>
 #include <set>
+#include <unordered_map>
 
 #include "../Constants.h"
 #include "StringHandling.h"
@@ -104,7 +106,61 @@ float Frame::scalestep(uint16_t timestep) const {
            / delay_;
 }
 
-Animation::Animation(const nl::node &src) {
+namespace {
+std::unordered_map<size_t, std::weak_ptr<const AnimationData>> interned;
+size_t purge_threshold = 64;
+size_t intern_hits = 0;
+size_t bytes_saved = 0;
+
+// Drop entries whose animations have all been destroyed.
+void purge_expired() {
+    for (auto iter = interned.begin(); iter != interned.end();) {
+        if (iter->second.expired()) {
+            iter = interned.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    purge_threshold = std::max<size_t>(64, interned.size() * 2);
+}
+}  // namespace
+
+std::shared_ptr<const AnimationData> AnimationData::get(
+    const nl::node &src) {
+    auto &entry = interned[src.id()];
+
+    if (auto data = entry.lock()) {
+        intern_hits++;
+        bytes_saved += (data->last_frame() + 1) * sizeof(Frame);
+
+        return data;
+    }
+
+    auto data = std::make_shared<const AnimationData>(src);
+    entry = data;
+
+    if (interned.size() > purge_threshold) {
+        purge_expired();
+    }
+
+    return data;
+}
+
+AnimationData::Stats AnimationData::get_stats() {
+    Stats stats = { 0, 0, intern_hits, bytes_saved };
+
+    for (const auto &entry : interned) {
+        if (auto data = entry.second.lock()) {
+            stats.interned++;
+            stats.frames += data->last_frame() + 1;
+        }
+    }
+
+    return stats;
+}
+
+AnimationData::AnimationData(const nl::node &src) {
     bool istexture = src.data_type() == nl::node::type::bitmap;
 
     if (istexture) {
@@ -133,53 +189,53 @@ Animation::Animation(const nl::node &src) {
         }
     }
 
+    reach_ = 0;
+
+    for (const Frame &frame : frames_) {
+        reach_ = std::max(reach_, frame.get_bounds().reach());
+    }
+
     animated_ = frames_.size() > 1;
     zigzag_ = src["zigzag"].get_bool();
+}
 
-    reset();
+const Frame &AnimationData::get_frame(int16_t frame) const {
+    return frames_[frame];
 }
 
-Animation::Animation() : animated_(false), zigzag_(false) {
-    frames_.emplace_back();
-    reset();
+int16_t AnimationData::last_frame() const {
+    return static_cast<int16_t>(frames_.size() - 1);
 }
 
-void Animation::reset() {
-    frame_.set(0);
-    opacity_.set(frames_[0].start_opacity());
-    xyscale_.set(frames_[0].start_scale());
-    delay_ = frames_[0].get_delay();
-    frame_step_ = 1;
+bool AnimationData::is_animated() const {
+    return animated_;
 }
 
-void Animation::stop() {
-    auto lastframe = static_cast<int16_t>(frames_.size() - 1);
-    frame_.set(lastframe);
-    frame_step_ = -1;
+bool AnimationData::is_zigzag() const {
+    return zigzag_;
 }
 
-void Animation::draw(const DrawArgument &args, float alpha) const {
-    int16_t interframe = frame_.get(alpha);
-    float interopc = opacity_.get(alpha) / 255;
-    float interscale = xyscale_.get(alpha) / 100;
+int16_t AnimationData::get_reach() const {
+    return reach_;
+}
 
-    bool modifyopc = interopc != 1.0f;
-    bool modifyscale = interscale != 1.0f;
+void AnimationState::reset(const AnimationData &data) {
+    const Frame &first = data.get_frame(0);
 
-    if (modifyopc || modifyscale) {
-        frames_[interframe].draw(
-            args + DrawArgument(interscale, interscale, interopc));
-    } else {
-        frames_[interframe].draw(args);
-    }
+    frame_.set(0);
+    opacity_.set(first.start_opacity());
+    xyscale_.set(first.start_scale());
+    delay_ = first.get_delay();
+    frame_step_ = 1;
 }
 
-bool Animation::update() {
-    return update(Constants::TIMESTEP);
+void AnimationState::stop(const AnimationData &data) {
+    frame_.set(data.last_frame());
+    frame_step_ = -1;
 }
 
-bool Animation::update(uint16_t timestep) {
-    const Frame &framedata = get_frame();
+bool AnimationState::update(const AnimationData &data, uint16_t timestep) {
+    const Frame &framedata = data.get_frame(frame_.get());
 
     opacity_ += framedata.opcstep(timestep);
 
@@ -196,11 +252,11 @@ bool Animation::update(uint16_t timestep) {
     }
 
     if (timestep >= delay_) {
-        int16_t lastframe = static_cast<int16_t>(frames_.size() - 1);
+        int16_t lastframe = data.last_frame();
         int16_t nextframe = 0;
         bool ended = false;
 
-        if (zigzag_ && lastframe > 0) {
+        if (data.is_zigzag() && lastframe > 0) {
             if (frame_step_ == 1 && frame_ == lastframe) {
                 frame_step_ = -frame_step_;
                 ended = false;
@@ -224,14 +280,15 @@ bool Animation::update(uint16_t timestep) {
         float threshold = static_cast<float>(delta) / timestep;
         frame_.next(nextframe, threshold);
 
-        delay_ = frames_[nextframe].get_delay();
+        const Frame &next = data.get_frame(nextframe);
+        delay_ = next.get_delay();
 
         if (delay_ >= delta) {
             delay_ -= delta;
         }
 
-        opacity_.set(frames_[nextframe].start_opacity());
-        xyscale_.set(frames_[nextframe].start_scale());
+        opacity_.set(next.start_opacity());
+        xyscale_.set(next.start_scale());
 
         return ended;
     }
@@ -242,19 +299,78 @@ bool Animation::update(uint16_t timestep) {
     return false;
 }
 
+int16_t AnimationState::get_frame() const {
+    return frame_.get();
+}
+
+int16_t AnimationState::get_frame(float alpha) const {
+    return frame_.get(alpha);
+}
+
+float AnimationState::get_opacity(float alpha) const {
+    return opacity_.get(alpha) / 255;
+}
+
+float AnimationState::get_scale(float alpha) const {
+    return xyscale_.get(alpha) / 100;
+}
+
+Animation::Animation(const nl::node &src) : data_(AnimationData::get(src)) {
+    reset();
+}
+
+Animation::Animation() : Animation(nl::node()) {}
+
+void Animation::reset() {
+    state_.reset(*data_);
+}
+
+void Animation::stop() {
+    state_.stop(*data_);
+}
+
+void Animation::draw(const DrawArgument &args, float alpha) const {
+    int16_t interframe = state_.get_frame(alpha);
+    float interopc = state_.get_opacity(alpha);
+    float interscale = state_.get_scale(alpha);
+
+    bool modifyopc = interopc != 1.0f;
+    bool modifyscale = interscale != 1.0f;
+
+    const Frame &frame = data_->get_frame(interframe);
+
+    if (modifyopc || modifyscale) {
+        frame.draw(args + DrawArgument(interscale, interscale, interopc));
+    } else {
+        frame.draw(args);
+    }
+}
+
+bool Animation::update() {
+    return update(Constants::TIMESTEP);
+}
+
+bool Animation::update(uint16_t timestep) {
+    return state_.update(*data_, timestep);
+}
+
 uint16_t Animation::get_delay(int16_t frame_id) const {
-    return frame_id < frames_.size() ? frames_[frame_id].get_delay() : 0;
+    if (frame_id < 0 || frame_id > data_->last_frame()) {
+        return 0;
+    }
+
+    return data_->get_frame(frame_id).get_delay();
 }
 
 uint16_t Animation::getdelayuntil(int16_t frame_id) const {
     uint16_t total = 0;
 
     for (int i = 0; i < frame_id; i++) {
-        if (i >= frames_.size()) {
+        if (i > data_->last_frame()) {
             break;
         }
 
-        total += frames_[frame_id].get_delay();
+        total += data_->get_frame(frame_id).get_delay();
     }
 
     return total;
@@ -276,7 +392,11 @@ Rectangle<int16_t> Animation::get_bounds() const {
     return get_frame().get_bounds();
 }
 
+int16_t Animation::get_reach() const {
+    return data_->get_reach();
+}
+
 const Frame &Animation::get_frame() const {
-    return frames_[frame_.get()];
+    return data_->get_frame(state_.get_frame());
 }
 }  // namespace ms
\ No newline at end of file
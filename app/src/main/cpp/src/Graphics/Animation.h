@@ -15,6 +15,7 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "../Template/Interpolated.h"
@@ -58,7 +59,76 @@ private:
     Point<int16_t> head_;
 };
 
+// The frames of an animation. Immutable and shared between all animations
+// loaded from the same node.
+class AnimationData {
+public:
+    // Statistics about interned animation data
+    struct Stats {
+        // Number of distinct animations currently alive
+        size_t interned;
+        // Number of frames held by those animations
+        size_t frames;
+        // Number of loads which reused existing data
+        size_t hits;
+        // Bytes of frame data which did not have to be loaded again
+        size_t bytes_saved;
+    };
+
+    // Return the shared data for a node, loading it if necessary.
+    static std::shared_ptr<const AnimationData> get(const nl::node &src);
+
+    // Return statistics about interned data.
+    static Stats get_stats();
+
+    AnimationData(const nl::node &src);
+
+    const Frame &get_frame(int16_t frame) const;
+
+    int16_t last_frame() const;
+
+    bool is_animated() const;
+
+    bool is_zigzag() const;
+
+    // Return how far the bounds of any frame extend from the origin.
+    int16_t get_reach() const;
+
+private:
+    std::vector<Frame> frames_;
+    int16_t reach_;
+    bool animated_;
+    bool zigzag_;
+};
+
+// The playback position within an animation's frames.
+class AnimationState {
+public:
+    void reset(const AnimationData &data);
+
+    void stop(const AnimationData &data);
+
+    bool update(const AnimationData &data, uint16_t timestep);
+
+    int16_t get_frame() const;
+
+    int16_t get_frame(float alpha) const;
+
+    float get_opacity(float alpha) const;
+
+    float get_scale(float alpha) const;
+
+private:
+    Nominal<int16_t> frame_;
+    Linear<float> opacity_;
+    Linear<float> xyscale_;
+
+    uint16_t delay_;
+    int16_t frame_step_;
+};
+
 // Class which consists of multiple textures to make an Animation.
+// Copies share their frames and only duplicate the playback state.
 class Animation {
 public:
     Animation(const nl::node &source);
@@ -87,19 +157,13 @@ public:
 
     Rectangle<int16_t> get_bounds() const;
 
+    // Return how far the bounds of any frame extend from the origin.
+    int16_t get_reach() const;
+
 private:
     const Frame &get_frame() const;
 
-    std::vector<Frame> frames_;
-    bool animated_;
-    bool zigzag_;
-
-    Nominal<int16_t> frame_;
-    Linear<float> opacity_;
-    Linear<float> xyscale_;
-
-    uint16_t delay_;
-    int16_t frame_step_;
-    float opc_step_;
+    std::shared_ptr<const AnimationData> data_;
+    AnimationState state_;
 };
 }  // namespace ms
\ No newline at end of file
@@ -0,0 +1,230 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "BitmapDecoder.h"
+
+#include <algorithm>
+
+#include "../Timer.h"
+
+namespace ms {
+BitmapDecoder::BitmapDecoder() :
+        running_(false),
+        busy_(0),
+        bytes_in_flight_(0),
+        decode_time_(0) {}
+
+BitmapDecoder::~BitmapDecoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+
+    condition_.notify_all();
+
+    for (std::thread &worker : workers_) {
+        worker.join();
+    }
+}
+
+void BitmapDecoder::start() {
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+
+    // Leave a core for the render thread
+    size_t cores = std::thread::hardware_concurrency();
+    size_t count = std::clamp<size_t>(cores > 1 ? cores - 1 : 1, 1, 4);
+
+    for (size_t i = 0; i < count; i++) {
+        workers_.emplace_back(&BitmapDecoder::work, this);
+    }
+}
+
+void BitmapDecoder::decode(const nl::bitmap &bmp) {
+    if (!bmp || bmp.width() == 0 || bmp.height() == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        start();
+
+        if (!queued_.insert(bmp.id()).second) {
+            return;
+        }
+
+        jobs_.push_back(bmp);
+    }
+
+    condition_.notify_one();
+}
+
+void BitmapDecoder::decode(const std::vector<nl::bitmap> &bitmaps) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        start();
+
+        for (const nl::bitmap &bmp : bitmaps) {
+            if (!bmp || bmp.width() == 0 || bmp.height() == 0) {
+                continue;
+            }
+
+            if (queued_.insert(bmp.id()).second) {
+                jobs_.push_back(bmp);
+            }
+        }
+    }
+
+    condition_.notify_all();
+}
+
+bool BitmapDecoder::poll(Decoded &decoded) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (ready_.empty()) {
+            return false;
+        }
+
+        decoded = std::move(ready_.front());
+        ready_.pop_front();
+
+        queued_.erase(decoded.bitmap.id());
+        bytes_in_flight_ -= decoded.bitmap.length();
+    }
+
+    // Workers may be waiting for room below the cap
+    condition_.notify_all();
+
+    return true;
+}
+
+void BitmapDecoder::release(std::vector<uint8_t> &&pixels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (pool_.size() < MAX_POOLED) {
+        pool_.push_back(std::move(pixels));
+    }
+}
+
+size_t BitmapDecoder::get_pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return jobs_.size() + busy_;
+}
+
+size_t BitmapDecoder::get_ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return ready_.size();
+}
+
+size_t BitmapDecoder::get_bytes_in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return bytes_in_flight_;
+}
+
+int64_t BitmapDecoder::get_decode_time() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return decode_time_;
+}
+
+std::vector<uint8_t> BitmapDecoder::acquire(size_t length) {
+    // Called with the mutex held
+    std::vector<uint8_t> pixels;
+
+    auto iter = std::find_if(pool_.begin(), pool_.end(),
+                             [length](const std::vector<uint8_t> &buffer) {
+                                 return buffer.capacity() >= length;
+                             });
+
+    if (iter != pool_.end()) {
+        pixels = std::move(*iter);
+        pool_.erase(iter);
+    } else if (!pool_.empty()) {
+        pixels = std::move(pool_.back());
+        pool_.pop_back();
+    }
+
+    return pixels;
+}
+
+void BitmapDecoder::work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        condition_.wait(lock, [&]() {
+            if (!running_) {
+                return true;
+            }
+
+            if (jobs_.empty()) {
+                return false;
+            }
+
+            // A single bitmap may exceed the cap on its own, so it is only
+            // enforced while something else is in flight
+            size_t length = jobs_.front().length();
+
+            return bytes_in_flight_ == 0
+                   || bytes_in_flight_ + length <= MAX_BYTES_IN_FLIGHT;
+        });
+
+        if (!running_) {
+            return;
+        }
+
+        nl::bitmap bmp = jobs_.front();
+        jobs_.pop_front();
+
+        std::vector<uint8_t> pixels = acquire(bmp.length());
+        busy_++;
+        bytes_in_flight_ += bmp.length();
+
+        lock.unlock();
+
+        auto start = ContinuousTimer::get().start();
+
+        pixels.resize(bmp.length());
+        bool success = bmp.decode(pixels.data());
+
+        int64_t elapsed = ContinuousTimer::get().stop(start);
+
+        lock.lock();
+
+        busy_--;
+        decode_time_ += elapsed;
+
+        if (success) {
+            ready_.push_back({bmp, std::move(pixels)});
+        } else {
+            queued_.erase(bmp.id());
+            bytes_in_flight_ -= bmp.length();
+            condition_.notify_all();
+
+            if (pool_.size() < MAX_POOLED) {
+                pool_.push_back(std::move(pixels));
+            }
+        }
+    }
+}
+}  // namespace ms
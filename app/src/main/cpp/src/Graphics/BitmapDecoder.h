@@ -0,0 +1,92 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <nlnx/bitmap.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../Template/Singleton.h"
+
+namespace ms {
+// Decompresses bitmaps on a pool of worker threads so that the render thread
+// only has to upload the finished pixels
+class BitmapDecoder : public Singleton<BitmapDecoder> {
+public:
+    // Pixels of a bitmap which are ready to be uploaded
+    struct Decoded {
+        nl::bitmap bitmap;
+        std::vector<uint8_t> pixels;
+    };
+
+    BitmapDecoder();
+
+    ~BitmapDecoder() override;
+
+    // Queue a bitmap for decoding, bitmaps already queued are ignored
+    void decode(const nl::bitmap &bmp);
+
+    // Queue several bitmaps for decoding
+    void decode(const std::vector<nl::bitmap> &bitmaps);
+
+    // Take the next decoded bitmap, return false if none is ready
+    bool poll(Decoded &decoded);
+
+    // Return the pixel buffer of a decoded bitmap to the pool
+    void release(std::vector<uint8_t> &&pixels);
+
+    // Number of bitmaps queued or being decoded
+    size_t get_pending() const;
+
+    // Number of decoded bitmaps waiting to be uploaded
+    size_t get_ready() const;
+
+    // Bytes of pixels being decoded or waiting to be uploaded
+    size_t get_bytes_in_flight() const;
+
+    // Total microseconds the workers have spent decoding
+    int64_t get_decode_time() const;
+
+private:
+    void start();
+
+    void work();
+
+    std::vector<uint8_t> acquire(size_t length);
+
+    static const size_t MAX_POOLED = 32;
+    // Workers stop taking jobs while this many bytes are not yet uploaded
+    static const size_t MAX_BYTES_IN_FLIGHT = 32 * 1024 * 1024;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<std::thread> workers_;
+    bool running_;
+    size_t busy_;
+    size_t bytes_in_flight_;
+    int64_t decode_time_;
+
+    std::deque<nl::bitmap> jobs_;
+    std::deque<Decoded> ready_;
+    std::unordered_set<size_t> queued_;
+    std::vector<std::vector<uint8_t>> pool_;
+};
+}  // namespace ms
@@ -206,7 +206,7 @@ private:
     float xscale_;
     float yscale_;
     float angle_;
-    int16_t radius_;
+    int16_t radius_ = 0;
     Color color_;
 };
 }  // namespace ms
\ No newline at end of file
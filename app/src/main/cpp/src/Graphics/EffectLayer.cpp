@@ -60,4 +60,14 @@ void EffectLayer::add(const Animation &animation, const DrawArgument &args) {
 void EffectLayer::add(const Animation &animation) {
     add(animation, {}, 0, 1.0f);
 }
+
+size_t EffectLayer::size() const {
+    size_t count = 0;
+
+    for (const auto &effectlist : effects_) {
+        count += effectlist.second.size();
+    }
+
+    return count;
+}
 }  // namespace ms
\ No newline at end of file
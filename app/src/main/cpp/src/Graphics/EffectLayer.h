@@ -43,6 +43,9 @@ public:
 
     void add(const Animation &effect);
 
+    // Return the number of effects which are still playing.
+    size_t size() const;
+
 private:
     class Effect {
     public:
@@ -15,13 +15,30 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "GraphicsGL.h"
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #include "../Configuration.h"
+#include "../Timer.h"
+#include "BitmapDecoder.h"
 #include "Window.h"
 
 namespace ms {
-    GraphicsGL::GraphicsGL() : locked_(false) {
+    GraphicsGL::GraphicsGL() :
+            locked_(false),
+            VBO_(0),
+            quad_IBO_(0),
+            circle_IBO_(0),
+            segment_(0),
+            segment_capacity_(0),
+            quad_index_capacity_(0),
+            circle_index_capacity_(0),
+            fences_(),
+            active_page_(0),
+            frame_(0),
+            scene_frame_(0),
+            upload_budget_(2000),
+            upload_time_(0) {
         VWIDTH = Constants::Constants::get().get_viewwidth();
         VHEIGHT = Constants::Constants::get().get_viewheight();
         SCREEN = Rectangle<int16_t>(0, VWIDTH, 0, VHEIGHT);
@@ -175,6 +192,10 @@ namespace ms {
         // Vertex Buffer Object
         glGenBuffers(1, &VBO_);
 
+        // Index Buffer Objects, filled once with the quad and circle patterns
+        glGenBuffers(1, &quad_IBO_);
+        glGenBuffers(1, &circle_IBO_);
+
         glGenTextures(1, &atlas_);
         glBindTexture(GL_TEXTURE_2D, atlas_);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -215,23 +236,6 @@ namespace ms {
 
         font_ymax += font_border.y();
 
-        leftovers_ = QuadTree<size_t, Leftover>(
-                [](const Leftover &first, const Leftover &second) {
-                    bool width_comparison = first.width() >= second.width();
-                    bool height_comparison = first.height() >= second.height();
-
-                    if (width_comparison && height_comparison) {
-                        return QuadTree<size_t, Leftover>::Direction::RIGHT;
-                    }
-                    if (width_comparison) {
-                        return QuadTree<size_t, Leftover>::Direction::DOWN;
-                    }
-                    if (height_comparison) {
-                        return QuadTree<size_t, Leftover>::Direction::UP;
-                    }
-                    return QuadTree<size_t, Leftover>::Direction::LEFT;
-                });
-
         return Error::Code::NONE;
     }
 
@@ -397,26 +401,147 @@ namespace ms {
     }
 
     void GraphicsGL::clear_internal() {
-        border_ = Point<GLshort>(0, font_ymax);
-        y_range_ = Range<GLshort>();
+        for (size_t i = 0; i < NUM_PAGES; i++) {
+            reset_page(i);
+        }
 
         offsets_.clear();
-        leftovers_.clear();
-        rlid_ = 1;
-        wasted_ = 0;
+        images_.clear();
+        active_page_ = 0;
+    }
+
+    void GraphicsGL::reset_page(size_t index) {
+        GLshort page_height = (ATLASH - font_ymax) / NUM_PAGES;
+
+        AtlasPage &page = pages_[index];
+        page.top = font_ymax + static_cast<GLshort>(index) * page_height;
+        page.bottom = page.top + page_height;
+        page.packer = SkylinePacker(ATLASW, page_height);
+        page.last_used = 0;
+        page.bitmaps.clear();
+        page.images.clear();
+    }
+
+    void GraphicsGL::evict_page(size_t index) {
+        AtlasPage &page = pages_[index];
+
+        for (size_t id: page.bitmaps) {
+            offsets_.erase(id);
+        }
+
+        for (uint64_t id: page.images) {
+            images_.erase(id);
+        }
+
+        size_t evictions = page.evictions;
+
+        reset_page(index);
+
+        pages_[index].evictions = evictions + 1;
+    }
+
+    size_t GraphicsGL::find_cold_page() const {
+        size_t coldest = NUM_PAGES;
+
+        for (size_t i = 0; i < NUM_PAGES; i++) {
+            const AtlasPage &page = pages_[i];
+
+            // A page holding only images can still be in use by the scene
+            if (page.bitmaps.empty() && page.images.empty()) {
+                return i;
+            }
+
+            // Pages referenced by the scene being shown must stay resident,
+            // including a scene kept from an earlier frame by lock()
+            if (page.last_used >= scene_frame_) {
+                continue;
+            }
+
+            if (coldest == NUM_PAGES || page.last_used < pages_[coldest].last_used) {
+                coldest = i;
+            }
+        }
+
+        return coldest;
     }
 
     void GraphicsGL::clear() {
-        size_t used = ATLASW * border_.y() + border_.x() * y_range_.second();
-        double usedpercent = static_cast<double>(used) / (ATLASW * ATLASH);
+        size_t used = 0;
+
+        for (const AtlasPage &page: pages_) {
+            used += page.packer.get_used() + page.packer.get_wasted();
+        }
 
-        if (usedpercent > 80.0) {
-            clear_internal();
+        double usedpercent = static_cast<double>(used) / (ATLASW * (ATLASH - font_ymax));
+
+        if (usedpercent > 0.8) {
+            size_t coldest = find_cold_page();
+
+            if (coldest < NUM_PAGES) {
+                evict_page(coldest);
+                active_page_ = coldest;
+            }
         }
     }
 
+    std::vector<GraphicsGL::AtlasStats> GraphicsGL::get_atlas_stats() const {
+        std::vector<AtlasStats> stats;
+
+        for (const AtlasPage &page: pages_) {
+            AtlasStats page_stats;
+            page_stats.bitmaps = page.bitmaps.size();
+            page_stats.used = page.packer.get_used();
+            page_stats.wasted = page.packer.get_wasted();
+            page_stats.evictions = page.evictions;
+            page_stats.last_used = page.last_used;
+
+            stats.push_back(page_stats);
+        }
+
+        return stats;
+    }
+
     void GraphicsGL::add_bitmap(const nl::bitmap &bmp) {
-        get_offset(bmp);
+        if (offsets_.count(bmp.id())) {
+            return;
+        }
+
+        BitmapDecoder::get().decode(bmp);
+    }
+
+    void GraphicsGL::set_upload_budget(int64_t microseconds) {
+        upload_budget_ = microseconds;
+    }
+
+    void GraphicsGL::upload_decoded() {
+        BitmapDecoder &decoder = BitmapDecoder::get();
+        BitmapDecoder::Decoded decoded;
+
+        auto start = ContinuousTimer::get().start();
+
+        while (ContinuousTimer::get().stop(start) < upload_budget_ && decoder.poll(decoded)) {
+            // Bitmaps drawn before their decode finished are already resident
+            if (!offsets_.count(decoded.bitmap.id())) {
+                allocate(decoded.bitmap, decoded.pixels.data());
+                stats_.decoded_uploads++;
+            }
+
+            decoder.release(std::move(decoded.pixels));
+        }
+
+        upload_time_ += ContinuousTimer::get().stop(start);
+    }
+
+    bool GraphicsGL::is_resident(const nl::bitmap &bmp) const {
+        if (bmp.width() > ATLASW || bmp.height() > pages_[0].bottom - pages_[0].top) {
+            return true;
+        }
+
+        return offsets_.count(bmp.id()) > 0;
+    }
+
+    int64_t GraphicsGL::get_upload_time() const {
+        return upload_time_;
     }
 
     const GraphicsGL::Offset &GraphicsGL::get_offset(const nl::bitmap &bmp) {
@@ -424,9 +549,18 @@ namespace ms {
         auto offiter = offsets_.find(id);
 
         if (offiter != offsets_.end()) {
-            return offiter->second;
+            Allocation &allocation = offiter->second;
+            allocation.last_used = frame_;
+            pages_[allocation.page].last_used = frame_;
+
+            return allocation.offset;
         }
 
+        return allocate(bmp, bmp.data());
+    }
+
+    const GraphicsGL::Offset &GraphicsGL::allocate(const nl::bitmap &bmp, const void *pixels) {
+        size_t id = bmp.id();
         GLshort x = 0;
         GLshort y = 0;
         GLshort width = bmp.width();
@@ -436,108 +570,60 @@ namespace ms {
             return null_offset_;
         }
 
-        Leftover value = Leftover(x, y, width, height);
+        size_t page_index = upload(width, height, pixels, x, y);
 
-        size_t lid = leftovers_.findnode(
-                value,
-                [](const Leftover &val, const Leftover &leaf) {
-                    return val.width() <= leaf.width() && val.height() <= leaf.height();
-                });
+        if (page_index == NUM_PAGES) {
+            std::cerr << "Error: Bitmap " << width << "x" << height
+                      << " does not fit into an atlas page." << std::endl;
 
-        if (lid > 0) {
-            const Leftover &leftover = leftovers_[lid];
-
-            x = leftover.left;
-            y = leftover.top;
+            return null_offset_;
+        }
 
-            GLshort width_delta = leftover.width() - width;
-            GLshort height_delta = leftover.height() - height;
+        AtlasPage &page = pages_[page_index];
+        page.bitmaps.push_back(id);
 
-            leftovers_.erase(lid);
+        return offsets_
+                .emplace(std::piecewise_construct,
+                         std::forward_as_tuple(id),
+                         std::forward_as_tuple(Allocation{Offset(x, y, width, height), page_index, frame_}))
+                .first->second.offset;
+    }
 
-            wasted_ -= width * height;
+    size_t GraphicsGL::upload(GLshort width,
+                              GLshort height,
+                              const void *pixels,
+                              GLshort &x,
+                              GLshort &y) {
+        if (width > ATLASW || height > pages_[0].bottom - pages_[0].top) {
+            return NUM_PAGES;
+        }
 
-            if (width_delta >= MINLOSIZE && height_delta >= MINLOSIZE) {
-                leftovers_.add(
-                        rlid_,
-                        Leftover(x + width, y + height, width_delta, height_delta));
-                rlid_++;
+        // Fill the active page first, then recycle an empty or cold one
+        size_t page_index = active_page_;
 
-                if (width >= MINLOSIZE) {
-                    leftovers_.add(rlid_,
-                                   Leftover(x, y + height, width, height_delta));
-                    rlid_++;
-                }
+        if (!place(pages_[page_index], width, height, x, y)) {
+            page_index = find_cold_page();
 
-                if (height >= MINLOSIZE) {
-                    leftovers_.add(rlid_,
-                                   Leftover(x + width, y, width_delta, height));
-                    rlid_++;
-                }
-            } else if (width_delta >= MINLOSIZE) {
-                leftovers_.add(
-                        rlid_,
-                        Leftover(x + width, y, width_delta, height + height_delta));
-                rlid_++;
-            } else if (height_delta >= MINLOSIZE) {
-                leftovers_.add(
-                        rlid_,
-                        Leftover(x, y + height, width + width_delta, height_delta));
-                rlid_++;
-            }
-        } else {
-            if (border_.x() + width > ATLASW) {
-                border_.set_x(0);
-                border_.shift_y(y_range_.second());
+            if (page_index < NUM_PAGES) {
+                const AtlasPage &page = pages_[page_index];
 
-                if (border_.y() + height > ATLASH) {
-                    clear_internal();
-                } else {
-                    y_range_ = Range<GLshort>();
+                // A page that holds nothing yet has nothing to evict
+                if (!page.bitmaps.empty() || !page.images.empty()) {
+                    evict_page(page_index);
                 }
+            } else {
+                // Every page is in use by the current frame
+                clear_internal();
+                page_index = 0;
             }
 
-            x = border_.x();
-            y = border_.y();
-
-            border_.shift_x(width);
-
-            if (height > y_range_.second()) {
-                if (x >= MINLOSIZE && height - y_range_.second() >= MINLOSIZE) {
-                    leftovers_.add(rlid_,
-                                   Leftover(0,
-                                            y_range_.first(),
-                                            x,
-                                            height - y_range_.second()));
-                    rlid_++;
-                }
-
-                wasted_ += x * (height - y_range_.second());
-
-                y_range_ = Range<int16_t>(y + height, height);
-            } else if (height < y_range_.first() - y) {
-                if (width >= MINLOSIZE
-                    && y_range_.first() - y - height >= MINLOSIZE) {
-                    leftovers_.add(rlid_,
-                                   Leftover(x,
-                                            y + height,
-                                            width,
-                                            y_range_.first() - y - height));
-                    rlid_++;
-                }
+            active_page_ = page_index;
 
-                wasted_ += width * (y_range_.first() - y - height);
+            if (!place(pages_[page_index], width, height, x, y)) {
+                return NUM_PAGES;
             }
         }
 
-        // size_t used = ATLASW * border.y() + border.x() * yrange.second();
-        //
-        // double usedpercent = static_cast<double>(used) / (ATLASW * ATLASH);
-        // double wastedpercent = static_cast<double>(wasted) / used;
-        //
-        // std::cout << "Used: [" << usedpercent << "] Wasted: [" << wastedpercent
-        // << "]" << std::endl;
-
         glTexSubImage2D(GL_TEXTURE_2D,
                         0,
                         x,
@@ -546,13 +632,26 @@ namespace ms {
                         height,
                         GL_RGBA,
                         GL_UNSIGNED_BYTE,
-                        bmp.data());
+                        pixels);
 
-        return offsets_
-                .emplace(std::piecewise_construct,
-                         std::forward_as_tuple(id),
-                         std::forward_as_tuple(x, y, width, height))
-                .first->second;
+        stats_.texture_bytes += 4u * width * height;
+        pages_[page_index].last_used = frame_;
+
+        return page_index;
+    }
+
+    bool GraphicsGL::place(AtlasPage &page,
+                           GLshort width,
+                           GLshort height,
+                           GLshort &x,
+                           GLshort &y) {
+        if (!page.packer.insert(width, height, x, y)) {
+            return false;
+        }
+
+        y += page.top;
+
+        return true;
     }
 
     void GraphicsGL::draw(const nl::bitmap &bmp,
@@ -580,6 +679,58 @@ namespace ms {
                             angle);
     }
 
+    bool GraphicsGL::add_image(uint64_t id, int16_t width, int16_t height, const void *pixels) {
+        if (width <= 0 || height <= 0) {
+            return false;
+        }
+
+        GLshort x = 0;
+        GLshort y = 0;
+        size_t page_index = upload(width, height, pixels, x, y);
+
+        if (page_index == NUM_PAGES) {
+            return false;
+        }
+
+        pages_[page_index].images.push_back(id);
+        images_[id] = Allocation{Offset(x, y, width, height), page_index, frame_};
+
+        return true;
+    }
+
+    bool GraphicsGL::draw_image(uint64_t id,
+                                const Rectangle<int16_t> &rect,
+                                const Color &color,
+                                float angle) {
+        auto iter = images_.find(id);
+
+        if (iter == images_.end()) {
+            return false;
+        }
+
+        if (locked_ || color.invisible() || !rect.overlaps(SCREEN)) {
+            return true;
+        }
+
+        Allocation &allocation = iter->second;
+        allocation.last_used = frame_;
+        pages_[allocation.page].last_used = frame_;
+
+        quads_.emplace_back(rect.left(),
+                            rect.right(),
+                            rect.top(),
+                            rect.bottom(),
+                            allocation.offset,
+                            color,
+                            angle);
+
+        return true;
+    }
+
+    void GraphicsGL::remove_image(uint64_t id) {
+        images_.erase(id);
+    }
+
 // Text::Layout GraphicsGL::create_layout(const std::string &text,
 //                                        Text::Font id,
 //                                        Text::Alignment alignment,
@@ -1289,51 +1440,186 @@ namespace ms {
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        std::vector<Quad::Vertex> triangles;
-        std::vector<Circle::Vertex> circles;
-        for (const Quad &quad: quads_) {
-            triangles.push_back(quad.vertices[0]);
-            triangles.push_back(quad.vertices[1]);
-            triangles.push_back(quad.vertices[2]);
-
-            triangles.push_back(quad.vertices[0]);
-            triangles.push_back(quad.vertices[2]);
-            triangles.push_back(quad.vertices[3]);
-        }
-
-        for (const Circle &circle: circles_) {
-            for (int i = 0; i < Circle::NUM_SEGMENTS; i++) {
-                circles.push_back(circle.vertices[i]);
-            }
-        }
+        GLint base_vertex = upload_vertices();
 
         glEnableVertexAttribArray(attribute_coord_);
         glEnableVertexAttribArray(attribute_color_);
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-        glBufferData(GL_ARRAY_BUFFER, triangles.size() * sizeof(Quad::Vertex), triangles.data(),
-                     GL_STREAM_DRAW);
-        glDrawArrays(GL_TRIANGLES, 0, triangles.size());
+        if (!quads_.empty()) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_IBO_);
+            glDrawElementsBaseVertex(GL_TRIANGLES,
+                                     static_cast<GLsizei>(quads_.size() * 6),
+                                     GL_UNSIGNED_INT,
+                                     nullptr,
+                                     base_vertex);
+            stats_.draw_calls++;
+        }
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-        glBufferData(GL_ARRAY_BUFFER, circles.size() * sizeof(Circle::Vertex), circles.data(),
-                     GL_STREAM_DRAW);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, circles.size());
+        if (!circles_.empty()) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, circle_IBO_);
+            glDrawElementsBaseVertex(GL_TRIANGLES,
+                                     static_cast<GLsizei>(circles_.size() * Circle::NUM_INDICES),
+                                     GL_UNSIGNED_INT,
+                                     nullptr,
+                                     base_vertex + static_cast<GLint>(quads_.size() * Quad::LENGTH));
+            stats_.draw_calls++;
+        }
 
         glDisableVertexAttribArray(attribute_coord_);
         glDisableVertexAttribArray(attribute_color_);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+        // Fence the segment so it is not overwritten while the GPU still reads it
+        fences_[segment_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        segment_ = (segment_ + 1) % NUM_SEGMENTS;
+
+        stats_.quads = quads_.size();
+        stats_.circles = circles_.size();
+        last_stats_ = stats_;
+        stats_ = FrameStats();
+        frame_++;
+
         if (coverscene) {
             quads_.pop_back();
             circles_.pop_back();
         }
     }
 
+    void GraphicsGL::reserve_buffers(size_t num_quads, size_t num_circles) {
+        size_t num_vertices = num_quads * Quad::LENGTH + num_circles * Circle::NUM_SEGMENTS;
+
+        if (num_vertices > segment_capacity_) {
+            segment_capacity_ = std::max<size_t>(num_vertices, segment_capacity_ * 2);
+            segment_capacity_ = std::max<size_t>(segment_capacity_, 4096);
+
+            // Reallocating orphans the old storage, so pending fences are moot
+            for (GLsync &fence: fences_) {
+                if (fence) {
+                    glDeleteSync(fence);
+                    fence = nullptr;
+                }
+            }
+
+            segment_ = 0;
+
+            glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+            glBufferData(GL_ARRAY_BUFFER,
+                         NUM_SEGMENTS * segment_capacity_ * sizeof(Quad::Vertex),
+                         nullptr,
+                         GL_DYNAMIC_DRAW);
+        }
+
+        if (num_quads > quad_index_capacity_) {
+            quad_index_capacity_ = std::max<size_t>(num_quads, quad_index_capacity_ * 2);
+
+            std::vector<GLuint> indices;
+            indices.reserve(quad_index_capacity_ * 6);
+
+            for (GLuint i = 0; i < quad_index_capacity_; i++) {
+                GLuint first = i * Quad::LENGTH;
+
+                indices.push_back(first);
+                indices.push_back(first + 1);
+                indices.push_back(first + 2);
+
+                indices.push_back(first);
+                indices.push_back(first + 2);
+                indices.push_back(first + 3);
+            }
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_IBO_);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                         indices.size() * sizeof(GLuint),
+                         indices.data(),
+                         GL_STATIC_DRAW);
+        }
+
+        if (num_circles > circle_index_capacity_) {
+            circle_index_capacity_ = std::max<size_t>(num_circles, circle_index_capacity_ * 2);
+
+            std::vector<GLuint> indices;
+            indices.reserve(circle_index_capacity_ * Circle::NUM_INDICES);
+
+            // Each circle is a fan around its first vertex
+            for (GLuint i = 0; i < circle_index_capacity_; i++) {
+                GLuint first = i * Circle::NUM_SEGMENTS;
+
+                for (GLuint j = 1; j + 1 < Circle::NUM_SEGMENTS; j++) {
+                    indices.push_back(first);
+                    indices.push_back(first + j);
+                    indices.push_back(first + j + 1);
+                }
+            }
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, circle_IBO_);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                         indices.size() * sizeof(GLuint),
+                         indices.data(),
+                         GL_STATIC_DRAW);
+        }
+    }
+
+    GLint GraphicsGL::upload_vertices() {
+        reserve_buffers(quads_.size(), circles_.size());
+
+        size_t quad_bytes = quads_.size() * sizeof(Quad);
+        size_t circle_bytes = circles_.size() * sizeof(Circle);
+        size_t total_bytes = quad_bytes + circle_bytes;
+
+        GLint base_vertex = static_cast<GLint>(segment_ * segment_capacity_);
+        GLsync &fence = fences_[segment_];
+
+        if (fence) {
+            // Only blocks if the GPU is more than NUM_SEGMENTS frames behind
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        if (total_bytes == 0) {
+            return base_vertex;
+        }
+
+        GLintptr offset = base_vertex * sizeof(Quad::Vertex);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+
+        void *mapped = glMapBufferRange(GL_ARRAY_BUFFER,
+                                        offset,
+                                        total_bytes,
+                                        GL_MAP_WRITE_BIT
+                                        | GL_MAP_INVALIDATE_RANGE_BIT
+                                        | GL_MAP_UNSYNCHRONIZED_BIT);
+
+        if (mapped) {
+            auto *dest = static_cast<char *>(mapped);
+
+            std::memcpy(dest, quads_.data(), quad_bytes);
+            std::memcpy(dest + quad_bytes, circles_.data(), circle_bytes);
+
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, offset, quad_bytes, quads_.data());
+            glBufferSubData(GL_ARRAY_BUFFER, offset + quad_bytes, circle_bytes, circles_.data());
+        }
+
+        stats_.vertex_bytes += total_bytes;
+
+        return base_vertex;
+    }
+
+    const GraphicsGL::FrameStats &GraphicsGL::get_frame_stats() const {
+        return last_stats_;
+    }
+
     void GraphicsGL::clear_scene() {
         if (!locked_) {
+            scene_frame_ = frame_;
             quads_.clear();
             circles_.clear();
         }
+
+        upload_decoded();
     }
 }  // namespace ms
\ No newline at end of file
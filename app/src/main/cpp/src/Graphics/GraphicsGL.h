@@ -20,9 +20,11 @@
 #include "GLES3/gl32.h"
 #include <nlnx/bitmap.hpp>
 
+#include <unordered_map>
+
 #include "../Constants.h"
 #include "../Error.h"
-#include "../Util/QuadTree.h"
+#include "../Util/RectanglePacker.h"
 #include "Text.h"
 #include "glfm.h"
 
@@ -38,18 +40,41 @@ namespace ms {
         // Re-initialise after changing screen modes.
         void reinit();
 
-        // Clear all bitmaps if most of the space is used up
+        // Recycle the least recently used atlas page if most of the space is used up
         void clear();
 
         // Add a bitmap to the available resources.
+        // The bitmap is decoded in the background and uploaded within the frame budget.
         void add_bitmap(const nl::bitmap &bmp);
 
+        // Set how many microseconds per frame may be spent uploading decoded bitmaps
+        void set_upload_budget(int64_t microseconds);
+
+        // Return true if the bitmap is in the atlas or can never be placed there
+        bool is_resident(const nl::bitmap &bmp) const;
+
+        // Total microseconds spent uploading decoded bitmaps
+        int64_t get_upload_time() const;
+
         // Draw the bitmap with the given parameters.
         void draw(const nl::bitmap &bmp,
                   const Rectangle<int16_t> &rect,
                   const Color &color,
                   float angle);
 
+        // Upload RGBA pixels which were composed on the CPU. Images have their own ids,
+        // chosen by the caller. Returns false if the image does not fit into a page.
+        bool add_image(uint64_t id, int16_t width, int16_t height, const void *pixels);
+
+        // Draw an image added with add_image. Returns false if it has been evicted since.
+        bool draw_image(uint64_t id,
+                        const Rectangle<int16_t> &rect,
+                        const Color &color,
+                        float angle);
+
+        // Forget an image, its space is reclaimed when its page is recycled
+        void remove_image(uint64_t id);
+
         // Create a layout for the text with the parameters specified.
         // Text::Layout create_layout(const std::string &text,
         //                            Text::Font font,
@@ -116,6 +141,31 @@ namespace ms {
         // Clear the buffer contents.
         void clear_scene();
 
+        // Counters for the most recently flushed frame
+        struct FrameStats {
+            size_t quads = 0;
+            size_t circles = 0;
+            size_t draw_calls = 0;
+            size_t vertex_bytes = 0;
+            size_t texture_bytes = 0;
+            size_t decoded_uploads = 0;
+        };
+
+        // Return the counters of the last flushed frame
+        const FrameStats &get_frame_stats() const;
+
+        // Occupancy counters for one page of the bitmap atlas
+        struct AtlasStats {
+            size_t bitmaps = 0;
+            size_t used = 0;
+            size_t wasted = 0;
+            size_t evictions = 0;
+            uint64_t last_used = 0;
+        };
+
+        // Return the counters of every atlas page
+        std::vector<AtlasStats> get_atlas_stats() const;
+
     private:
         void clear_internal();
 
@@ -143,30 +193,43 @@ namespace ms {
         // Add a bitmap to the available resources.
         const Offset &get_offset(const nl::bitmap &bmp);
 
-        struct Leftover {
-            GLshort left;
-            GLshort right;
-            GLshort top;
-            GLshort bottom;
+        // Place a bitmap in the atlas and upload its decompressed pixels
+        const Offset &allocate(const nl::bitmap &bmp, const void *pixels);
+
+        // Find space for pixels, recycling a page if needed, and upload them.
+        // Returns the page or NUM_PAGES if the pixels are too large.
+        size_t upload(GLshort width, GLshort height, const void *pixels, GLshort &x, GLshort &y);
+
+        // Upload bitmaps finished by the decoder until the budget is spent
+        void upload_decoded();
+
+        // A horizontal band of the atlas which is filled and recycled as a whole
+        struct AtlasPage {
+            GLshort top = 0;
+            GLshort bottom = 0;
+            SkylinePacker packer;
+            size_t evictions = 0;
+            uint64_t last_used = 0;
+            std::vector<size_t> bitmaps;
+            std::vector<uint64_t> images;
+        };
 
-            Leftover(GLshort x, GLshort y, GLshort width, GLshort height) {
-                left = x;
-                right = x + width;
-                top = y;
-                bottom = y + height;
-            }
+        // Where a bitmap lives in the atlas and when it was last drawn
+        struct Allocation {
+            Offset offset;
+            size_t page;
+            uint64_t last_used;
+        };
 
-            Leftover() {
-                left = 0;
-                right = 0;
-                top = 0;
-                bottom = 0;
-            }
+        void reset_page(size_t page);
 
-            GLshort width() const { return right - left; }
+        void evict_page(size_t page);
 
-            GLshort height() const { return bottom - top; }
-        };
+        // Find a page which may be recycled, or return NUM_PAGES
+        size_t find_cold_page() const;
+
+        // Place a bitmap on the page and return its atlas position
+        bool place(AtlasPage &page, GLshort width, GLshort height, GLshort &x, GLshort &y);
 
         struct Quad {
             struct Vertex {
@@ -218,6 +281,9 @@ namespace ms {
             }
         };
 
+        static_assert(sizeof(Quad) == Quad::LENGTH * sizeof(Quad::Vertex),
+                      "Quads are uploaded as a flat vertex array");
+
         struct Circle {
             struct Vertex {
                 // Local Space Position
@@ -232,6 +298,7 @@ namespace ms {
             };
 
             static const size_t NUM_SEGMENTS = 30; // Number of segments to approximate the circle
+            static const size_t NUM_INDICES = (NUM_SEGMENTS - 2) * 3;
             Vertex vertices[NUM_SEGMENTS];
 
             Circle(GLshort center_x, GLshort center_y, GLshort radius, const Color &color) {
@@ -252,6 +319,15 @@ namespace ms {
             }
         };
 
+        static_assert(sizeof(Circle) == Circle::NUM_SEGMENTS * sizeof(Quad::Vertex),
+                      "Circles share the quad vertex layout");
+
+        // Grow the vertex ring and the static index buffers to fit the scene
+        void reserve_buffers(size_t num_quads, size_t num_circles);
+
+        // Write the scene into the next ring segment and return its first vertex
+        GLint upload_vertices();
+
         struct Font {
             struct Char {
                 GLshort ax;
@@ -326,15 +402,29 @@ namespace ms {
 
         static const GLshort ATLASW = 8192;
         static const GLshort ATLASH = 8192;
-        static const GLshort MINLOSIZE = 32;
+        static const size_t NUM_PAGES = 4;
+
+        // Number of frames the vertex ring can have in flight
+        static const size_t NUM_SEGMENTS = 3;
 
         bool locked_;
 
         std::vector<Quad> quads_;
         std::vector<Circle> circles_;
         GLuint VBO_;
+        GLuint quad_IBO_;
+        GLuint circle_IBO_;
         GLuint atlas_;
 
+        size_t segment_;
+        size_t segment_capacity_;
+        size_t quad_index_capacity_;
+        size_t circle_index_capacity_;
+        GLsync fences_[NUM_SEGMENTS];
+
+        FrameStats stats_;
+        FrameStats last_stats_;
+
         GLint shader_program_;
         GLint attribute_coord_;
         GLint attribute_color_;
@@ -344,14 +434,16 @@ namespace ms {
         GLint uniform_yoffset;
         GLint uniform_font_region_;
 
-        std::unordered_map<size_t, Offset> offsets_;
+        std::unordered_map<size_t, Allocation> offsets_;
+        std::unordered_map<uint64_t, Allocation> images_;
         Offset null_offset_;
 
-        QuadTree<size_t, Leftover> leftovers_;
-        size_t rlid_;
-        size_t wasted_;
-        Point<GLshort> border_;
-        Range<GLshort> y_range_;
+        AtlasPage pages_[NUM_PAGES];
+        size_t active_page_;
+        uint64_t frame_;
+        uint64_t scene_frame_;
+        int64_t upload_budget_;
+        int64_t upload_time_;
 
         FT_Library ft_library_;
         Font fonts_[Text::Font::NUM_FONTS];
@@ -41,25 +41,73 @@ void RecurringEffect::update() {
     }
 }
 
-void RecurringEffect::add(const Animation &animation,
+void RecurringEffect::add(int32_t id,
+                          const Animation &animation,
                           const DrawArgument &args,
                           int8_t z,
                           float speed) {
-    effects_[z].emplace_back(animation, args, speed);
+    remove(id);
+
+    effects_[z].emplace_back(id, animation, args, speed);
 }
 
-void RecurringEffect::add(const Animation &animation,
+void RecurringEffect::add(int32_t id,
+                          const Animation &animation,
                           const DrawArgument &args,
                           int8_t z) {
-    add(animation, args, z, 1.0f);
+    add(id, animation, args, z, 1.0f);
 }
 
-void RecurringEffect::add(const Animation &animation,
+void RecurringEffect::add(int32_t id,
+                          const Animation &animation,
                           const DrawArgument &args) {
-    add(animation, args, 0, 1.0f);
+    add(id, animation, args, 0, 1.0f);
+}
+
+void RecurringEffect::add(int32_t id, const Animation &animation) {
+    add(id, animation, {}, 0, 1.0f);
+}
+
+void RecurringEffect::remove(int32_t id) {
+    for (auto iter = effects_.begin(); iter != effects_.end();) {
+        iter->second.remove_if(
+            [id](const Effect &effect) { return effect.get_id() == id; });
+
+        if (iter->second.empty()) {
+            iter = effects_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void RecurringEffect::clear() {
+    effects_.clear();
+}
+
+bool RecurringEffect::contains(int32_t id) const {
+    for (const auto &effectlist : effects_) {
+        for (const auto &effect : effectlist.second) {
+            if (effect.get_id() == id) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+size_t RecurringEffect::size() const {
+    size_t count = 0;
+
+    for (const auto &effectlist : effects_) {
+        count += effectlist.second.size();
+    }
+
+    return count;
 }
 
-void RecurringEffect::add(const Animation &animation) {
-    add(animation, {}, 0, 1.0f);
+bool RecurringEffect::empty() const {
+    return effects_.empty();
 }
 }  // namespace ms
\ No newline at end of file
@@ -22,6 +22,8 @@
 #include "Sprite.h"
 
 namespace ms {
+// A set of looping animations, e.g. for active buffs. Each animation has an id
+// so that it is only shown once, and can be removed when the buff ends.
 class RecurringEffect {
 public:
     void drawbelow(Point<int16_t> position, float alpha) const;
@@ -30,23 +32,47 @@ public:
 
     void update();
 
-    void add(const Animation &effect,
+    // Show an animation, replacing the one with the same id.
+    void add(int32_t id,
+             const Animation &effect,
              const DrawArgument &args,
              int8_t z,
              float speed);
 
-    void add(const Animation &effect, const DrawArgument &args, int8_t z);
+    void add(int32_t id,
+             const Animation &effect,
+             const DrawArgument &args,
+             int8_t z);
+
+    void add(int32_t id, const Animation &effect, const DrawArgument &args);
+
+    void add(int32_t id, const Animation &effect);
+
+    // Remove the animation with the given id.
+    void remove(int32_t id);
 
-    void add(const Animation &effect, const DrawArgument &args);
+    // Remove all animations.
+    void clear();
 
-    void add(const Animation &effect);
+    // Check whether an animation with the given id is shown.
+    bool contains(int32_t id) const;
+
+    // Return the number of animations shown.
+    size_t size() const;
+
+    // Return if no animations are shown.
+    bool empty() const;
 
 private:
     class Effect {
     public:
-        Effect(const Animation &a, const DrawArgument &args, float s) :
+        Effect(int32_t id,
+               const Animation &a,
+               const DrawArgument &args,
+               float s) :
             sprite_(a, args),
-            speed_(s) {}
+            speed_(s),
+            id_(id) {}
 
         void draw(Point<int16_t> position, float alpha) const {
             sprite_.draw(position, alpha);
@@ -63,9 +89,12 @@ private:
             return ended;
         }
 
+        int32_t get_id() const { return id_; }
+
     private:
         Sprite sprite_;
         float speed_;
+        int32_t id_;
     };
 
     std::map<int8_t, std::list<Effect>> effects_;
@@ -96,6 +96,10 @@ Point<int16_t> Texture::get_dimensions() const {
     return dimensions_;
 }
 
+const nl::bitmap &Texture::get_bitmap() const {
+    return bitmap_;
+}
+
 nl::node Texture::find_child(const nl::node &source, const std::string &link) {
     if (!link.empty()) {
         nl::node parent_node = source.root();
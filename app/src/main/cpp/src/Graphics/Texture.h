@@ -43,6 +43,8 @@ public:
 
     Point<int16_t> get_dimensions() const;
 
+    const nl::bitmap &get_bitmap() const;
+
 private:
     static nl::node find_child(const nl::node &source, const std::string &link);
 
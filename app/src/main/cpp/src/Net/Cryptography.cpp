@@ -15,7 +15,378 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "Cryptography.h"
 
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__clang__)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 namespace ms {
+namespace {
+// Number of rounds of AES-256
+constexpr size_t AES_ROUNDS = 14;
+// Length of the first chunk of a packet in AES OFB mode
+constexpr size_t FIRST_CHUNK_LENGTH = 0x5B0;
+// Length of every following chunk
+constexpr size_t CHUNK_LENGTH = 0x5B4;
+// Blocks of keystream needed to cover the longest chunk
+constexpr size_t CHUNK_BLOCKS = (CHUNK_LENGTH + 15) / 16;
+
+// This key is already expanded
+// Only works for versions lower than version 118
+alignas(16) const uint8_t MAPLEKEY[(AES_ROUNDS + 1) * 16] = {
+    0x13, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+    0xB4, 0x00, 0x00, 0x00, 0x1B, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00,
+    0x33, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00, 0x71, 0x63, 0x63, 0x00,
+    0x79, 0x63, 0x63, 0x00, 0x7F, 0x63, 0x63, 0x00, 0xCB, 0x63, 0x63, 0x00,
+    0x04, 0xFB, 0xFB, 0x63, 0x0B, 0xFB, 0xFB, 0x63, 0x38, 0xFB, 0xFB, 0x63,
+    0x6A, 0xFB, 0xFB, 0x63, 0x7C, 0x6C, 0x98, 0x02, 0x05, 0x0F, 0xFB, 0x02,
+    0x7A, 0x6C, 0x98, 0x02, 0xB1, 0x0F, 0xFB, 0x02, 0xCC, 0x8D, 0xF4, 0x14,
+    0xC7, 0x76, 0x0F, 0x77, 0xFF, 0x8D, 0xF4, 0x14, 0x95, 0x76, 0x0F, 0x77,
+    0x40, 0x1A, 0x6D, 0x28, 0x45, 0x15, 0x96, 0x2A, 0x3F, 0x79, 0x0E, 0x28,
+    0x8E, 0x76, 0xF5, 0x2A, 0xD5, 0xB5, 0x12, 0xF1, 0x12, 0xC3, 0x1D, 0x86,
+    0xED, 0x4E, 0xE9, 0x92, 0x78, 0x38, 0xE6, 0xE5, 0x4F, 0x94, 0xB4, 0x94,
+    0x0A, 0x81, 0x22, 0xBE, 0x35, 0xF8, 0x2C, 0x96, 0xBB, 0x8E, 0xD9, 0xBC,
+    0x3F, 0xAC, 0x27, 0x94, 0x2D, 0x6F, 0x3A, 0x12, 0xC0, 0x21, 0xD3, 0x80,
+    0xB8, 0x19, 0x35, 0x65, 0x8B, 0x02, 0xF9, 0xF8, 0x81, 0x83, 0xDB, 0x46,
+    0xB4, 0x7B, 0xF7, 0xD0, 0x0F, 0xF5, 0x2E, 0x6C, 0x49, 0x4A, 0x16, 0xC4,
+    0x64, 0x25, 0x2C, 0xD6, 0xA4, 0x04, 0xFF, 0x56, 0x1C, 0x1D, 0xCA, 0x33,
+    0x0F, 0x76, 0x3A, 0x64, 0x8E, 0xF5, 0xE1, 0x22, 0x3A, 0x8E, 0x16, 0xF2,
+    0x35, 0x7B, 0x38, 0x9E, 0xDF, 0x6B, 0x11, 0xCF, 0xBB, 0x4E, 0x3D, 0x19,
+    0x1F, 0x4A, 0xC2, 0x4F, 0x03, 0x57, 0x08, 0x7C, 0x14, 0x46, 0x2A, 0x1F,
+    0x9A, 0xB3, 0xCB, 0x3D, 0xA0, 0x3D, 0xDD, 0xCF, 0x95, 0x46, 0xE5, 0x51
+};
+
+// Rijndael substitution box
+const uint8_t SUBBOX[256] = {
+        0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B,
+        0xFE, 0xD7, 0xAB, 0x76, 0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
+        0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0, 0xB7, 0xFD, 0x93, 0x26,
+        0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+        0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2,
+        0xEB, 0x27, 0xB2, 0x75, 0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
+        0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84, 0x53, 0xD1, 0x00, 0xED,
+        0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+        0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F,
+        0x50, 0x3C, 0x9F, 0xA8, 0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
+        0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2, 0xCD, 0x0C, 0x13, 0xEC,
+        0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+        0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14,
+        0xDE, 0x5E, 0x0B, 0xDB, 0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
+        0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79, 0xE7, 0xC8, 0x37, 0x6D,
+        0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+        0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F,
+        0x4B, 0xBD, 0x8B, 0x8A, 0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
+        0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E, 0xE1, 0xF8, 0x98, 0x11,
+        0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+        0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F,
+        0xB0, 0x54, 0xBB, 0x16
+};
+
+uint32_t load_be(const uint8_t *bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24) |
+           (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) |
+           static_cast<uint32_t>(bytes[3]);
+}
+
+void store_be(uint8_t *bytes, uint32_t word) {
+    bytes[0] = static_cast<uint8_t>(word >> 24);
+    bytes[1] = static_cast<uint8_t>(word >> 16);
+    bytes[2] = static_cast<uint8_t>(word >> 8);
+    bytes[3] = static_cast<uint8_t>(word);
+}
+
+// Lookup tables folding sub bytes, shift rows and mix columns into four
+// table reads per column, plus the round keys as big-endian words
+struct AesTables {
+    uint32_t te[4][256];
+    uint32_t rk[(AES_ROUNDS + 1) * 4];
+
+    AesTables() {
+        for (size_t i = 0; i < 256; i++) {
+            uint32_t s = SUBBOX[i];
+            uint32_t s2 = ((s << 1) ^ ((s & 0x80) ? 0x1B : 0)) & 0xFF;
+            uint32_t s3 = s2 ^ s;
+            uint32_t word = (s2 << 24) | (s << 16) | (s << 8) | s3;
+
+            for (size_t j = 0; j < 4; j++) {
+                te[j][i] = word;
+                word = (word >> 8) | (word << 24);
+            }
+        }
+
+        for (size_t i = 0; i < (AES_ROUNDS + 1) * 4; i++) {
+            rk[i] = load_be(MAPLEKEY + i * 4);
+        }
+    }
+};
+
+// Generate the OFB keystream for a chunk with 32-bit table lookups
+void keystream_table(const uint8_t *iv, uint8_t *stream, size_t blocks) {
+    static const AesTables tables;
+
+    const uint32_t *te0 = tables.te[0];
+    const uint32_t *te1 = tables.te[1];
+    const uint32_t *te2 = tables.te[2];
+    const uint32_t *te3 = tables.te[3];
+
+    uint32_t s0 = load_be(iv);
+    uint32_t s1 = load_be(iv + 4);
+    uint32_t s2 = load_be(iv + 8);
+    uint32_t s3 = load_be(iv + 12);
+
+    for (size_t b = 0; b < blocks; b++) {
+        const uint32_t *rk = tables.rk;
+        s0 ^= rk[0];
+        s1 ^= rk[1];
+        s2 ^= rk[2];
+        s3 ^= rk[3];
+
+        for (size_t round = 1; round < AES_ROUNDS; round++) {
+            rk += 4;
+
+            uint32_t t0 = te0[s0 >> 24] ^ te1[(s1 >> 16) & 0xFF] ^
+                          te2[(s2 >> 8) & 0xFF] ^ te3[s3 & 0xFF] ^ rk[0];
+            uint32_t t1 = te0[s1 >> 24] ^ te1[(s2 >> 16) & 0xFF] ^
+                          te2[(s3 >> 8) & 0xFF] ^ te3[s0 & 0xFF] ^ rk[1];
+            uint32_t t2 = te0[s2 >> 24] ^ te1[(s3 >> 16) & 0xFF] ^
+                          te2[(s0 >> 8) & 0xFF] ^ te3[s1 & 0xFF] ^ rk[2];
+            uint32_t t3 = te0[s3 >> 24] ^ te1[(s0 >> 16) & 0xFF] ^
+                          te2[(s1 >> 8) & 0xFF] ^ te3[s2 & 0xFF] ^ rk[3];
+
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        rk += 4;
+
+        uint32_t t0 = (static_cast<uint32_t>(SUBBOX[s0 >> 24]) << 24) ^
+                      (static_cast<uint32_t>(SUBBOX[(s1 >> 16) & 0xFF]) << 16) ^
+                      (static_cast<uint32_t>(SUBBOX[(s2 >> 8) & 0xFF]) << 8) ^
+                      SUBBOX[s3 & 0xFF] ^ rk[0];
+        uint32_t t1 = (static_cast<uint32_t>(SUBBOX[s1 >> 24]) << 24) ^
+                      (static_cast<uint32_t>(SUBBOX[(s2 >> 16) & 0xFF]) << 16) ^
+                      (static_cast<uint32_t>(SUBBOX[(s3 >> 8) & 0xFF]) << 8) ^
+                      SUBBOX[s0 & 0xFF] ^ rk[1];
+        uint32_t t2 = (static_cast<uint32_t>(SUBBOX[s2 >> 24]) << 24) ^
+                      (static_cast<uint32_t>(SUBBOX[(s3 >> 16) & 0xFF]) << 16) ^
+                      (static_cast<uint32_t>(SUBBOX[(s0 >> 8) & 0xFF]) << 8) ^
+                      SUBBOX[s1 & 0xFF] ^ rk[2];
+        uint32_t t3 = (static_cast<uint32_t>(SUBBOX[s3 >> 24]) << 24) ^
+                      (static_cast<uint32_t>(SUBBOX[(s0 >> 16) & 0xFF]) << 16) ^
+                      (static_cast<uint32_t>(SUBBOX[(s1 >> 8) & 0xFF]) << 8) ^
+                      SUBBOX[s2 & 0xFF] ^ rk[3];
+
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+
+        store_be(stream + b * 16, s0);
+        store_be(stream + b * 16 + 4, s1);
+        store_be(stream + b * 16 + 8, s2);
+        store_be(stream + b * 16 + 12, s3);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Generate the OFB keystream for a chunk with AES-NI
+__attribute__((target("aes,sse2"))) void keystream_hardware(
+    const uint8_t *iv, uint8_t *stream, size_t blocks) {
+    __m128i rk[AES_ROUNDS + 1];
+
+    for (size_t i = 0; i <= AES_ROUNDS; i++) {
+        rk[i] = _mm_load_si128(reinterpret_cast<const __m128i *>(MAPLEKEY) + i);
+    }
+
+    __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+
+    for (size_t b = 0; b < blocks; b++) {
+        state = _mm_xor_si128(state, rk[0]);
+
+        for (size_t round = 1; round < AES_ROUNDS; round++) {
+            state = _mm_aesenc_si128(state, rk[round]);
+        }
+
+        state = _mm_aesenclast_si128(state, rk[AES_ROUNDS]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(stream + b * 16), state);
+    }
+}
+
+bool has_hardware_aes() { return __builtin_cpu_supports("aes"); }
+#elif defined(__aarch64__) && defined(__clang__)
+// Generate the OFB keystream for a chunk with the ARMv8 crypto extensions
+__attribute__((target("aes"))) void keystream_hardware(const uint8_t *iv,
+                                                       uint8_t *stream,
+                                                       size_t blocks) {
+    uint8x16_t rk[AES_ROUNDS + 1];
+
+    for (size_t i = 0; i <= AES_ROUNDS; i++) {
+        rk[i] = vld1q_u8(MAPLEKEY + i * 16);
+    }
+
+    uint8x16_t state = vld1q_u8(iv);
+
+    for (size_t b = 0; b < blocks; b++) {
+        for (size_t round = 0; round < AES_ROUNDS - 1; round++) {
+            state = vaesmcq_u8(vaeseq_u8(state, rk[round]));
+        }
+
+        state = vaeseq_u8(state, rk[AES_ROUNDS - 1]);
+        state = veorq_u8(state, rk[AES_ROUNDS]);
+        vst1q_u8(stream + b * 16, state);
+    }
+}
+
+bool has_hardware_aes() { return (getauxval(AT_HWCAP) & HWCAP_AES) != 0; }
+#else
+void keystream_hardware(const uint8_t *iv, uint8_t *stream, size_t blocks) {
+    keystream_table(iv, stream, blocks);
+}
+
+bool has_hardware_aes() { return false; }
+#endif
+
+// Rotate a byte left, only the low three bits of the count matter
+uint8_t rotl(uint8_t byte, size_t count) {
+    count &= 7;
+
+    return static_cast<uint8_t>((byte << count) | (byte >> ((8 - count) & 7)));
+}
+
+// Rotate a byte right, only the low three bits of the count matter
+uint8_t rotr(uint8_t byte, size_t count) { return rotl(byte, 8 - (count & 7)); }
+
+// The maple cipher works on bytes, so the word helpers below treat a 64-bit
+// word as eight independent byte lanes with lane k holding byte k
+constexpr uint64_t LANES = 0x0101010101010101ull;
+constexpr uint64_t HIGH_BITS = 0x8080808080808080ull;
+constexpr uint64_t LOW_BITS = 0x7F7F7F7F7F7F7F7Full;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+constexpr bool WORD_LANES = true;
+#else
+constexpr bool WORD_LANES = false;
+#endif
+
+uint64_t load_lanes(const uint8_t *bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, 8);
+
+    return word;
+}
+
+void store_lanes(uint8_t *bytes, uint64_t word) { std::memcpy(bytes, &word, 8); }
+
+// Lane k holds first + step * k
+constexpr uint64_t lane_sequence(uint8_t first, int step) {
+    uint64_t word = 0;
+
+    for (unsigned k = 0; k < 8; k++) {
+        auto lane = static_cast<uint8_t>(first + step * static_cast<int>(k));
+        word |= static_cast<uint64_t>(lane) << (8 * k);
+    }
+
+    return word;
+}
+
+uint64_t add_lanes(uint64_t a, uint64_t b) {
+    return ((a & LOW_BITS) + (b & LOW_BITS)) ^ ((a ^ b) & HIGH_BITS);
+}
+
+uint64_t sub_lanes(uint64_t a, uint64_t b) {
+    return ((a | HIGH_BITS) - (b & LOW_BITS)) ^ ((a ^ ~b) & HIGH_BITS);
+}
+
+// Rotate every lane left by the same count between 1 and 7
+uint64_t rotl_lanes(uint64_t word, unsigned count) {
+    uint64_t high = LANES * static_cast<uint8_t>(0xFF << count);
+
+    return ((word << count) & high) | ((word >> (8 - count)) & ~high);
+}
+
+// Which lanes take each of the rotations by one, two and four
+struct LaneRotation {
+    uint64_t masks[3];
+};
+
+// Lane k rotates left by (first + step * k) & 7
+constexpr LaneRotation lane_rotation(int first, int step) {
+    LaneRotation rotation = {};
+
+    for (unsigned k = 0; k < 8; k++) {
+        auto count = static_cast<unsigned>(first + step * static_cast<int>(k));
+
+        for (unsigned bit = 0; bit < 3; bit++) {
+            if (count & (1u << bit)) {
+                rotation.masks[bit] |= 0xFFull << (8 * k);
+            }
+        }
+    }
+
+    return rotation;
+}
+
+// Rotate every lane left by its own count
+uint64_t rotl_lanes(uint64_t word, const LaneRotation &rotation) {
+    for (unsigned bit = 0; bit < 3; bit++) {
+        uint64_t rotated = rotl_lanes(word, 1u << bit);
+        word ^= (rotated ^ word) & rotation.masks[bit];
+    }
+
+    return word;
+}
+
+// Encryption rotates byte i right by the remaining length, so within a word
+// the pattern only depends on the length modulo 8
+constexpr LaneRotation ENCRYPT_ROTATIONS[8] = {
+    lane_rotation(0, 1),  lane_rotation(-1, 1), lane_rotation(-2, 1),
+    lane_rotation(-3, 1), lane_rotation(-4, 1), lane_rotation(-5, 1),
+    lane_rotation(-6, 1), lane_rotation(-7, 1)
+};
+
+// Decryption walks words back from the end, where the remaining length of
+// lane k is a multiple of 8 minus k
+constexpr LaneRotation DECRYPT_ROTATION = lane_rotation(0, -1);
+constexpr LaneRotation DECRYPT_PREV_ROTATION = lane_rotation(1, -1);
+
+using KeystreamFunction = void (*)(const uint8_t *, uint8_t *, size_t);
+
+// Use the hardware instructions when the cpu has them
+KeystreamFunction &keystream() {
+    static KeystreamFunction function =
+        has_hardware_aes() ? keystream_hardware : keystream_table;
+
+    return function;
+}
+
+// Xor the keystream into the bytes eight at a time
+void apply_keystream(uint8_t *bytes, const uint8_t *stream, size_t length) {
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        uint64_t key;
+        std::memcpy(&word, bytes + i, 8);
+        std::memcpy(&key, stream + i, 8);
+        word ^= key;
+        std::memcpy(bytes + i, &word, 8);
+    }
+
+    for (; i < length; i++) {
+        bytes[i] ^= stream[i];
+    }
+}
+}  // namespace
+
 Cryptography::Cryptography(const int8_t *handshake) {
 #ifdef USE_CRYPTO
     for (size_t i = 0; i < HEADER_LENGTH; i++) {
@@ -85,53 +456,138 @@ size_t Cryptography::check_length(const int8_t *bytes) const {
 #endif
 }
 
-void Cryptography::mapleencrypt(int8_t *bytes, size_t length) const {
+void Cryptography::mapleencrypt(int8_t *signedbytes, size_t length) const {
+    auto *bytes = reinterpret_cast<uint8_t *>(signedbytes);
+    const LaneRotation &rotation = ENCRYPT_ROTATIONS[length % 8];
+    const auto datalen = static_cast<uint8_t>(length);
+
+    // Each pass chains on the bytes it has already encrypted, but the chain
+    // is a running xor. So every word is prepared in its lanes, the running
+    // xor is carried across words, and the result is finished in its lanes.
     for (size_t j = 0; j < 3; j++) {
-        int8_t remember = 0;
-        auto datalen = static_cast<int8_t>(length & 0xFF);
+        // Forward pass, the length byte counts down from the front
+        size_t i = 0;
+        uint8_t remember = 0;
+
+        if (WORD_LANES) {
+            uint64_t lengths = lane_sequence(datalen, -1);
+
+            for (; i + 8 <= length; i += 8) {
+                uint64_t word = rotl_lanes(load_lanes(bytes + i), 3);
+                word = add_lanes(word, lengths);
+                word ^= word << 8;
+                word ^= word << 16;
+                word ^= word << 32;
+                word ^= remember * LANES;
+                remember = static_cast<uint8_t>(word >> 56);
+                word = rotl_lanes(word, rotation);
+                store_lanes(bytes + i, add_lanes(~word, 0x48 * LANES));
+                lengths = sub_lanes(lengths, 8 * LANES);
+            }
+        }
 
-        for (size_t i = 0; i < length; i++) {
-            int8_t cur = (rollleft(bytes[i], 3) + datalen) ^ remember;
+        for (; i < length; i++) {
+            uint8_t cur = (rotl(bytes[i], 3) + static_cast<uint8_t>(length - i)) ^
+                          remember;
             remember = cur;
-            cur = rollright(cur, static_cast<int32_t>(datalen) & 0xFF);
-            bytes[i] = static_cast<int8_t>((~cur) & 0xFF) + 0x48;
-            datalen--;
+            bytes[i] = ~rotr(cur, length - i) + 0x48;
         }
 
+        // Backward pass, the length byte counts down from the back
+        i = length;
         remember = 0;
-        datalen = static_cast<int8_t>(length & 0xFF);
 
-        for (size_t i = length; i--;) {
-            int8_t cur = (rollleft(bytes[i], 4) + datalen) ^ remember;
+        if (WORD_LANES) {
+            uint64_t positions =
+                lane_sequence(static_cast<uint8_t>(length - 7), 1);
+
+            for (; i >= 8; i -= 8) {
+                uint64_t word = rotl_lanes(load_lanes(bytes + i - 8), 4);
+                word = add_lanes(word, positions);
+                word ^= word >> 8;
+                word ^= word >> 16;
+                word ^= word >> 32;
+                word ^= remember * LANES;
+                remember = static_cast<uint8_t>(word);
+                word = rotl_lanes(word ^ (0x13 * LANES), 5);
+                store_lanes(bytes + i - 8, word);
+                positions = sub_lanes(positions, 8 * LANES);
+            }
+        }
+
+        while (i--) {
+            uint8_t cur = (rotl(bytes[i], 4) + static_cast<uint8_t>(i + 1)) ^
+                          remember;
             remember = cur;
-            bytes[i] = rollright(cur ^ 0x13, 3);
-            datalen--;
+            bytes[i] = rotr(cur ^ 0x13, 3);
         }
     }
 }
 
-void Cryptography::mapledecrypt(int8_t *bytes, size_t length) const {
-    for (size_t i = 0; i < 3; i++) {
-        uint8_t remember = 0;
-        auto datalen = static_cast<uint8_t>(length & 0xFF);
+void Cryptography::mapledecrypt(int8_t *signedbytes, size_t length) const {
+    if (length == 0) {
+        return;
+    }
 
-        for (size_t j = length; j--;) {
-            uint8_t cur = rollleft(bytes[j], 3) ^ 0x13;
-            bytes[j] = rollright((cur ^ remember) - datalen, 4);
-            remember = cur;
-            datalen--;
+    auto *bytes = reinterpret_cast<uint8_t *>(signedbytes);
+
+    // Decryption chains on the ciphertext, so every byte only depends on its
+    // neighbour's input and whole words can be processed at once
+    for (size_t j = 0; j < 3; j++) {
+        // Backward pass: each byte mixes with the byte after it, which is
+        // read before it gets overwritten
+        size_t i = 0;
+
+        if (WORD_LANES) {
+            uint64_t positions = lane_sequence(1, 1);
+
+            for (; i + 9 <= length; i += 8) {
+                uint64_t cur = rotl_lanes(load_lanes(bytes + i), 3);
+                uint64_t next = rotl_lanes(load_lanes(bytes + i + 1), 3);
+                // The 0x13 cancels out between the two
+                uint64_t word = sub_lanes(cur ^ next, positions);
+                store_lanes(bytes + i, rotl_lanes(word, 4));
+                positions = add_lanes(positions, 8 * LANES);
+            }
         }
 
-        remember = 0;
-        datalen = static_cast<uint8_t>(length & 0xFF);
+        for (; i + 1 < length; i++) {
+            uint8_t cur = rotl(bytes[i], 3) ^ 0x13;
+            uint8_t next = rotl(bytes[i + 1], 3) ^ 0x13;
+            bytes[i] = rotr((cur ^ next) - static_cast<uint8_t>(i + 1), 4);
+        }
 
-        for (size_t j = 0; j < length; j++) {
-            uint8_t cur = (~(bytes[j] - 0x48)) & 0xFF;
-            cur = rollleft(cur, static_cast<int32_t>(datalen) & 0xFF);
-            bytes[j] = rollright((cur ^ remember) - datalen, 3);
-            remember = cur;
-            datalen--;
+        bytes[length - 1] = rotr(
+            (rotl(bytes[length - 1], 3) ^ 0x13) - static_cast<uint8_t>(length),
+            4);
+
+        // Forward pass: each byte mixes with the byte before it, so walk
+        // backwards to read it before it gets overwritten
+        i = length;
+
+        if (WORD_LANES) {
+            uint64_t remaining = lane_sequence(8, -1);
+
+            for (; i >= 9; i -= 8) {
+                uint64_t cur = ~sub_lanes(load_lanes(bytes + i - 8), 0x48 * LANES);
+                uint64_t prev = ~sub_lanes(load_lanes(bytes + i - 9), 0x48 * LANES);
+                cur = rotl_lanes(cur, DECRYPT_ROTATION);
+                prev = rotl_lanes(prev, DECRYPT_PREV_ROTATION);
+                uint64_t word = sub_lanes(cur ^ prev, remaining);
+                store_lanes(bytes + i - 8, rotl_lanes(word, 5));
+                remaining = add_lanes(remaining, 8 * LANES);
+            }
+        }
+
+        while (--i > 0) {
+            uint8_t cur = rotl(~(bytes[i] - 0x48), length - i);
+            uint8_t prev = rotl(~(bytes[i - 1] - 0x48), length - i + 1);
+            bytes[i] = rotr((cur ^ prev) - static_cast<uint8_t>(length - i), 3);
         }
+
+        bytes[0] = rotr(rotl(~(bytes[0] - 0x48), length) -
+                            static_cast<uint8_t>(length),
+                        3);
     }
 }
 
@@ -188,177 +644,46 @@ void Cryptography::updateiv(uint8_t *iv) const {
     }
 }
 
-int8_t Cryptography::rollleft(int8_t data, size_t count) const {
-    int32_t mask = (data & 0xFF) << (count % 8);
-
-    return static_cast<int8_t>((mask & 0xFF) | (mask >> 8));
-}
-
-int8_t Cryptography::rollright(int8_t data, size_t count) const {
-    int32_t mask = ((data & 0xFF) << 8) >> (count % 8);
-
-    return static_cast<int8_t>((mask & 0xFF) | (mask >> 8));
-}
-
-void Cryptography::aesofb(int8_t *bytes, size_t length, uint8_t *iv) const {
-    size_t blocklength = 0x5B0;
-    size_t offset = 0;
-
-    while (offset < length) {
-        uint8_t miv[16];
-
-        for (size_t i = 0; i < 16; i++) {
-            miv[i] = iv[i % 4];
-        }
-
-        size_t remaining = length - offset;
-
-        if (remaining > blocklength) {
-            remaining = blocklength;
-        }
-
-        for (size_t x = 0; x < remaining; x++) {
-            size_t relpos = x % 16;
-
-            if (relpos == 0) {
-                aesencrypt(miv);
+bool Cryptography::set_aes_path(AesPath path) {
+    switch (path) {
+        case AesPath::TABLE: keystream() = keystream_table; return true;
+        case AesPath::HARDWARE:
+            if (!has_hardware_aes()) {
+                return false;
             }
 
-            bytes[x + offset] ^= miv[relpos];
-        }
-
-        offset += blocklength;
-        blocklength = 0x5B4;
+            keystream() = keystream_hardware;
+            return true;
     }
 
-    updateiv(iv);
+    return false;
 }
 
-void Cryptography::aesencrypt(uint8_t *bytes) const {
-    uint8_t round = 0;
-    addroundkey(bytes, round);
+void Cryptography::aesofb(int8_t *bytes, size_t length, uint8_t *iv) const {
+    alignas(16) uint8_t miv[16];
 
-    for (round = 1; round < 14; round++) {
-        subbytes(bytes);
-        shiftrows(bytes);
-        mixcolumns(bytes);
-        addroundkey(bytes, round);
+    for (size_t i = 0; i < 16; i++) {
+        miv[i] = iv[i % 4];
     }
 
-    subbytes(bytes);
-    shiftrows(bytes);
-    addroundkey(bytes, round);
-}
-
-void Cryptography::addroundkey(uint8_t *bytes, uint8_t round) const {
-    // This key is already expanded
-    // Only works for versions lower than version 118
-    static const uint8_t maplekey[256] = {
-        0x13, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
-        0xB4, 0x00, 0x00, 0x00, 0x1B, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00,
-        0x33, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00, 0x71, 0x63, 0x63, 0x00,
-        0x79, 0x63, 0x63, 0x00, 0x7F, 0x63, 0x63, 0x00, 0xCB, 0x63, 0x63, 0x00,
-        0x04, 0xFB, 0xFB, 0x63, 0x0B, 0xFB, 0xFB, 0x63, 0x38, 0xFB, 0xFB, 0x63,
-        0x6A, 0xFB, 0xFB, 0x63, 0x7C, 0x6C, 0x98, 0x02, 0x05, 0x0F, 0xFB, 0x02,
-        0x7A, 0x6C, 0x98, 0x02, 0xB1, 0x0F, 0xFB, 0x02, 0xCC, 0x8D, 0xF4, 0x14,
-        0xC7, 0x76, 0x0F, 0x77, 0xFF, 0x8D, 0xF4, 0x14, 0x95, 0x76, 0x0F, 0x77,
-        0x40, 0x1A, 0x6D, 0x28, 0x45, 0x15, 0x96, 0x2A, 0x3F, 0x79, 0x0E, 0x28,
-        0x8E, 0x76, 0xF5, 0x2A, 0xD5, 0xB5, 0x12, 0xF1, 0x12, 0xC3, 0x1D, 0x86,
-        0xED, 0x4E, 0xE9, 0x92, 0x78, 0x38, 0xE6, 0xE5, 0x4F, 0x94, 0xB4, 0x94,
-        0x0A, 0x81, 0x22, 0xBE, 0x35, 0xF8, 0x2C, 0x96, 0xBB, 0x8E, 0xD9, 0xBC,
-        0x3F, 0xAC, 0x27, 0x94, 0x2D, 0x6F, 0x3A, 0x12, 0xC0, 0x21, 0xD3, 0x80,
-        0xB8, 0x19, 0x35, 0x65, 0x8B, 0x02, 0xF9, 0xF8, 0x81, 0x83, 0xDB, 0x46,
-        0xB4, 0x7B, 0xF7, 0xD0, 0x0F, 0xF5, 0x2E, 0x6C, 0x49, 0x4A, 0x16, 0xC4,
-        0x64, 0x25, 0x2C, 0xD6, 0xA4, 0x04, 0xFF, 0x56, 0x1C, 0x1D, 0xCA, 0x33,
-        0x0F, 0x76, 0x3A, 0x64, 0x8E, 0xF5, 0xE1, 0x22, 0x3A, 0x8E, 0x16, 0xF2,
-        0x35, 0x7B, 0x38, 0x9E, 0xDF, 0x6B, 0x11, 0xCF, 0xBB, 0x4E, 0x3D, 0x19,
-        0x1F, 0x4A, 0xC2, 0x4F, 0x03, 0x57, 0x08, 0x7C, 0x14, 0x46, 0x2A, 0x1F,
-        0x9A, 0xB3, 0xCB, 0x3D, 0xA0, 0x3D, 0xDD, 0xCF, 0x95, 0x46, 0xE5, 0x51,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00
-    };
-
-    uint8_t offset = round * 16;
+    // Every chunk restarts from the same iv block, so one chunk of keystream
+    // covers the whole packet
+    alignas(16) uint8_t stream[CHUNK_BLOCKS * 16];
+    size_t streamlength = std::min(length, CHUNK_LENGTH);
+    keystream()(miv, stream, (streamlength + 15) / 16);
 
-    for (int i = 0; i < 16; i++) {
-        bytes[i] ^= maplekey[i + offset];
-    }
-}
+    size_t blocklength = FIRST_CHUNK_LENGTH;
+    size_t offset = 0;
 
-void Cryptography::subbytes(uint8_t *bytes) const {
-    // Rijndael substitution box
-    static const uint8_t subbox[256] = {
-        0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B,
-        0xFE, 0xD7, 0xAB, 0x76, 0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
-        0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0, 0xB7, 0xFD, 0x93, 0x26,
-        0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
-        0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2,
-        0xEB, 0x27, 0xB2, 0x75, 0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
-        0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84, 0x53, 0xD1, 0x00, 0xED,
-        0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
-        0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F,
-        0x50, 0x3C, 0x9F, 0xA8, 0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
-        0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2, 0xCD, 0x0C, 0x13, 0xEC,
-        0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
-        0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14,
-        0xDE, 0x5E, 0x0B, 0xDB, 0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
-        0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79, 0xE7, 0xC8, 0x37, 0x6D,
-        0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
-        0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F,
-        0x4B, 0xBD, 0x8B, 0x8A, 0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
-        0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E, 0xE1, 0xF8, 0x98, 0x11,
-        0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
-        0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F,
-        0xB0, 0x54, 0xBB, 0x16
-    };
+    while (offset < length) {
+        size_t remaining = std::min(length - offset, blocklength);
+        apply_keystream(reinterpret_cast<uint8_t *>(bytes + offset), stream,
+                        remaining);
 
-    for (int i = 0; i < 16; i++) {
-        bytes[i] = subbox[bytes[i]];
+        offset += blocklength;
+        blocklength = CHUNK_LENGTH;
     }
-}
 
-void Cryptography::shiftrows(uint8_t *bytes) const {
-    uint8_t remember = bytes[1];
-    bytes[1] = bytes[5];
-    bytes[5] = bytes[9];
-    bytes[9] = bytes[13];
-    bytes[13] = remember;
-
-    remember = bytes[10];
-    bytes[10] = bytes[2];
-    bytes[2] = remember;
-
-    remember = bytes[3];
-    bytes[3] = bytes[15];
-    bytes[15] = bytes[11];
-    bytes[11] = bytes[7];
-    bytes[7] = remember;
-
-    remember = bytes[14];
-    bytes[14] = bytes[6];
-    bytes[6] = remember;
-}
-
-uint8_t Cryptography::gmul(uint8_t x) const {
-    return (x << 1) ^ (0x1B & (uint8_t)((int8_t)x >> 7));
-}
-
-void Cryptography::mixcolumns(uint8_t *bytes) const {
-    for (int i = 0; i < 16; i += 4) {
-        uint8_t cpy0 = bytes[i];
-        uint8_t cpy1 = bytes[i + 1];
-        uint8_t cpy2 = bytes[i + 2];
-        uint8_t cpy3 = bytes[i + 3];
-
-        uint8_t mul0 = gmul(bytes[i]);
-        uint8_t mul1 = gmul(bytes[i + 1]);
-        uint8_t mul2 = gmul(bytes[i + 2]);
-        uint8_t mul3 = gmul(bytes[i + 3]);
-
-        bytes[i] = mul0 ^ cpy3 ^ cpy2 ^ mul1 ^ cpy1;
-        bytes[i + 1] = mul1 ^ cpy0 ^ cpy3 ^ mul2 ^ cpy2;
-        bytes[i + 2] = mul2 ^ cpy1 ^ cpy0 ^ mul3 ^ cpy3;
-        bytes[i + 3] = mul3 ^ cpy2 ^ cpy1 ^ mul0 ^ cpy0;
-    }
+    updateiv(iv);
 }
-}  // namespace ms
\ No newline at end of file
+}  // namespace ms
@@ -35,32 +35,24 @@ public:
     // Use the 4-byte header of a received packet to determine its length
     size_t check_length(const int8_t *header) const;
 
-private:
     // Add the maple custom encryption
     void mapleencrypt(int8_t *bytes, size_t length) const;
     // Remove the maple custom encryption
     void mapledecrypt(int8_t *bytes, size_t length) const;
-    // Update a key
-    void updateiv(uint8_t *iv) const;
-    // Perform a roll-left operation
-    int8_t rollleft(int8_t byte, size_t count) const;
-    // Perform a roll-right operation
-    int8_t rollright(int8_t byte, size_t count) const;
-
     // Apply AES OFB to a byte array
     void aesofb(int8_t *bytes, size_t length, uint8_t *iv) const;
-    // Encrypt a byte array with AES
-    void aesencrypt(uint8_t *bytes) const;
-    // AES add round key step
-    void addroundkey(uint8_t *bytes, uint8_t round) const;
-    // AES sub bytes step
-    void subbytes(uint8_t *bytes) const;
-    // AES shift rows step
-    void shiftrows(uint8_t *bytes) const;
-    // AES mix columns step
-    void mixcolumns(uint8_t *bytes) const;
-    // Perform a Galois multiplication
-    uint8_t gmul(uint8_t byte) const;
+
+    // Implementations of the AES keystream
+    enum class AesPath { TABLE, HARDWARE };
+
+    // Switch every instance to an implementation, return false if this cpu
+    // cannot run it. Hardware AES is used by default when the cpu has it.
+    // For tests and benchmarks, must not race with encrypt or decrypt.
+    static bool set_aes_path(AesPath path);
+
+private:
+    // Update a key
+    void updateiv(uint8_t *iv) const;
 
 #ifdef USE_CRYPTO
     uint8_t sendiv_[HEADER_LENGTH];
@@ -65,6 +65,8 @@ void SetCashShopHandler::transition() const {
 
     float fadestep = 0.025f;
 
+    Stage::get().preload(-1);
+
     Window::get().fadeout(fadestep, []() {
         GraphicsGL::get().clear();
 
@@ -380,11 +380,32 @@ void ApplyMobStatusHandler::handle(InPacket &recv) const {
     int32_t first_mask = recv.read_int();
     int32_t second_mask = recv.read_int();
 
-    // and some more ...
+    uint64_t statuses = (static_cast<uint64_t>(first_mask) << 32)
+                        | static_cast<uint32_t>(second_mask);
 
-    std::cerr << std::endl
-              << "Opcode [242] Error: Handler exists but is not implemented."
-              << std::endl;
+    auto mob = Stage::get().get_mobs().get_mobs()->get<Mob>(oid);
+
+    // One entry per status, in the order of the bits starting with the
+    // second mask. Mob skills send their id and level as shorts, other
+    // skills use the same four bytes for an int id.
+    for (uint8_t bit = 0; bit < 64; bit++) {
+        uint64_t status = uint64_t(1) << bit;
+
+        if (!(statuses & status)) {
+            continue;
+        }
+
+        recv.read_short();  // value
+
+        int16_t skill_id = recv.read_short();
+
+        recv.read_short();  // level
+        recv.read_short();
+
+        if (mob) {
+            mob->get().apply_status(status, skill_id);
+        }
+    }
 }
 
 void CancelMobStatusHandler::handle(InPacket &recv) const {
@@ -397,13 +418,12 @@ void CancelMobStatusHandler::handle(InPacket &recv) const {
 
     recv.read_int();
 
+    uint64_t statuses = (static_cast<uint64_t>(first_mask) << 32)
+                        | static_cast<uint32_t>(second_mask);
+
     if (auto mob = Stage::get().get_mobs().get_mobs()->get<Mob>(oid)) {
-        mob->get().cancel_buff(12345);  // TODO
+        mob->get().cancel_statuses(statuses);
     }
-
-    std::cerr << std::endl
-              << "Opcode [243] Error: Handler exists but is not implemented."
-              << std::endl;
 }
 
 void ShowMobHpHandler::handle(InPacket &recv) const {
@@ -35,6 +35,8 @@ auto fn_player_update = []<typename... T>(T && ...args) {
 void SetFieldHandler::transition(int32_t mapid, uint8_t portalid) const {
     float fadestep = 0.025f;
 
+    Stage::get().preload(mapid);
+
     Window::get().fadeout(fadestep, [mapid, portalid]() {
         GraphicsGL::get().clear();
 
@@ -214,6 +214,9 @@ public:
 
     std::vector<int8_t> build() { return std::move(bytes_); }
 
+    // Return the number of bytes written so far, including the opcode
+    size_t length() const { return bytes_.size(); }
+
     // Opcodes for OutPackets associated with version 83 of the game
     enum Opcode : uint16_t {
         /// Login
@@ -52,6 +52,14 @@ public:
 
     bool is_connected() { return session_.is_connected(); }
 
+    /**
+     * @brief Counters of the last call to process().
+     *
+     */
+    const Session::ReadStats &get_read_stats() const {
+        return session_.get_read_stats();
+    }
+
 private:
     Session session_;
 };
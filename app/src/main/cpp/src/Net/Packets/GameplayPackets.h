@@ -59,11 +59,14 @@ public:
 class MovePlayerPacket : public MovementPacket {
 public:
     // Updates the player's position with the server
-    MovePlayerPacket(const Movement &movement) :
+    MovePlayerPacket(const std::vector<Movement> &movements) :
         MovementPacket(OutPacket::Opcode::MOVE_PLAYER) {
         skip(9);
-        write_byte(1);
-        write_movement(movement);
+        write_byte(static_cast<int8_t>(movements.size()));
+
+        for (const Movement &movement : movements) {
+            write_movement(movement);
+        }
     }
 };
 
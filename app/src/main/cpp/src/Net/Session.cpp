@@ -15,29 +15,52 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "Session.h"
 
+#include <algorithm>
+
 #include "../Configuration.h"
 #include "PacketError.h"
 
 namespace ms {
 Session::Session(std::unique_ptr<Forwarder> packet_forwarder) :
     packet_forwarder_(std::move(packet_forwarder)),
+    head_(0),
+    tail_(0),
     length_(0),
-    pos_(0),
+    has_header_(false),
+    connection_(0),
     is_connected_(false) {}
 
 Session::~Session() {
+#ifdef USE_ASIO
+    stop_thread();
+#endif
+
     if (is_connected_) {
         socket_.close();
     }
 }
 
 bool Session::init(const char *host, const char *port) {
+    // Anything still buffered belongs to the previous connection
+    head_ = 0;
+    tail_ = 0;
+    length_ = 0;
+    has_header_ = false;
+    failed_ = false;
+    connection_++;
+
     // Connect to the server
     is_connected_ = socket_.open(host, port);
 
     if (is_connected_) {
         // Read keys necessary for communicating with the server
         cryptography_ = { socket_.get_buffer() };
+
+#ifdef USE_ASIO
+        if (threaded_) {
+            start_thread();
+        }
+#endif
     }
 
     return is_connected_;
@@ -68,6 +91,10 @@ Error Session::init(GLFMDisplay *pApp) {
     std::string HOST = readHostIP(pApp);
     std::string PORT = Setting<ServerPort>::get().load();
 
+#ifdef USE_ASIO
+    threaded_ = Setting<NetworkThread>::get().load();
+#endif
+
     if (!init(HOST.c_str(), PORT.c_str())) {
         return Error::CONNECTION;
     }
@@ -76,6 +103,10 @@ Error Session::init(GLFMDisplay *pApp) {
 }
 
 void Session::reconnect(const char *address, const char *port) {
+#ifdef USE_ASIO
+    stop_thread();
+#endif
+
     // Close the current connection and open a new one
     bool success = socket_.close();
 
@@ -86,55 +117,115 @@ void Session::reconnect(const char *address, const char *port) {
     }
 }
 
-void Session::process(const int8_t *bytes, size_t available) {
-    if (pos_ == 0) {
-        // Position is zero, meaning this is the start of a new packet. Start by
-        // determining length.
-        length_ = cryptography_.check_length(bytes);
-        // Reading the length means we processed the header. Move forward by the
-        // header length.
-        bytes = bytes + HEADER_LENGTH;
-        available -= HEADER_LENGTH;
-    }
+void Session::copy_from_ring(int8_t *bytes, size_t pos, size_t count) const {
+    size_t start = pos & (RING_LENGTH - 1);
+    size_t first = std::min(count, RING_LENGTH - start);
 
-    // Determine how much we can write. Write data into the buffer.
-    size_t towrite = length_ - pos_;
+    memcpy(bytes, ring_ + start, first);
+    memcpy(bytes + first, ring_, count - first);
+}
 
-    if (towrite > available) {
-        towrite = available;
-    }
+bool Session::process(uint32_t connection) {
+    while (true) {
+        size_t backlog = tail_ - head_;
+
+        if (!has_header_) {
+            if (backlog < HEADER_LENGTH) {
+                return true;
+            }
+
+            int8_t header[HEADER_LENGTH];
+            copy_from_ring(header, head_, HEADER_LENGTH);
+
+            length_ = cryptography_.check_length(header);
+            has_header_ = true;
+            head_ += HEADER_LENGTH;
+            backlog -= HEADER_LENGTH;
 
-    memcpy(buffer_ + pos_, bytes, towrite);
-    pos_ += towrite;
+            if (length_ > MAX_PACKET_LENGTH) {
+                // The stream cannot be framed anymore
+                std::cout << "Invalid packet length: " << length_ << std::endl;
+                failed_ = true;
+
+                return false;
+            }
+        }
+
+        if (backlog < length_) {
+            return true;
+        }
 
-    // Check if the current packet has been fully processed
-    if (pos_ >= length_) {
-        cryptography_.decrypt(buffer_, length_);
+        // Decrypt in place unless the packet wraps around the end of the ring
+        size_t start = head_ & (RING_LENGTH - 1);
+        int8_t *packet = ring_ + start;
 
-        try {
-            packet_forwarder_->forward(buffer_, length_);
-        } catch (const PacketError &err) {
-            std::cout << err.what() << std::endl;
+        if (start + length_ > RING_LENGTH) {
+            copy_from_ring(buffer_, head_, length_);
+            packet = buffer_;
         }
 
-        pos_ = 0;
+        size_t length = length_;
+        head_ += length;
         length_ = 0;
+        has_header_ = false;
 
-        // Check if there is more available
-        size_t remaining = available - towrite;
+        cryptography_.decrypt(packet, length);
 
-        if (remaining >= MIN_PACKET_LENGTH) {
-            // More packets are available, so we start over.
-            process(bytes + towrite, remaining);
+#ifdef USE_ASIO
+        if (threaded_) {
+            queue_inbound(packet, length);
+            continue;
         }
+#endif
+
+        stats_.packets++;
+        forward(packet, length);
+
+        if (connection != connection_) {
+            return false;
+        }
+    }
+}
+
+void Session::forward(int8_t *bytes, size_t length) {
+    try {
+        packet_forwarder_->forward(bytes, length);
+    } catch (const PacketError &err) {
+        std::cout << err.what() << std::endl;
     }
 }
 
 void Session::write(int8_t *packet_bytes, size_t packet_length) {
-    if (!is_connected_) {
+    if (!is_connected()) {
         return;
     }
 
+#ifdef USE_ASIO
+    if (threaded_) {
+        std::vector<int8_t> packet(packet_bytes, packet_bytes + packet_length);
+        drain_outbound_overflow();
+
+        // Only a stalled connection fills the queue, hold the packet back
+        // instead of waiting for it to drain
+        if (!outbound_overflow_.empty() || !outbound_.push(std::move(packet))) {
+            if (outbound_overflow_.size() == MAX_OVERFLOW) {
+                failed_ = true;
+                outbound_overflow_.clear();
+
+                return;
+            }
+
+            outbound_overflow_.push_back(std::move(packet));
+        }
+
+        if (!flush_posted_.exchange(true)) {
+            socket_.post([this]() { flush_outbound(); });
+        }
+
+        return;
+    }
+#endif
+
     int8_t header[HEADER_LENGTH];
     cryptography_.create_header(header, packet_length);
     cryptography_.encrypt(packet_bytes, packet_length);
@@ -144,14 +235,57 @@ void Session::write(int8_t *packet_bytes, size_t packet_length) {
 }
 
 void Session::read() {
-    // Check if a packet has arrived. Handle if data is sufficient: 4 bytes
-    // (header) + 2 bytes (opcode) = 6 bytes.
-    size_t result = socket_.receive(&is_connected_);
+    stats_ = {};
+
+#ifdef USE_ASIO
+    if (threaded_) {
+        // Packets that arrived before the connection broke still count
+        read_queued();
+
+        // The queue has room again, let the network thread refill it
+        if (inbound_overflowed_.exchange(false)) {
+            socket_.post([this]() { drain_inbound_overflow(); });
+        }
+
+        drain_outbound_overflow();
+    }
+#endif
+
+    if (failed_) {
+        is_connected_ = false;
+    }
+
+#ifdef USE_ASIO
+    if (threaded_) {
+        return;
+    }
+#endif
+
+    if (!is_connected_) {
+        return;
+    }
 
-    if (result >= MIN_PACKET_LENGTH || length_ > 0) {
-        // Retrieve buffer from the socket and process it
-        const int8_t *bytes = socket_.get_buffer();
-        process(bytes, result);
+    // Drain everything that has arrived, framing packets after every read so
+    // that the ring always has room for the next one
+    const uint32_t connection = connection_;
+
+    while (is_connected_) {
+        size_t start = tail_ & (RING_LENGTH - 1);
+        size_t space = std::min(RING_LENGTH - (tail_ - head_), RING_LENGTH - start);
+        size_t result = socket_.receive(ring_ + start, space, &is_connected_);
+
+        if (result == 0) {
+            break;
+        }
+
+        tail_ += result;
+        stats_.bytes += result;
+        stats_.reads++;
+        stats_.max_backlog = std::max(stats_.max_backlog, tail_ - head_);
+
+        if (!process(connection)) {
+            break;
+        }
     }
 }
 
@@ -163,6 +297,196 @@ void Session::reconnect() {
 }
 
 bool Session::is_connected() const {
-    return is_connected_;
+    return is_connected_ && !failed_;
+}
+
+const Session::ReadStats &Session::get_read_stats() const {
+    return stats_;
+}
+
+#ifdef USE_ASIO
+void Session::start_thread() {
+    stopping_ = false;
+    flush_posted_ = false;
+    inbound_overflowed_ = false;
+    is_writing_ = false;
+
+    receive_async();
+    thread_ = std::thread([this]() { socket_.run(); });
+}
+
+void Session::stop_thread() {
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    stopping_ = true;
+    socket_.stop();
+    thread_.join();
+
+    // The network thread is gone, so this thread may empty both ends
+    std::vector<int8_t> packet;
+
+    while (inbound_.pop(packet)) {}
+    while (outbound_.pop(packet)) {}
+
+    inbound_overflow_.clear();
+    outbound_overflow_.clear();
+
+    writing_.clear();
+    is_writing_ = false;
+}
+
+void Session::read_queued() {
+    const uint32_t connection = connection_;
+    std::vector<int8_t> packet;
+
+    while (inbound_.pop(packet)) {
+        stats_.bytes += HEADER_LENGTH + packet.size();
+        stats_.packets++;
+        forward(packet.data(), packet.size());
+
+        if (connection != connection_) {
+            // A handler reconnected and the queue was emptied
+            return;
+        }
+
+        // Hand the buffer back so the network thread can reuse its capacity
+        packet.clear();
+        recycled_.push(std::move(packet));
+    }
+}
+
+void Session::receive_async() {
+    size_t start = tail_ & (RING_LENGTH - 1);
+    size_t space = std::min(RING_LENGTH - (tail_ - head_), RING_LENGTH - start);
+    const uint32_t connection = connection_;
+
+    socket_.async_receive(
+        ring_ + start, space,
+        [this, connection](const error_code &error, size_t result) {
+            on_receive(connection, error, result);
+        });
+}
+
+void Session::on_receive(uint32_t connection,
+                         const error_code &error,
+                         size_t result) {
+    // Operations of a closed connection complete with errors, ignore them
+    if (connection != connection_ || error == asio::error::operation_aborted) {
+        return;
+    }
+
+    if (error) {
+        failed_ = true;
+        return;
+    }
+
+    tail_ += result;
+
+    if (process(connection) && !stopping_) {
+        receive_async();
+    }
+}
+
+void Session::queue_inbound(const int8_t *bytes, size_t length) {
+    std::vector<int8_t> packet;
+    recycled_.pop(packet);
+    packet.assign(bytes, bytes + length);
+    drain_inbound_overflow();
+
+    // The game thread is behind, hold the packet back until it catches up
+    if (!inbound_overflow_.empty() || !inbound_.push(std::move(packet))) {
+        if (inbound_overflow_.size() == MAX_OVERFLOW) {
+            failed_ = true;
+            inbound_overflow_.clear();
+
+            return;
+        }
+
+        inbound_overflow_.push_back(std::move(packet));
+        inbound_overflowed_ = true;
+    }
+}
+
+void Session::drain_inbound_overflow() {
+    while (!inbound_overflow_.empty() &&
+           inbound_.push(std::move(inbound_overflow_.front()))) {
+        inbound_overflow_.pop_front();
+    }
+
+    if (!inbound_overflow_.empty()) {
+        inbound_overflowed_ = true;
+    }
+}
+
+void Session::drain_outbound_overflow() {
+    bool pushed = false;
+
+    while (!outbound_overflow_.empty() &&
+           outbound_.push(std::move(outbound_overflow_.front()))) {
+        outbound_overflow_.pop_front();
+        pushed = true;
+    }
+
+    if (pushed && !flush_posted_.exchange(true)) {
+        socket_.post([this]() { flush_outbound(); });
+    }
+}
+
+void Session::flush_outbound() {
+    // Clear the flag before popping so a packet pushed after this posts again
+    flush_posted_ = false;
+
+    if (is_writing_) {
+        // The completion handler flushes again
+        return;
+    }
+
+    std::vector<int8_t> packet;
+
+    while (writing_.size() < MAX_BATCH && outbound_.pop(packet)) {
+        writing_.push_back(std::move(packet));
+    }
+
+    if (writing_.empty()) {
+        return;
+    }
+
+    headers_.resize(writing_.size());
+    buffers_.clear();
+
+    for (size_t i = 0; i < writing_.size(); i++) {
+        std::vector<int8_t> &bytes = writing_[i];
+
+        cryptography_.create_header(headers_[i].data(), bytes.size());
+        cryptography_.encrypt(bytes.data(), bytes.size());
+
+        buffers_.push_back(asio::buffer(headers_[i]));
+        buffers_.push_back(asio::buffer(bytes));
+    }
+
+    is_writing_ = true;
+    const uint32_t connection = connection_;
+
+    socket_.async_dispatch(
+        buffers_,
+        [this, connection](const error_code &error, size_t) {
+            if (connection != connection_ ||
+                error == asio::error::operation_aborted) {
+                return;
+            }
+
+            is_writing_ = false;
+            writing_.clear();
+
+            if (error) {
+                failed_ = true;
+                return;
+            }
+
+            flush_outbound();
+        });
 }
+#endif
 }  // namespace ms
\ No newline at end of file
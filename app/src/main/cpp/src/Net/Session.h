@@ -15,10 +15,16 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "../Error.h"
 #include "../MSClient.h"
+#include "../Template/SpscQueue.h"
 #include "Cryptography.h"
 #include "Forwarder.h"
 
@@ -33,6 +39,15 @@
 namespace ms {
 class Session {
 public:
+    // Counters for the bytes and packets handled by the last call to read.
+    // With the network thread, reads and max_backlog stay zero.
+    struct ReadStats {
+        size_t bytes = 0;
+        size_t packets = 0;
+        size_t reads = 0;
+        size_t max_backlog = 0;
+    };
+
     Session(std::unique_ptr<Forwarder> packet_forwarder);
     ~Session();
 
@@ -49,22 +64,95 @@ public:
     void reconnect(const char *address, const char *port);
     // Check if the connection is alive
     bool is_connected() const;
+    // Return the counters of the last read
+    const ReadStats &get_read_stats() const;
 
     std::string readHostIP(GLFMDisplay* pApp);
 
 private:
+    // Room for one partial packet plus a full packet behind it
+    static constexpr size_t RING_LENGTH = 2 * MAX_PACKET_LENGTH;
+
+    static_assert((RING_LENGTH & (RING_LENGTH - 1)) == 0,
+                  "The ring length must be a power of two");
+
     bool init(const char *host, const char *port);
-    void process(const int8_t *bytes, size_t available);
+    // Decrypt and forward every complete packet in the ring. Returns false
+    // if a handler replaced the connection or the stream is corrupt.
+    bool process(uint32_t connection);
+    // Hand a decrypted packet to the forwarder
+    void forward(int8_t *bytes, size_t length);
+    // Copy bytes out of the ring, wrapping around its end
+    void copy_from_ring(int8_t *bytes, size_t pos, size_t count) const;
 
     Cryptography cryptography_;
     std::unique_ptr<Forwarder> packet_forwarder_;
 
+    // Received bytes between head and tail, both counted from the start of
+    // the connection
+    int8_t ring_[RING_LENGTH];
+    size_t head_;
+    size_t tail_;
+    // Scratch space for packets that wrap around the end of the ring
     int8_t buffer_[MAX_PACKET_LENGTH];
+    // Length of the packet whose header has been read, if any
     size_t length_;
-    size_t pos_;
+    bool has_header_;
+    // Changes whenever a new connection is opened
+    uint32_t connection_;
     bool is_connected_;
+    // Set when the stream breaks, possibly by the network thread
+    std::atomic<bool> failed_ { false };
+    ReadStats stats_;
 
 #ifdef USE_ASIO
+    // Packets waiting to be handed between the game and network threads
+    using PacketQueue = SpscQueue<std::vector<int8_t>, 1024>;
+
+    // Most packets written with one gather write
+    static constexpr size_t MAX_BATCH = 64;
+    // Most packets held back while a queue is full before the connection is
+    // given up on
+    static constexpr size_t MAX_OVERFLOW = 8192;
+
+    // Move all socket work onto a background thread
+    void start_thread();
+    // Stop the background thread and drop everything still queued
+    void stop_thread();
+    // Forward the packets the network thread has queued
+    void read_queued();
+    // Network thread: wait for more bytes after the ring's tail
+    void receive_async();
+    // Network thread: frame the received bytes and queue their packets
+    void on_receive(uint32_t connection, const error_code &error, size_t result);
+    // Network thread: queue a decrypted packet for the game thread
+    void queue_inbound(const int8_t *bytes, size_t length);
+    // Network thread: move held back packets into the inbound queue
+    void drain_inbound_overflow();
+    // Game thread: move held back packets into the outbound queue
+    void drain_outbound_overflow();
+    // Network thread: encrypt queued packets and send them in one write
+    void flush_outbound();
+
+    bool threaded_ = false;
+    std::thread thread_;
+    std::atomic<bool> stopping_ { false };
+    std::atomic<bool> flush_posted_ { false };
+    PacketQueue inbound_;
+    PacketQueue outbound_;
+    PacketQueue recycled_;
+    // Packets that did not fit into a full queue, in order. Each is only
+    // touched by the thread that pushes into the matching queue.
+    std::deque<std::vector<int8_t>> inbound_overflow_;
+    std::deque<std::vector<int8_t>> outbound_overflow_;
+    // Set by the network thread while inbound packets are held back
+    std::atomic<bool> inbound_overflowed_ { false };
+    // Owned by the network thread while a gather write is in flight
+    std::vector<std::vector<int8_t>> writing_;
+    std::vector<std::array<int8_t, HEADER_LENGTH>> headers_;
+    std::vector<asio::const_buffer> buffers_;
+    bool is_writing_ = false;
+
     SocketAsio socket_;
 #else
     SocketWinsock socket_;
@@ -51,13 +51,21 @@ bool SocketAsio::close() {
     return !error;
 }
 
-size_t SocketAsio::receive(bool *recvok) {
-    if (socket_.available() > 0) {
-        error_code error;
-        size_t result = socket_.read_some(asio::buffer(buffer_), error);
+size_t SocketAsio::receive(int8_t *bytes, size_t length, bool *recvok) {
+    error_code error;
+    size_t available = socket_.available(error);
+
+    if (error) {
+        *recvok = false;
+
+        return 0;
+    }
+
+    if (available > 0) {
+        size_t result = socket_.read_some(asio::buffer(bytes, length), error);
         *recvok = !error;
 
-        return result;
+        return error ? 0 : result;
     }
 
     return 0;
@@ -73,5 +81,30 @@ bool SocketAsio::dispatch(const int8_t *bytes, size_t length) {
 
     return !error && (result == length);
 }
+
+void SocketAsio::async_receive(
+    int8_t *bytes, size_t length,
+    std::function<void(const error_code &, size_t)> handler) {
+    socket_.async_read_some(asio::buffer(bytes, length), std::move(handler));
+}
+
+void SocketAsio::async_dispatch(
+    const std::vector<asio::const_buffer> &buffers,
+    std::function<void(const error_code &, size_t)> handler) {
+    asio::async_write(socket_, buffers, std::move(handler));
+}
+
+void SocketAsio::post(std::function<void()> work) {
+    asio::post(ioservice_, std::move(work));
+}
+
+void SocketAsio::run() {
+    ioservice_.restart();
+    ioservice_.run();
+}
+
+void SocketAsio::stop() {
+    ioservice_.stop();
+}
 }  // namespace ms
 #endif
\ No newline at end of file
@@ -18,6 +18,9 @@
 #include "../MSClient.h"
 
 #ifdef USE_ASIO
+#include <functional>
+#include <vector>
+
 #include "NetConstants.h"
 
 #define BOOST_DATE_TIME_NO_LIB
@@ -43,10 +46,25 @@ public:
 
     bool open(const char *address, const char *port);
     bool close();
-    size_t receive(bool *connected);
+    // Read up to length bytes that have already arrived, without blocking
+    size_t receive(int8_t *bytes, size_t length, bool *connected);
     const int8_t *get_buffer() const;
     bool dispatch(const int8_t *bytes, size_t length);
 
+    // Asynchronous versions of receive and dispatch. Their handlers are called
+    // on the thread inside run().
+    void async_receive(int8_t *bytes, size_t length,
+                       std::function<void(const error_code &, size_t)> handler);
+    void async_dispatch(const std::vector<asio::const_buffer> &buffers,
+                        std::function<void(const error_code &, size_t)> handler);
+    // Queue work for the thread inside run(), callable from any thread
+    void post(std::function<void()> work);
+    // Process asynchronous operations until there are none left or stop() is
+    // called
+    void run();
+    // Make run() return as soon as possible, callable from any thread
+    void stop();
+
 private:
     io_service ioservice_;
     tcp::resolver resolver_;
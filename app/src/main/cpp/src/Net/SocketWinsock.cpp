@@ -103,7 +103,7 @@ bool SocketWinsock::dispatch(const int8_t *bytes, size_t length) const {
            != SOCKET_ERROR;
 }
 
-size_t SocketWinsock::receive(bool *success) {
+size_t SocketWinsock::receive(int8_t *bytes, size_t length, bool *success) {
     timeval timeout = { 0, 0 };
     fd_set sockset = { 0 };
 
@@ -112,7 +112,7 @@ size_t SocketWinsock::receive(bool *success) {
     int result = select(0, &sockset, 0, 0, &timeout);
 
     if (result > 0)
-        result = recv(sock_, (char *)buffer_, MAX_PACKET_LENGTH, 0);
+        result = recv(sock_, (char *)bytes, static_cast<int>(length), 0);
 
     if (result == SOCKET_ERROR) {
         *success = false;
@@ -33,7 +33,7 @@ public:
     bool close();
 
     bool dispatch(const int8_t *bytes, size_t length) const;
-    size_t receive(bool *connected);
+    size_t receive(int8_t *bytes, size_t length, bool *connected);
     const int8_t *get_buffer() const;
 
 private:
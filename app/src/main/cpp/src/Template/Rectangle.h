@@ -15,6 +15,8 @@
 //	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include <algorithm>
+
 #include "Point.h"
 #include "Range.h"
 
@@ -74,6 +76,14 @@ public:
 
     constexpr Range<T> get_vertical() const { return { top(), bottom() }; }
 
+    // Return how far the rectangle extends from the origin on either axis.
+    T reach() const {
+        return std::max({ std::abs(left()),
+                          std::abs(right()),
+                          std::abs(top()),
+                          std::abs(bottom()) });
+    }
+
     void shift(const Point<T> &v) {
         left_top_ = left_top_ + v;
         right_bottom_ = right_bottom_ + v;
@@ -0,0 +1,108 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace ms {
+// Fixed-capacity queue for exactly one producer thread and one consumer
+// thread. Neither side ever blocks or takes a lock.
+template<typename T, size_t N>
+class SpscQueue {
+public:
+    static_assert((N & (N - 1)) == 0, "The capacity must be a power of two");
+
+    // Append a value. Only call from the producer. Returns false when full,
+    // in which case the value is left untouched.
+    bool push(T &&value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - head_.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+
+        slots_[tail & (N - 1)] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Remove the oldest value. Only call from the consumer. Returns false
+    // when empty.
+    bool pop(T &value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = std::move(slots_[head & (N - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Append up to count values, return how many fit. Only call from the
+    // producer.
+    size_t push(const T *values, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t used = tail - head_.load(std::memory_order_acquire);
+        count = std::min(count, N - used);
+
+        for (size_t i = 0; i < count; i++) {
+            slots_[(tail + i) & (N - 1)] = values[i];
+        }
+
+        tail_.store(tail + count, std::memory_order_release);
+
+        return count;
+    }
+
+    // Remove up to count of the oldest values, return how many were
+    // removed. Only call from the consumer.
+    size_t pop(T *values, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t used = tail_.load(std::memory_order_acquire) - head;
+        count = std::min(count, used);
+
+        for (size_t i = 0; i < count; i++) {
+            values[i] = std::move(slots_[(head + i) & (N - 1)]);
+        }
+
+        head_.store(head + count, std::memory_order_release);
+
+        return count;
+    }
+
+    // Number of queued values, may be stale by the time it returns
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    std::array<T, N> slots_;
+    // Kept on separate cache lines so the two threads do not contend
+    alignas(64) std::atomic<size_t> head_ { 0 };
+    alignas(64) std::atomic<size_t> tail_ { 0 };
+};
+}  // namespace ms
@@ -17,12 +17,19 @@
 
 #include <cstdint>
 #include <random>
+#include <type_traits>
 
 namespace ms {
 // Can be used to generate random numbers.
+// All instances on a thread draw from the same xoshiro256** engine, which is
+// seeded once per thread.
 class Randomizer {
 public:
-    bool next_bool() const { return next_int(2) == 1; }
+    // Reseed the engine of the calling thread, making the following draws
+    // reproducible.
+    static void seed(uint64_t value) { engine().seed(value); }
+
+    bool next_bool() const { return (engine().next() >> 63) == 1; }
 
     bool below(float percent) const { return next_real(1.0f) < percent; }
 
@@ -39,11 +46,18 @@ public:
             return from;
         }
 
-        std::uniform_real_distribution<T> range(from, to);
-        std::random_device rd;
-        std::default_random_engine engine { rd() };
+        return from + (to - from) * unit<T>(engine().next());
+    }
+
+    template<class T, class It>
+    // Fill a range with random reals between from and to, excluding to.
+    void next_reals(It first, It last, T from, T to) const {
+        Engine &gen = engine();
 
-        return range(engine);
+        for (; first != last; ++first) {
+            *first = from < to ? from + (to - from) * unit<T>(gen.next())
+                               : from;
+        }
     }
 
     template<class T>
@@ -57,11 +71,10 @@ public:
             return from;
         }
 
-        std::uniform_int_distribution<T> range(from, to - 1);
-        std::random_device rd;
-        std::default_random_engine engine { rd() };
+        auto range = static_cast<uint64_t>(to) - static_cast<uint64_t>(from);
+        auto offset = engine().bounded(range);
 
-        return range(engine);
+        return static_cast<T>(static_cast<uint64_t>(from) + offset);
     }
 
     template<class E>
@@ -76,5 +89,81 @@ public:
 
         return static_cast<E>(next_underlying);
     }
+
+private:
+    // xoshiro256** by David Blackman and Sebastiano Vigna
+    class Engine {
+    public:
+        Engine() {
+            std::random_device rd;
+            seed((static_cast<uint64_t>(rd()) << 32) | rd());
+        }
+
+        // Expand a seed into the full state with splitmix64.
+        void seed(uint64_t value) {
+            for (auto &word : state_) {
+                value += 0x9E3779B97F4A7C15;
+                uint64_t z = value;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        uint64_t next() {
+            uint64_t result = rotl(state_[1] * 5, 7) * 9;
+            uint64_t t = state_[1] << 17;
+
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+            state_[2] ^= t;
+            state_[3] = rotl(state_[3], 45);
+
+            return result;
+        }
+
+        // Return a uniform value below range, using Lemire's nearly
+        // divisionless method.
+        uint64_t bounded(uint64_t range) {
+            __uint128_t product = static_cast<__uint128_t>(next()) * range;
+            auto low = static_cast<uint64_t>(product);
+
+            if (low < range) {
+                uint64_t threshold = -range % range;
+
+                while (low < threshold) {
+                    product = static_cast<__uint128_t>(next()) * range;
+                    low = static_cast<uint64_t>(product);
+                }
+            }
+
+            return static_cast<uint64_t>(product >> 64);
+        }
+
+    private:
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        uint64_t state_[4];
+    };
+
+    static Engine &engine() {
+        thread_local Engine engine;
+
+        return engine;
+    }
+
+    template<class T>
+    // Convert random bits to a value in [0, 1) with the precision of T.
+    static T unit(uint64_t bits) {
+        if constexpr (std::is_same_v<T, float>) {
+            return static_cast<float>(bits >> 40) * 0x1.0p-24f;
+        } else {
+            return static_cast<T>(static_cast<double>(bits >> 11) * 0x1.0p-53);
+        }
+    }
 };
 }  // namespace ms
\ No newline at end of file
@@ -0,0 +1,149 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "RectanglePacker.h"
+
+#include <algorithm>
+
+namespace ms {
+SkylinePacker::SkylinePacker(int16_t width, int16_t height) :
+        width_(width),
+        height_(height) {
+    clear();
+}
+
+SkylinePacker::SkylinePacker() : SkylinePacker(0, 0) {}
+
+void SkylinePacker::clear() {
+    used_ = 0;
+    wasted_ = 0;
+
+    skyline_.clear();
+    skyline_.push_back({0, 0, width_});
+}
+
+int32_t SkylinePacker::fit(size_t index, int16_t width, int16_t height) const {
+    int32_t x = skyline_[index].x;
+
+    if (x + width > width_) {
+        return -1;
+    }
+
+    int32_t y = 0;
+    int32_t remaining = width;
+
+    for (size_t i = index; remaining > 0; i++) {
+        y = std::max<int32_t>(y, skyline_[i].y);
+
+        if (y + height > height_) {
+            return -1;
+        }
+
+        remaining -= skyline_[i].width;
+    }
+
+    return y;
+}
+
+bool SkylinePacker::insert(int16_t width, int16_t height, int16_t &x, int16_t &y) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    size_t best_index = skyline_.size();
+    int32_t best_top = 0;
+    int32_t best_width = 0;
+    int32_t best_y = 0;
+
+    for (size_t i = 0; i < skyline_.size(); i++) {
+        int32_t rest = fit(i, width, height);
+
+        if (rest < 0) {
+            continue;
+        }
+
+        int32_t top = rest + height;
+
+        // Prefer the lowest resulting contour, then the narrowest segment
+        if (best_index == skyline_.size() || top < best_top
+            || (top == best_top && skyline_[i].width < best_width)) {
+            best_index = i;
+            best_top = top;
+            best_width = skyline_[i].width;
+            best_y = rest;
+        }
+    }
+
+    if (best_index == skyline_.size()) {
+        return false;
+    }
+
+    x = skyline_[best_index].x;
+    y = static_cast<int16_t>(best_y);
+
+    // Space between the old contour and the new rectangle is lost
+    int32_t right = x + width;
+
+    for (size_t i = best_index; i < skyline_.size() && skyline_[i].x < right; i++) {
+        int32_t overlap = std::min<int32_t>(right, skyline_[i].x + skyline_[i].width) - skyline_[i].x;
+
+        wasted_ += static_cast<size_t>(overlap) * (best_y - skyline_[i].y);
+    }
+
+    used_ += static_cast<size_t>(width) * height;
+
+    skyline_.insert(skyline_.begin() + best_index,
+                    {x, static_cast<int16_t>(best_top), width});
+
+    // Cut the segments now covered by the new one
+    for (size_t i = best_index + 1; i < skyline_.size();) {
+        Segment &segment = skyline_[i];
+
+        if (segment.x >= right) {
+            break;
+        }
+
+        int16_t shrink = static_cast<int16_t>(right - segment.x);
+
+        if (segment.width <= shrink) {
+            skyline_.erase(skyline_.begin() + i);
+        } else {
+            segment.x += shrink;
+            segment.width -= shrink;
+            break;
+        }
+    }
+
+    // Merge neighbours of equal height
+    for (size_t i = 0; i + 1 < skyline_.size();) {
+        if (skyline_[i].y == skyline_[i + 1].y) {
+            skyline_[i].width += skyline_[i + 1].width;
+            skyline_.erase(skyline_.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    return true;
+}
+
+size_t SkylinePacker::get_used() const {
+    return used_;
+}
+
+size_t SkylinePacker::get_wasted() const {
+    return wasted_;
+}
+}  // namespace ms
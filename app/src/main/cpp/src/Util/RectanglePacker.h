@@ -0,0 +1,75 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ms {
+// Tracks free space in a fixed size area and places rectangles into it
+class RectanglePacker {
+public:
+    virtual ~RectanglePacker() = default;
+
+    // Forget all placed rectangles
+    virtual void clear() = 0;
+
+    // Find a place for a rectangle, return false if there is no room left
+    virtual bool insert(int16_t width, int16_t height, int16_t &x, int16_t &y) = 0;
+
+    // Area covered by placed rectangles
+    virtual size_t get_used() const = 0;
+
+    // Area which can no longer be used by any rectangle
+    virtual size_t get_wasted() const = 0;
+};
+
+// Bottom-left skyline packer: keeps the upper contour of everything placed
+// so far as a list of horizontal segments, and places each rectangle where
+// it raises the contour the least.
+class SkylinePacker : public RectanglePacker {
+public:
+    SkylinePacker(int16_t width, int16_t height);
+
+    SkylinePacker();
+
+    void clear() override;
+
+    bool insert(int16_t width, int16_t height, int16_t &x, int16_t &y) override;
+
+    size_t get_used() const override;
+
+    size_t get_wasted() const override;
+
+private:
+    struct Segment {
+        int16_t x;
+        int16_t y;
+        int16_t width;
+    };
+
+    // Return the height at which a rectangle starting at the segment would rest
+    // or -1 if it does not fit
+    int32_t fit(size_t index, int16_t width, int16_t height) const;
+
+    int16_t width_;
+    int16_t height_;
+    size_t used_;
+    size_t wasted_;
+    std::vector<Segment> skyline_;
+};
+}  // namespace ms
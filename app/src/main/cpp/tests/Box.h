@@ -0,0 +1,48 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Gameplay/MapleMap/MapObject.h"
+
+namespace ms {
+// A map object with fixed bounds that draws nothing
+class Box : public MapObject {
+public:
+    Box(int32_t oid, Point<int16_t> position, Rectangle<int16_t> bounds) :
+        MapObject(oid, position),
+        bounds_(bounds) {}
+
+    void draw(double, double, float) const override {}
+
+    Rectangle<int16_t> get_bounds() const override { return bounds_; }
+
+    void set_bounds(Rectangle<int16_t> bounds) {
+        bounds_ = bounds;
+        reach_changed();
+    }
+
+    // Whether the bounds at the current position overlap the range
+    bool hits(const Rectangle<int16_t> &range) const {
+        Rectangle<int16_t> area = bounds_;
+        area.shift(get_position());
+
+        return area.overlaps(range);
+    }
+
+private:
+    Rectangle<int16_t> bounds_;
+};
+}  // namespace ms
\ No newline at end of file
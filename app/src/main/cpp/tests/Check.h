@@ -0,0 +1,49 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <iostream>
+
+// Minimal assertions for the host-side tests: a failed check is reported
+// and counted, and the test's main returns the result of check_result()
+namespace ms {
+inline int &check_failures() {
+    static int failures = 0;
+
+    return failures;
+}
+
+inline int check_result() {
+    if (check_failures() > 0) {
+        std::cerr << check_failures() << " check(s) failed" << std::endl;
+
+        return 1;
+    }
+
+    return 0;
+}
+}  // namespace ms
+
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " \
+                      << #condition << std::endl;                          \
+            ms::check_failures()++;                                        \
+        }                                                                  \
+    } while (false)
+
+#define CHECK_EQ(first, second) CHECK((first) == (second))
\ No newline at end of file
@@ -0,0 +1,195 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "ReferenceCryptography.h"
+
+#include "Net/Cryptography.h"
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace ms {
+namespace {
+std::vector<size_t> packet_lengths(std::mt19937 &engine) {
+    std::vector<size_t> lengths;
+
+    // Every length around the chunk boundaries, then random ones up to the
+    // longest packet
+    for (size_t length = 0; length <= 3 * 0x5B4; length++) {
+        lengths.push_back(length);
+    }
+
+    std::uniform_int_distribution<size_t> any(0, MAX_PACKET_LENGTH);
+
+    for (size_t i = 0; i < 200; i++) {
+        lengths.push_back(any(engine));
+    }
+
+    lengths.push_back(MAX_PACKET_LENGTH);
+
+    return lengths;
+}
+
+std::vector<int8_t> random_bytes(std::mt19937 &engine, size_t length) {
+    std::vector<int8_t> bytes(length);
+
+    for (int8_t &byte: bytes) {
+        byte = static_cast<int8_t>(engine());
+    }
+
+    return bytes;
+}
+
+// The word-wide maple cipher must match the per-byte one for every length
+// and alignment, and decryption must undo encryption
+void test_maple(std::mt19937 &engine) {
+    int8_t handshake[16] = {};
+    Cryptography cryptography(handshake);
+    ReferenceCryptography reference(handshake);
+
+    std::vector<size_t> lengths = packet_lengths(engine);
+    std::uniform_int_distribution<size_t> misalign(0, 7);
+
+    int failures = ms::check_failures();
+
+    for (size_t length: lengths) {
+        size_t offset = misalign(engine);
+        std::vector<int8_t> plain = random_bytes(engine, length + offset);
+        std::vector<int8_t> bytes = plain;
+        std::vector<int8_t> expected = plain;
+
+        cryptography.mapleencrypt(bytes.data() + offset, length);
+        reference.mapleencrypt(expected.data() + offset, length);
+
+        CHECK(bytes == expected);
+
+        cryptography.mapledecrypt(bytes.data() + offset, length);
+
+        CHECK(bytes == plain);
+
+        bytes = random_bytes(engine, length + offset);
+        expected = bytes;
+
+        cryptography.mapledecrypt(bytes.data() + offset, length);
+        reference.mapledecrypt(expected.data() + offset, length);
+
+        CHECK(bytes == expected);
+
+        if (ms::check_failures() > failures) {
+            std::cerr << "maple cipher differs at length " << length << std::endl;
+            return;
+        }
+    }
+}
+
+void test_aesofb(std::mt19937 &engine) {
+    int8_t handshake[16] = {};
+    Cryptography cryptography(handshake);
+    ReferenceCryptography reference(handshake);
+
+    for (size_t length: packet_lengths(engine)) {
+        std::vector<int8_t> bytes = random_bytes(engine, length);
+        std::vector<int8_t> expected = bytes;
+
+        uint8_t iv[4];
+        uint8_t expected_iv[4];
+
+        for (size_t i = 0; i < 4; i++) {
+            iv[i] = expected_iv[i] = static_cast<uint8_t>(engine());
+        }
+
+        cryptography.aesofb(bytes.data(), length, iv);
+        reference.aesofb(expected.data(), length, expected_iv);
+
+        CHECK(bytes == expected);
+        CHECK(std::memcmp(iv, expected_iv, 4) == 0);
+
+        if (bytes != expected) {
+            std::cerr << "aesofb differs at length " << length << std::endl;
+            return;
+        }
+    }
+}
+
+// Whole packets in sequence, so the ivs have to advance the same way too
+void test_packets(std::mt19937 &engine) {
+    std::vector<int8_t> handshake = random_bytes(engine, 16);
+    Cryptography cryptography(handshake.data());
+    ReferenceCryptography reference(handshake.data());
+
+    // The peer receives with our send iv
+    std::vector<int8_t> peer_handshake = handshake;
+    std::memcpy(peer_handshake.data() + 11, handshake.data() + 7, 4);
+    Cryptography peer(peer_handshake.data());
+
+    int failures = ms::check_failures();
+
+    for (size_t length: packet_lengths(engine)) {
+        std::vector<int8_t> plain = random_bytes(engine, length);
+        std::vector<int8_t> bytes = plain;
+        std::vector<int8_t> expected = plain;
+
+        cryptography.encrypt(bytes.data(), length);
+        reference.encrypt(expected.data(), length);
+
+        CHECK(bytes == expected);
+
+        peer.decrypt(bytes.data(), length);
+
+        CHECK(bytes == plain);
+
+        bytes = random_bytes(engine, length);
+        expected = bytes;
+
+        cryptography.decrypt(bytes.data(), length);
+        reference.decrypt(expected.data(), length);
+
+        CHECK(bytes == expected);
+
+        if (ms::check_failures() > failures) {
+            std::cerr << "packets differ at length " << length << std::endl;
+            return;
+        }
+    }
+}
+
+void test_path(Cryptography::AesPath path, const char *name) {
+    if (!Cryptography::set_aes_path(path)) {
+        std::cout << name << ": not supported by this cpu, skipped" << std::endl;
+        return;
+    }
+
+    std::mt19937 engine(1);
+
+    test_aesofb(engine);
+    test_packets(engine);
+
+    std::cout << name << ": checked" << std::endl;
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    std::mt19937 engine(1);
+    ms::test_maple(engine);
+
+    ms::test_path(ms::Cryptography::AesPath::TABLE, "T-tables");
+    ms::test_path(ms::Cryptography::AesPath::HARDWARE, "hardware AES");
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "FootholdMap.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+namespace ms {
+std::vector<FootholdSpec> make_footholds(size_t chains, int16_t width, uint32_t seed) {
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int32_t> start_x(-width / 2, width / 2);
+    std::uniform_int_distribution<int32_t> start_y(-1500, 1500);
+    std::uniform_int_distribution<int32_t> length(30, 400);
+    std::uniform_int_distribution<int32_t> rise(-60, 60);
+
+    std::vector<FootholdSpec> footholds;
+    uint16_t id = 1;
+
+    for (size_t c = 0; c < chains; c++) {
+        auto layer = static_cast<uint8_t>(c % 8);
+        auto group = static_cast<uint16_t>(c);
+        int32_t x = start_x(engine);
+        int32_t y = start_y(engine);
+        size_t segments = 1 + engine() % 12;
+        bool walls = engine() % 3 == 0;
+        size_t first = footholds.size();
+
+        if (walls) {
+            footholds.push_back({ id++, layer, group,
+                                  static_cast<int16_t>(x), static_cast<int16_t>(y - 200),
+                                  static_cast<int16_t>(x), static_cast<int16_t>(y),
+                                  0, 0 });
+        }
+
+        for (size_t s = 0; s < segments; s++) {
+            int32_t next_x = x + length(engine);
+            int32_t next_y = engine() % 10 < 3 ? y : y + rise(engine);
+
+            footholds.push_back({ id++, layer, group,
+                                  static_cast<int16_t>(x), static_cast<int16_t>(y),
+                                  static_cast<int16_t>(next_x), static_cast<int16_t>(next_y),
+                                  0, 0 });
+
+            x = next_x;
+            y = next_y;
+        }
+
+        if (walls) {
+            footholds.push_back({ id++, layer, group,
+                                  static_cast<int16_t>(x), static_cast<int16_t>(y),
+                                  static_cast<int16_t>(x), static_cast<int16_t>(y - 200),
+                                  0, 0 });
+        }
+
+        for (size_t i = first; i + 1 < footholds.size(); i++) {
+            footholds[i].next = footholds[i + 1].id;
+            footholds[i + 1].prev = footholds[i].id;
+        }
+    }
+
+    return footholds;
+}
+
+size_t add_footholds(NxBuilder &builder, size_t parent, const std::vector<FootholdSpec> &footholds) {
+    size_t root = builder.add(parent, "foothold");
+    std::map<uint8_t, size_t> layers;
+    std::map<uint16_t, size_t> groups;
+
+    for (const FootholdSpec &spec : footholds) {
+        if (layers.count(spec.layer) == 0) {
+            layers[spec.layer] = builder.add(root, std::to_string(spec.layer));
+        }
+
+        if (groups.count(spec.group) == 0) {
+            groups[spec.group] = builder.add(layers[spec.layer], std::to_string(spec.group));
+        }
+
+        size_t node = builder.add(groups[spec.group], std::to_string(spec.id));
+        builder.add_int(node, "x1", spec.x1);
+        builder.add_int(node, "y1", spec.y1);
+        builder.add_int(node, "x2", spec.x2);
+        builder.add_int(node, "y2", spec.y2);
+        builder.add_int(node, "prev", spec.prev);
+        builder.add_int(node, "next", spec.next);
+    }
+
+    return root;
+}
+}  // namespace ms
\ No newline at end of file
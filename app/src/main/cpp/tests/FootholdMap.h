@@ -0,0 +1,45 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "NxBuilder.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ms {
+// One foothold of a synthetic map
+struct FootholdSpec {
+    uint16_t id;
+    uint8_t layer;
+    uint16_t group;
+    int16_t x1;
+    int16_t y1;
+    int16_t x2;
+    int16_t y2;
+    uint16_t prev;
+    uint16_t next;
+};
+
+// Chains of connected floors and slopes spread over a map of the given
+// width, with a wall at the ends of some chains, like the platforms of a
+// real map
+std::vector<FootholdSpec> make_footholds(size_t chains, int16_t width, uint32_t seed);
+
+// Add the footholds as the game files lay them out,
+// foothold/<layer>/<group>/<id>, and return the foothold node
+size_t add_footholds(NxBuilder &builder, size_t parent, const std::vector<FootholdSpec> &footholds);
+}  // namespace ms
\ No newline at end of file
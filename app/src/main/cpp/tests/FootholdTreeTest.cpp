@@ -0,0 +1,183 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "FootholdMap.h"
+#include "ReferenceFootholdTree.h"
+
+#include "Gameplay/Physics/FootholdTree.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace ms {
+namespace {
+// Where a foothold meets the ground at x, like Foothold::ground_below
+double ground(const FootholdSpec &fh, double x) {
+    if (fh.y1 == fh.y2) {
+        return fh.y1;
+    }
+
+    return static_cast<double>(fh.y2 - fh.y1) / (fh.x2 - fh.x1) * (x - fh.x1) + fh.y1;
+}
+
+class Checker {
+public:
+    Checker(const nl::node &src, const std::vector<FootholdSpec> &footholds) :
+        tree_(src),
+        reference_(src),
+        footholds_(footholds),
+        engine_(18) {
+        for (const FootholdSpec &fh : footholds_) {
+            by_id_[fh.id] = &fh;
+
+            if (fh.x1 != fh.x2) {
+                floors_.push_back(&fh);
+            }
+        }
+    }
+
+    // Ground below any point of the map, including outside of it
+    void check_y_below() {
+        CHECK(tree_.get_walls() == reference_.get_walls());
+        CHECK(tree_.get_borders() == reference_.get_borders());
+
+        std::uniform_int_distribution<int16_t> x(-12000, 12000);
+        std::uniform_int_distribution<int16_t> y(-2500, 2500);
+
+        for (size_t i = 0; i < 200000; i++) {
+            Point<int16_t> position(x(engine_), y(engine_));
+
+            CHECK_EQ(tree_.get_y_below(position), reference_.get_y_below(position));
+        }
+    }
+
+    // The foothold an object lands on or walks onto, with the other state
+    // update_fh derives from it
+    void check_update_fh() {
+        std::uniform_int_distribution<int16_t> x(-12000, 12000);
+        std::uniform_int_distribution<int16_t> y(-2500, 2500);
+        std::uniform_int_distribution<size_t> any(0, floors_.size() - 1);
+
+        for (size_t i = 0; i < 100000; i++) {
+            PhysicsObject phobj;
+
+            if (i % 2 == 0) {
+                // Falling through the air
+                phobj.onground = false;
+                phobj.set_x(x(engine_) + 0.5 * (engine_() % 2));
+                phobj.set_y(y(engine_));
+                phobj.vspeed = 2.0;
+            } else {
+                // Walking along a floor or slope, possibly past one of its
+                // ends
+                const FootholdSpec &fh = *floors_[any(engine_)];
+                std::uniform_int_distribution<int32_t> along(std::min(fh.x1, fh.x2) - 10,
+                                                             std::max(fh.x1, fh.x2) + 10);
+                double at = along(engine_);
+
+                phobj.fhid = fh.id;
+                phobj.fhlayer = fh.layer;
+                phobj.set_x(at);
+                phobj.set_y(ground(fh, at));
+                phobj.hspeed = engine_() % 2 ? 1.5 : -1.5;
+            }
+
+            if (engine_() % 4 == 0) {
+                phobj.set_flag(PhysicsObject::Flag::CHECK_BELOW);
+            }
+
+            PhysicsObject expected = phobj;
+            tree_.update_fh(phobj);
+            reference_.update_fh(expected);
+
+            CHECK_EQ(phobj.crnt_y(), expected.crnt_y());
+            CHECK_EQ(phobj.crnt_x(), expected.crnt_x());
+            CHECK_EQ(phobj.onground, expected.onground);
+            CHECK_EQ(phobj.enablejd, expected.enablejd);
+
+            // Footholds which meet at the same point are equally right
+            if (phobj.fhid == expected.fhid) {
+                CHECK_EQ(phobj.fhlayer, expected.fhlayer);
+                // Walking off the end of a chain takes the slope of the null
+                // foothold, which is not a number
+                CHECK(phobj.fhslope == expected.fhslope
+                      || (std::isnan(phobj.fhslope) && std::isnan(expected.fhslope)));
+            } else {
+                CHECK(same_ground(phobj.fhid, expected.fhid, phobj.crnt_x()));
+            }
+        }
+    }
+
+private:
+    bool same_ground(uint16_t first, uint16_t second, double x) const {
+        if (by_id_.count(first) == 0 || by_id_.count(second) == 0) {
+            return false;
+        }
+
+        return ground(*by_id_.at(first), x) == ground(*by_id_.at(second), x);
+    }
+
+    FootholdTree tree_;
+    ReferenceFootholdTree reference_;
+    const std::vector<FootholdSpec> &footholds_;
+    std::unordered_map<uint16_t, const FootholdSpec *> by_id_;
+    std::vector<const FootholdSpec *> floors_;
+    std::mt19937 engine_;
+};
+
+void test_map(size_t chains, int16_t width, uint32_t seed) {
+    std::vector<FootholdSpec> footholds = make_footholds(chains, width, seed);
+
+    NxBuilder builder;
+    add_footholds(builder, NxBuilder::ROOT, footholds);
+
+    std::string path = (std::filesystem::temp_directory_path() / "FootholdTreeTest.nx").string();
+    CHECK(builder.write(path));
+
+    {
+        nl::file file(path);
+        Checker checker(file.root()["foothold"], footholds);
+
+        checker.check_y_below();
+        checker.check_update_fh();
+    }
+
+    std::filesystem::remove(path);
+}
+
+// A map without footholds has nothing below anything
+void test_empty() {
+    FootholdTree tree;
+    ReferenceFootholdTree reference;
+
+    CHECK_EQ(tree.get_y_below({ 0, 0 }), reference.get_y_below({ 0, 0 }));
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_map(1500, 20000, 1);
+    ms::test_map(40, 3000, 2);
+    ms::test_empty();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,426 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "NxBuilder.h"
+
+#include "Character/Look/ImpostorCache.h"
+#include "Graphics/GraphicsGL.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ms {
+namespace {
+// A textured quad as the atlas would draw it
+struct Quad {
+    const uint8_t *pixels;
+    int16_t width;
+    int16_t height;
+    Rectangle<int16_t> rect;
+};
+
+struct StoredImage {
+    int16_t width;
+    int16_t height;
+    std::vector<uint8_t> pixels;
+};
+
+// What the stand-in atlas was asked to draw
+std::vector<std::vector<uint8_t>> decoded;
+std::vector<Quad> quads;
+std::unordered_map<uint64_t, StoredImage> images;
+}  // namespace
+
+// Stand-ins for the atlas, which needs a GL context. Quads are recorded with
+// their decoded pixels so that the frame they make can be blended on the CPU.
+GraphicsGL::GraphicsGL() = default;
+
+void GraphicsGL::add_bitmap(const nl::bitmap &) {}
+
+void GraphicsGL::draw(const nl::bitmap &bmp,
+                      const Rectangle<int16_t> &rect,
+                      const Color &,
+                      float) {
+    decoded.emplace_back(bmp.length() + 0x20);
+    bmp.decode(decoded.back().data());
+    quads.push_back({ decoded.back().data(), static_cast<int16_t>(bmp.width()),
+                      static_cast<int16_t>(bmp.height()), rect });
+}
+
+bool GraphicsGL::add_image(uint64_t id, int16_t width, int16_t height, const void *pixels) {
+    auto *begin = static_cast<const uint8_t *>(pixels);
+    images[id] = { width, height, std::vector<uint8_t>(begin, begin + width * height * 4) };
+
+    return true;
+}
+
+bool GraphicsGL::draw_image(uint64_t id,
+                            const Rectangle<int16_t> &rect,
+                            const Color &,
+                            float) {
+    auto iter = images.find(id);
+
+    if (iter == images.end()) {
+        return false;
+    }
+
+    const StoredImage &image = iter->second;
+    quads.push_back({ image.pixels.data(), image.width, image.height, rect });
+
+    return true;
+}
+
+void GraphicsGL::remove_image(uint64_t id) {
+    images.erase(id);
+}
+
+namespace {
+const int16_t SCREEN_WIDTH = 400;
+const int16_t SCREEN_HEIGHT = 300;
+
+// Blend a quad into a framebuffer with GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+// without rounding. Quads drawn flipped have their left edge on the right.
+void blend(std::vector<float> &frame, const Quad &quad) {
+    bool flipped = quad.rect.left() > quad.rect.right();
+    int16_t left = std::min(quad.rect.left(), quad.rect.right());
+
+    for (int16_t y = 0; y < quad.height; y++) {
+        for (int16_t x = 0; x < quad.width; x++) {
+            int32_t fx = flipped ? quad.rect.left() - 1 - x : left + x;
+            int32_t fy = quad.rect.top() + y;
+
+            if (fx < 0 || fx >= SCREEN_WIDTH || fy < 0 || fy >= SCREEN_HEIGHT) {
+                continue;
+            }
+
+            const uint8_t *src = quad.pixels + (y * quad.width + x) * 4;
+            float *dst = frame.data() + (fy * SCREEN_WIDTH + fx) * 3;
+            float alpha = src[3] / 255.0f;
+
+            for (size_t c = 0; c < 3; c++) {
+                dst[c] = src[c] * alpha + dst[c] * (1.0f - alpha);
+            }
+        }
+    }
+}
+
+std::vector<float> make_background(std::mt19937 &engine) {
+    std::vector<float> frame(SCREEN_WIDTH * SCREEN_HEIGHT * 3);
+
+    for (float &value : frame) {
+        value = static_cast<float>(engine() % 256);
+    }
+
+    return frame;
+}
+
+// Largest difference between two frames once they are stored with 8 bits
+int32_t max_difference(const std::vector<float> &first, const std::vector<float> &second) {
+    int32_t worst = 0;
+
+    for (size_t i = 0; i < first.size(); i++) {
+        auto difference = static_cast<int32_t>(std::lround(first[i]) - std::lround(second[i]));
+        worst = std::max(worst, std::abs(difference));
+    }
+
+    return worst;
+}
+
+// Random pixels with a mix of transparent, opaque and translucent ones
+std::vector<uint8_t> make_pixels(std::mt19937 &engine, int16_t width, int16_t height) {
+    std::vector<uint8_t> pixels(width * height * 4);
+
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i] = static_cast<uint8_t>(engine());
+        pixels[i + 1] = static_cast<uint8_t>(engine());
+        pixels[i + 2] = static_cast<uint8_t>(engine());
+
+        switch (engine() % 4) {
+            case 0: pixels[i + 3] = 0; break;
+            case 1: pixels[i + 3] = 255; break;
+            default: pixels[i + 3] = static_cast<uint8_t>(engine()); break;
+        }
+    }
+
+    return pixels;
+}
+
+// One composed image drawn over a frame must look like its layers drawn one
+// by one, including layers which are cut off by the image's edges
+void test_compose() {
+    std::mt19937 engine(7);
+    int32_t worst = 0;
+
+    for (size_t trial = 0; trial < 200; trial++) {
+        const int16_t width = 96;
+        const int16_t height = 96;
+
+        std::vector<std::vector<uint8_t>> pixels;
+        std::vector<ImpostorCache::Layer> layers;
+        size_t count = 20 + engine() % 21;
+
+        for (size_t i = 0; i < count; i++) {
+            auto w = static_cast<int16_t>(8 + engine() % 48);
+            auto h = static_cast<int16_t>(8 + engine() % 48);
+            auto x = static_cast<int16_t>(static_cast<int32_t>(engine() % (width - w + 16)) - 8);
+            auto y = static_cast<int16_t>(static_cast<int32_t>(engine() % (height - h + 16)) - 8);
+
+            pixels.push_back(make_pixels(engine, w, h));
+            layers.push_back({ pixels.back().data(), w, h, x, y });
+        }
+
+        std::vector<float> expected = make_background(engine);
+        std::vector<float> actual = expected;
+
+        // The image's edges are the edges of the screen here
+        Rectangle<int16_t> screen(0, width, 0, height);
+
+        for (const ImpostorCache::Layer &layer : layers) {
+            Rectangle<int16_t> rect(layer.x,
+                                    static_cast<int16_t>(layer.x + layer.width),
+                                    layer.y,
+                                    static_cast<int16_t>(layer.y + layer.height));
+
+            if (rect.overlaps(screen)) {
+                Quad quad = { layer.pixels, layer.width, layer.height, rect };
+
+                // Clip to the image like compose does
+                size_t length = static_cast<size_t>(layer.width) * layer.height * 4;
+                std::vector<uint8_t> clipped(layer.pixels, layer.pixels + length);
+
+                for (int16_t py = 0; py < layer.height; py++) {
+                    for (int16_t px = 0; px < layer.width; px++) {
+                        int32_t ix = layer.x + px;
+                        int32_t iy = layer.y + py;
+
+                        if (ix < 0 || ix >= width || iy < 0 || iy >= height) {
+                            clipped[(py * layer.width + px) * 4 + 3] = 0;
+                        }
+                    }
+                }
+
+                quad.pixels = clipped.data();
+                blend(expected, quad);
+            }
+        }
+
+        std::vector<uint8_t> image;
+        ImpostorCache::compose(layers, width, height, image);
+        CHECK_EQ(image.size(), static_cast<size_t>(width * height * 4));
+
+        blend(actual, { image.data(), width, height, screen });
+
+        worst = std::max(worst, max_difference(expected, actual));
+    }
+
+    // Only rounding the image to 8 bits per channel may differ
+    CHECK(worst <= 1);
+    std::cout << "compose: largest difference " << worst << "/255" << std::endl;
+}
+
+class Parts {
+public:
+    Parts(size_t looks, size_t parts, uint32_t seed) :
+        path_((std::filesystem::temp_directory_path() / "ImpostorCacheTest.nx").string()),
+        lists_(looks) {
+        std::mt19937 engine(seed);
+        NxBuilder builder;
+
+        for (size_t look = 0; look < looks; look++) {
+            size_t node = builder.add(NxBuilder::ROOT, std::to_string(look));
+
+            for (size_t part = 0; part < parts; part++) {
+                auto w = static_cast<uint16_t>(4 + engine() % 40);
+                auto h = static_cast<uint16_t>(4 + engine() % 40);
+                std::vector<uint8_t> pixels = make_pixels(engine, w, h);
+
+                size_t bitmap = builder.add_bitmap(node, std::to_string(part), w, h, pixels);
+                builder.add_vector(bitmap,
+                                   "origin",
+                                   static_cast<int32_t>(engine() % 40) - 20,
+                                   static_cast<int32_t>(engine() % 60));
+            }
+        }
+
+        CHECK(builder.write(path_));
+        file_ = std::make_unique<nl::file>(path_);
+
+        // Textures must not move once they are in a list
+        textures_.reserve(looks * parts);
+
+        for (size_t look = 0; look < looks; look++) {
+            for (size_t part = 0; part < parts; part++) {
+                textures_.emplace_back(file_->root()[std::to_string(look)][std::to_string(part)]);
+
+                // Some parts follow the face, like the eyes and hats
+                Point<int16_t> shift;
+
+                if (part % 3 == 0) {
+                    shift = Point<int16_t>(static_cast<int16_t>(engine() % 9) - 4,
+                                           static_cast<int16_t>(engine() % 9) - 4);
+                }
+
+                lists_[look].add(textures_.back(), shift);
+            }
+        }
+    }
+
+    ~Parts() {
+        textures_.clear();
+        file_.reset();
+        std::filesystem::remove(path_);
+    }
+
+    const DrawList &get(size_t look) const { return lists_[look]; }
+
+private:
+    std::string path_;
+    std::unique_ptr<nl::file> file_;
+    std::vector<Texture> textures_;
+    std::vector<DrawList> lists_;
+};
+
+// A character drawn as an image, placed by ImpostorCache::create, must look
+// like its parts drawn one by one, flipped or not
+void test_draw() {
+    Parts parts(4, 25, 11);
+    ImpostorCache impostors;
+    std::mt19937 engine(12);
+
+    impostors.update(100);
+    impostors.set_enabled(true);
+    CHECK(impostors.is_enabled());
+
+    for (size_t look = 0; look < 4; look++) {
+        const DrawList &list = parts.get(look);
+        DrawArgument args(Point<int16_t>(200, 150), look % 2 == 1);
+
+        std::vector<float> expected = make_background(engine);
+        std::vector<float> actual = expected;
+
+        quads.clear();
+        list.draw(args);
+
+        for (const Quad &quad : quads) {
+            blend(expected, quad);
+        }
+
+        quads.clear();
+        impostors.update(100);
+        CHECK(impostors.draw(look + 1, list, args));
+        CHECK_EQ(quads.size(), static_cast<size_t>(1));
+
+        for (const Quad &quad : quads) {
+            blend(actual, quad);
+        }
+
+        CHECK(max_difference(expected, actual) <= 1);
+    }
+
+    decoded.clear();
+    quads.clear();
+}
+
+// Quads per frame of a crowded map, with every character drawn by parts and
+// with the cache
+void test_quads_saved() {
+    const size_t LOOKS = 10;
+    const size_t PARTS = 25;
+    const size_t CHARACTERS = 60;
+    const size_t FRAMES = 30;
+
+    Parts parts(LOOKS, PARTS, 21);
+    ImpostorCache impostors;
+
+    size_t layered = 0;
+    size_t drawn = 0;
+    uint64_t saved = 0;
+
+    for (size_t frame = 0; frame < FRAMES; frame++) {
+        impostors.update(CHARACTERS);
+        impostors.set_enabled(true);
+
+        layered = 0;
+        drawn = 0;
+
+        for (size_t i = 0; i < CHARACTERS; i++) {
+            const DrawList &list = parts.get(i % LOOKS);
+            DrawArgument args(Point<int16_t>(static_cast<int16_t>(i * 6), 150), i % 2 == 0);
+
+            layered += list.size();
+
+            if (impostors.draw(i % LOOKS + 1, list, args)) {
+                drawn++;
+                saved += list.size() - 1;
+            } else {
+                drawn += list.size();
+            }
+        }
+    }
+
+    // A few images are composed per update, after which every character
+    // is one quad
+    ImpostorCache::Stats stats = impostors.get_stats();
+    CHECK_EQ(drawn, CHARACTERS);
+    CHECK_EQ(stats.images, LOOKS);
+    CHECK_EQ(stats.misses, static_cast<uint64_t>(LOOKS));
+    CHECK_EQ(stats.quads_saved, saved);
+    CHECK_EQ(stats.hits + stats.misses + stats.fallbacks,
+             static_cast<uint64_t>(CHARACTERS * FRAMES));
+
+    std::cout << "quads per frame for " << CHARACTERS << " characters: " << layered
+              << " by parts, " << drawn << " with images" << std::endl;
+
+    // Below the threshold, or when the parts would be transformed, the parts
+    // are drawn
+    impostors.update(1);
+    impostors.set_enabled(true);
+    CHECK(!impostors.is_enabled());
+
+    impostors.update(CHARACTERS);
+    uint64_t fallbacks = impostors.get_stats().fallbacks;
+    DrawArgument rotated(90.0f, Point<int16_t>(100, 100), 1.0f);
+    CHECK(!impostors.draw(1, parts.get(0), rotated));
+    CHECK_EQ(impostors.get_stats().fallbacks, fallbacks + 1);
+
+    impostors.clear();
+    CHECK(images.empty());
+
+    decoded.clear();
+    quads.clear();
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    // Configuration saves its file into the working directory
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+    ms::test_compose();
+    ms::test_draw();
+    ms::test_quads_saved();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+
+#include "Gameplay/MapleMap/MapObjects.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace ms {
+namespace {
+std::vector<int32_t> drawn;
+
+// Draws by recording its oid and moves to whichever layer it is told to,
+// -1 removing it
+class Marker : public MapObject {
+public:
+    Marker(int32_t oid, int8_t layer) : MapObject(oid), next_layer_(layer) {
+        phobj_.fhlayer = layer;
+    }
+
+    void draw(double, double, float) const override { drawn.push_back(oid_); }
+
+    int8_t update(const Physics &) override {
+        if (next_layer_ >= 0) {
+            phobj_.fhlayer = next_layer_;
+        }
+
+        return next_layer_;
+    }
+
+    void move_to(int8_t layer) { next_layer_ = layer; }
+
+private:
+    int8_t next_layer_;
+};
+
+std::vector<int32_t> draw_layer(const MapObjects &objects, Layer::Id layer) {
+    drawn.clear();
+    objects.draw(layer, 0.0, 0.0, 1.0f);
+
+    return drawn;
+}
+
+Marker &marker(MapObjects &objects, int32_t oid) {
+    return objects.get<Marker>(oid)->get();
+}
+
+// Each layer draws its objects in oid order, whatever order they were added
+// in and however they moved between layers
+void test_draw_order() {
+    std::vector<int32_t> oids(200);
+    std::iota(oids.begin(), oids.end(), 100);
+    std::shuffle(oids.begin(), oids.end(), std::mt19937(17));
+
+    MapObjects objects;
+
+    for (int32_t oid : oids) {
+        objects.add(std::make_unique<Marker>(oid, static_cast<int8_t>(oid % 2)));
+    }
+
+    std::vector<int32_t> even;
+    std::vector<int32_t> odd;
+
+    for (int32_t oid = 100; oid < 300; oid++) {
+        (oid % 2 ? odd : even).push_back(oid);
+    }
+
+    CHECK(draw_layer(objects, Layer::ZERO) == even);
+    CHECK(draw_layer(objects, Layer::ONE) == odd);
+
+    // Move every fourth object to layer two and drop every tenth
+    for (int32_t oid = 100; oid < 300; oid++) {
+        if (oid % 10 == 0) {
+            marker(objects, oid).move_to(-1);
+        } else if (oid % 4 == 1) {
+            marker(objects, oid).move_to(Layer::TWO);
+        }
+    }
+
+    Physics physics;
+    objects.update(physics);
+
+    std::vector<int32_t> expected[3];
+
+    for (int32_t oid = 100; oid < 300; oid++) {
+        if (oid % 10 == 0) {
+            CHECK(!objects.contains(oid));
+        } else if (oid % 4 == 1) {
+            expected[2].push_back(oid);
+        } else {
+            expected[oid % 2].push_back(oid);
+        }
+    }
+
+    CHECK(draw_layer(objects, Layer::ZERO) == expected[0]);
+    CHECK(draw_layer(objects, Layer::ONE) == expected[1]);
+    CHECK(draw_layer(objects, Layer::TWO) == expected[2]);
+    CHECK_EQ(objects.size(), 180u);
+}
+
+// A handle stops resolving once its object is removed, even after another
+// object reuses the slot
+void test_handles() {
+    MapObjects objects;
+
+    objects.add(std::make_unique<Marker>(1, 0));
+    objects.add(std::make_unique<Marker>(2, 0));
+
+    MapObjects::Handle first = objects.get_handle(1);
+    MapObjects::Handle second = objects.get_handle(2);
+
+    CHECK(objects.get<Marker>(first).has_value());
+    CHECK_EQ(objects.get<Marker>(second)->get().get_oid(), 2);
+
+    objects.remove(1);
+    objects.add(std::make_unique<Marker>(3, 0));
+
+    MapObjects::Handle third = objects.get_handle(3);
+
+    CHECK_EQ(third.slot, first.slot);
+    CHECK(!objects.get<Marker>(first).has_value());
+    CHECK_EQ(objects.get<Marker>(third)->get().get_oid(), 3);
+    CHECK_EQ(objects.get<Marker>(second)->get().get_oid(), 2);
+    CHECK(!objects.get<Marker>(objects.get_handle(1)).has_value());
+
+    // Adding an oid again replaces the object and its handle
+    objects.add(std::make_unique<Marker>(2, 1));
+
+    CHECK(!objects.get<Marker>(second).has_value());
+    CHECK(objects.get<Marker>(objects.get_handle(2)).has_value());
+    CHECK(draw_layer(objects, Layer::ZERO) == std::vector<int32_t>({ 3 }));
+    CHECK(draw_layer(objects, Layer::ONE) == std::vector<int32_t>({ 2 }));
+
+    objects.clear();
+
+    CHECK(!objects.get<Marker>(third).has_value());
+    CHECK_EQ(objects.size(), 0u);
+    CHECK(draw_layer(objects, Layer::ZERO).empty());
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    // Configuration saves its file into the working directory
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+    ms::test_draw_order();
+    ms::test_handles();
+
+    return ms::check_result();
+}
\ No newline at end of file
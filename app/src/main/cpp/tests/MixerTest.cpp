@@ -0,0 +1,272 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+
+#include "Audio/Mixer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace ms {
+namespace {
+bool close_to(float first, float second) {
+    return std::fabs(first - second) <= 1e-6f * (1.0f + std::fabs(second));
+}
+
+// The vectorized accumulate matches a plain loop for any frame count,
+// including the odd ones which end with a single frame
+void test_accumulate() {
+    std::mt19937 engine(22);
+    std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+
+    for (size_t frames = 0; frames < 40; frames++) {
+        std::vector<float> in(frames * 2);
+        std::vector<float> out(frames * 2);
+
+        for (size_t i = 0; i < in.size(); i++) {
+            in[i] = sample(engine);
+            out[i] = sample(engine);
+        }
+
+        float left = sample(engine);
+        float right = sample(engine);
+        std::vector<float> expected = out;
+
+        for (size_t i = 0; i < frames; i++) {
+            expected[i * 2] += in[i * 2] * left;
+            expected[i * 2 + 1] += in[i * 2 + 1] * right;
+        }
+
+        Mixer::accumulate(out.data(), in.data(), frames, left, right);
+
+        for (size_t i = 0; i < out.size(); i++) {
+            CHECK(close_to(out[i], expected[i]));
+        }
+    }
+}
+
+void test_clip_and_ramp() {
+    std::vector<float> signal = { -3.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 1.5f, 2.0f };
+    Mixer::clip(signal.data(), 4);
+
+    std::vector<float> clipped = { -1.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 1.0f, 1.0f };
+    CHECK(signal == clipped);
+
+    // The gain starts at the first value and moves towards the second by an
+    // equal step per frame
+    std::vector<float> ones(8, 1.0f);
+    Mixer::ramp(ones.data(), 4, 0.0f, 1.0f);
+
+    for (size_t i = 0; i < 4; i++) {
+        CHECK(close_to(ones[i * 2], i * 0.25f));
+        CHECK(close_to(ones[i * 2 + 1], i * 0.25f));
+    }
+}
+
+// A sound of constant value, long enough to outlast the test
+std::shared_ptr<const Mixer::Pcm> constant(float value) {
+    return std::make_shared<Mixer::Pcm>(Mixer::RATE * 2, value);
+}
+
+// Mix one frame and return the left channel, the sum of the voices
+float mix_one(Mixer &mixer) {
+    float frame[2];
+    mixer.mix(frame, 1);
+
+    return frame[0];
+}
+
+// A full mixer replaces the oldest voice of the lowest priority which is not
+// above the new sound's, and drops the sound if there is none
+void test_voice_stealing() {
+    Mixer mixer(4);
+    auto a = constant(1.0f / 64);
+    auto b = constant(2.0f / 64);
+    auto c = constant(4.0f / 64);
+    auto d = constant(8.0f / 64);
+    auto e = constant(16.0f / 64);
+
+    CHECK(mixer.play(a, 1.0f, 0.0f, 1));
+    CHECK(mixer.play(b, 1.0f, 0.0f, 0));
+    CHECK(mixer.play(c, 1.0f, 0.0f, 0));
+    CHECK(mixer.play(d, 1.0f, 0.0f, 1));
+    CHECK(close_to(mix_one(mixer), 15.0f / 64));
+
+    // b is the oldest of the lowest priority
+    CHECK(mixer.play(e, 1.0f, 0.0f, 0));
+    CHECK(close_to(mix_one(mixer), 29.0f / 64));
+
+    // Lower than every voice
+    CHECK(!mixer.play(b, 1.0f, 0.0f, -1));
+    CHECK(close_to(mix_one(mixer), 29.0f / 64));
+
+    // c is older than e
+    CHECK(mixer.play(b, 1.0f, 0.0f, 2));
+    CHECK(close_to(mix_one(mixer), 27.0f / 64));
+
+    // e is the last voice of priority 0
+    CHECK(mixer.play(c, 1.0f, 0.0f, 1));
+    CHECK(close_to(mix_one(mixer), 15.0f / 64));
+
+    // b has a higher priority, a is the oldest of the rest
+    CHECK(mixer.play(e, 1.0f, 0.0f, 1));
+    CHECK(close_to(mix_one(mixer), 30.0f / 64));
+
+    Mixer::Stats stats = mixer.get_stats();
+    CHECK_EQ(stats.voices, 4u);
+    CHECK_EQ(stats.peak_voices, 4u);
+    CHECK_EQ(stats.stolen, 4u);
+    CHECK_EQ(stats.dropped, 1u);
+    CHECK_EQ(stats.played, 8u);
+
+    mixer.stop(e.get());
+    CHECK(close_to(mix_one(mixer), 14.0f / 64));
+}
+
+// One sound plays at most four times at once, a fifth restarts the oldest
+void test_instances() {
+    Mixer mixer(16);
+
+    // Four frames, of which only the last is heard
+    auto sound = std::make_shared<Mixer::Pcm>(8, 0.0f);
+    (*sound)[6] = 1.0f;
+
+    for (size_t i = 0; i < 4; i++) {
+        mixer.play(sound, 1.0f, 0.0f, 0);
+        mix_one(mixer);
+    }
+
+    // The first copy has ended, the others are at frames 3, 2 and 1
+    CHECK_EQ(mixer.get_stats().voices, 3u);
+
+    mixer.play(sound, 1.0f, 0.0f, 0);
+    mixer.play(sound, 1.0f, 0.0f, 0);
+    CHECK_EQ(mixer.get_stats().voices, 4u);
+    CHECK_EQ(mixer.get_stats().stolen, 1u);
+
+    // Had the copy at frame 3 not been restarted, it would be heard now
+    CHECK(mix_one(mixer) == 0.0f);
+    CHECK(mix_one(mixer) == 1.0f);
+
+    // A sound plays until its last copy has ended
+    CHECK(mixer.is_playing(sound.get()));
+
+    for (size_t i = 0; i < 4; i++) {
+        mix_one(mixer);
+    }
+
+    CHECK(!mixer.is_playing(sound.get()));
+}
+
+// Streams are mixed with their gain, fade without jumps and are removed once
+// their source runs out
+void test_streams() {
+    Mixer mixer;
+    size_t remaining = 300;
+
+    uint64_t stream = mixer.add_stream([&remaining](float *out, size_t frames) {
+        size_t count = std::min(frames, remaining);
+        std::fill(out, out + count * 2, 0.5f);
+        remaining -= count;
+
+        return count;
+    });
+
+    float frames[200];
+    mixer.mix(frames, 100);
+    CHECK(frames[0] == 0.0f);
+
+    mixer.start_stream(stream);
+    mixer.set_stream_gain(stream, 0.5f);
+    mixer.mix(frames, 100);
+
+    CHECK(close_to(frames[0], 0.5f));
+    CHECK(close_to(frames[198], 0.5f * (1.0f - 0.5f * 99 / 100)));
+
+    mixer.mix(frames, 100);
+    CHECK(close_to(frames[0], 0.25f));
+
+    // The last 100 frames, the mix after that finds the source empty
+    mixer.mix(frames, 100);
+    mixer.set_stream_gain(stream, 1.0f);
+    mixer.mix(frames, 100);
+    CHECK(frames[0] == 0.0f);
+    CHECK_EQ(remaining, 0u);
+}
+
+// The game thread can play sounds and change gains while a stream's source
+// is running
+void test_source_without_lock() {
+    Mixer mixer;
+    std::atomic<bool> entered(false);
+    std::atomic<bool> released(false);
+    std::atomic<bool> timed_out(false);
+
+    uint64_t stream = mixer.add_stream([&](float *out, size_t frames) {
+        entered = true;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while (!released && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+
+        timed_out = !released;
+        std::fill(out, out + frames * 2, 0.0f);
+
+        return frames;
+    });
+
+    mixer.start_stream(stream);
+
+    std::thread audio([&mixer]() {
+        float frames[64];
+        mixer.mix(frames, 32);
+    });
+
+    while (!entered) {
+        std::this_thread::yield();
+    }
+
+    CHECK(mixer.play(constant(0.1f), 1.0f, 0.0f, 0));
+    mixer.set_stream_gain(stream, 0.5f);
+    mixer.remove_stream(stream);
+
+    released = true;
+    audio.join();
+
+    // Had any of these waited for the mix, the source would have timed out
+    CHECK(!timed_out);
+
+    CHECK(close_to(mix_one(mixer), 0.1f));
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_accumulate();
+    ms::test_clip_and_ramp();
+    ms::test_voice_stealing();
+    ms::test_instances();
+    ms::test_streams();
+    ms::test_source_without_lock();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+
+#include "Configuration.h"
+#include "Constants.h"
+#include "Gameplay/MovementRecorder.h"
+#include "Net/PacketSwitch.h"
+#include "glfm.h"
+
+#include <filesystem>
+#include <vector>
+
+// The recorder's packets go through the real session, which is never
+// connected here and drops them. Incoming packets have no handlers.
+void *glfmGetAndroidActivity(GLFMDisplay *) {
+    return nullptr;
+}
+
+namespace ms {
+PacketSwitch::PacketSwitch() = default;
+
+void PacketSwitch::forward(int8_t *, size_t) const {}
+
+namespace {
+const uint8_t WALK = 2;
+const uint8_t JUMP = 6;
+const uint16_t GROUND = 5;
+
+// Bytes of a movement packet: opcode, nine skipped bytes and the count,
+// then every fragment
+uint64_t packet_length(uint64_t fragments) {
+    return 12 + 14 * fragments;
+}
+
+// A player walking right two pixels per tick, jumping and landing again
+class Walker {
+public:
+    Movement walk() {
+        x_ += 2;
+
+        return Movement(Movement::ABSOLUTE, 0, x_, y_, x_ - 2, y_, GROUND,
+                        WALK, 1);
+    }
+
+    Movement jump() {
+        if (!airborne_) {
+            airborne_ = true;
+            vspeed_ = -8;
+        }
+
+        x_ += 2;
+        y_ += vspeed_;
+        int16_t lasty = y_ - vspeed_;
+        vspeed_++;
+
+        if (y_ >= 0) {
+            y_ = 0;
+            airborne_ = false;
+        }
+
+        return Movement(Movement::ABSOLUTE, 0, x_, y_, x_ - 2, lasty, 0, JUMP,
+                        1);
+    }
+
+    // Whether the last jump has come back down to the ground
+    bool landed() const { return !airborne_; }
+
+private:
+    int16_t x_ = 0;
+    int16_t y_ = 0;
+    int16_t vspeed_ = 0;
+    bool airborne_ = false;
+};
+
+// Records one movement and returns how many fragments were sent with it,
+// zero if nothing was sent. Every packet's bytes must be counted.
+uint64_t record(MovementRecorder &recorder, const Movement &movement) {
+    MovementRecorder::Stats before = recorder.get_stats();
+    recorder.record(movement);
+    const MovementRecorder::Stats &after = recorder.get_stats();
+
+    if (after.packets == before.packets) {
+        CHECK_EQ(after.fragments, before.fragments);
+        CHECK_EQ(after.bytes, before.bytes);
+
+        return 0;
+    }
+
+    uint64_t fragments = after.fragments - before.fragments;
+    CHECK_EQ(after.packets, before.packets + 1);
+    CHECK_EQ(after.bytes, before.bytes + packet_length(fragments));
+
+    return fragments;
+}
+
+// Straight walking is merged into one fragment and sent every interval, a
+// new stance is sent right away and the airborne ticks of a jump all become
+// fragments of their own. The interval is only read again on clear.
+void test_flush_points() {
+    // Five ticks, the tick which starts a fragment does not count
+    Setting<MovementInterval>::get().save(5 * Constants::TIMESTEP);
+    MovementRecorder recorder;
+    Setting<MovementInterval>::get().save(50 * Constants::TIMESTEP);
+
+    Walker walker;
+    std::vector<std::pair<size_t, uint64_t>> sent;
+    size_t tick = 0;
+
+    for (; tick < 15; tick++) {
+        if (uint64_t fragments = record(recorder, walker.walk())) {
+            sent.emplace_back(tick, fragments);
+        }
+    }
+
+    // The first step changes the stance, then one fragment per interval
+    std::vector<std::pair<size_t, uint64_t>> expected = {
+        { 0, 1 }, { 6, 1 }, { 12, 1 }
+    };
+    CHECK(sent == expected);
+
+    // Jumping sends the last steps and the first jump fragment at once
+    CHECK_EQ(record(recorder, walker.jump()), uint64_t(2));
+    sent.clear();
+
+    for (tick = 1; !walker.landed(); tick++) {
+        if (uint64_t fragments = record(recorder, walker.jump())) {
+            sent.emplace_back(tick, fragments);
+        }
+    }
+
+    expected = { { 6, 6 }, { 12, 6 } };
+    CHECK(sent == expected);
+    CHECK_EQ(tick, size_t(17));
+
+    // Landing sends what is left of the jump with the first step
+    CHECK_EQ(record(recorder, walker.walk()), uint64_t(5));
+
+    CHECK_EQ(recorder.get_stats().packets, uint64_t(7));
+    CHECK_EQ(recorder.get_stats().fragments, uint64_t(22));
+    CHECK_EQ(recorder.get_stats().bytes, 7 * packet_length(0) + 14 * 22);
+
+    // A new map drops the pending steps and uses the new interval
+    recorder.clear();
+    sent.clear();
+
+    for (tick = 0; tick < 60; tick++) {
+        if (uint64_t fragments = record(recorder, walker.walk())) {
+            sent.emplace_back(tick, fragments);
+        }
+    }
+
+    expected = { { 0, 1 }, { 51, 1 } };
+    CHECK(sent == expected);
+}
+
+// The rates cover the packets sent during the last full second
+void test_rates() {
+    Setting<MovementInterval>::get().save(100);
+    MovementRecorder recorder;
+    Walker walker;
+
+    const size_t window = 1000 / Constants::TIMESTEP;
+    MovementRecorder::Stats start;
+    size_t windows = 0;
+
+    for (size_t tick = 0; tick < 4 * window; tick++) {
+        // Not updated before a full second has passed
+        if (tick < window) {
+            CHECK_EQ(recorder.get_stats().packets_per_second, 0.0f);
+        }
+
+        Movement movement = tick % 200 < 150 ? walker.walk() : walker.jump();
+        MovementRecorder::Stats before = recorder.get_stats();
+        record(recorder, movement);
+
+        // The rates are updated at the start of the tick which ends the
+        // window, before its own packet
+        if ((tick + 1) % window == 0) {
+            const MovementRecorder::Stats &stats = recorder.get_stats();
+            CHECK_EQ(stats.packets_per_second,
+                     static_cast<float>(before.packets - start.packets));
+            CHECK_EQ(stats.bytes_per_second,
+                     static_cast<float>(before.bytes - start.bytes));
+            // Walking alone sends one packet every 13 ticks
+            CHECK(stats.packets_per_second >= 9.0f);
+
+            start = before;
+            windows++;
+        }
+    }
+
+    CHECK_EQ(windows, size_t(4));
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    // Configuration saves its file into the working directory
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+    ms::test_flush_points();
+    ms::test_rates();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "NxBuilder.h"
+
+#include "Audio/AudioBackend.h"
+#include "Audio/MusicPlayer.h"
+#include "Constants.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace nl::nx {
+node sound;
+}  // namespace nl::nx
+
+namespace ms {
+// AudioBackend.cpp would pull in every backend, the tests install their own
+std::unique_ptr<AudioBackend> AudioBackend::instance_;
+
+AudioBackend &AudioBackend::get() {
+    return *instance_;
+}
+
+void AudioBackend::set(std::unique_ptr<AudioBackend> backend) {
+    instance_ = std::move(backend);
+}
+
+namespace {
+// Keeps every stream which was created, freed ones included. Tracks are told
+// apart by the length of their data.
+class StubBackend : public AudioBackend {
+public:
+    struct Stream {
+        size_t length;
+        bool loop;
+        bool playing;
+        bool freed;
+        float gain;
+    };
+
+    bool init() override { return true; }
+
+    void close() override {}
+
+    uint64_t load_sample(const void *, size_t) override { return 0; }
+
+    void free_sample(uint64_t) override {}
+
+    size_t get_sample_size(uint64_t) const override { return 0; }
+
+    bool is_sample_playing(uint64_t) const override { return false; }
+
+    void play_sample(uint64_t, float, float, int8_t) override {}
+
+    uint64_t create_stream(const void *, size_t length, bool loop) override {
+        streams.push_back({ length, loop, false, false, 1.0f });
+
+        return streams.size();
+    }
+
+    void play_stream(uint64_t stream) override {
+        streams.at(stream - 1).playing = true;
+    }
+
+    void free_stream(uint64_t stream) override {
+        Stream &freed = streams.at(stream - 1);
+        CHECK(!freed.freed);
+        freed.freed = true;
+        freed.playing = false;
+    }
+
+    void set_stream_gain(uint64_t stream, float gain) override {
+        CHECK(!streams.at(stream - 1).freed);
+        streams.at(stream - 1).gain = gain;
+    }
+
+    StreamStats get_stream_stats(uint64_t) const override { return { 0, 0 }; }
+
+    bool set_sample_volume(uint8_t) override { return true; }
+
+    bool set_stream_volume(uint8_t) override { return true; }
+
+    // Streams which are playing, by the length of their track
+    std::map<size_t, std::vector<const Stream *>> playing() const {
+        std::map<size_t, std::vector<const Stream *>> result;
+
+        for (const Stream &stream: streams) {
+            if (stream.playing) {
+                result[stream.length].push_back(&stream);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<Stream> streams;
+};
+
+// Tracks whose data is 100 times their number of bytes long
+class Tracks {
+public:
+    Tracks() :
+        path_((std::filesystem::temp_directory_path() / "MusicPlayerTest.nx")
+                  .string()) {
+        NxBuilder builder;
+        size_t bgm = builder.add(NxBuilder::ROOT, "Bgm00.img");
+
+        for (size_t i = 1; i <= 3; i++) {
+            builder.add_audio(bgm,
+                              std::to_string(i),
+                              std::vector<uint8_t>(100 * i, uint8_t(i)));
+        }
+
+        CHECK(builder.write(path_));
+        file_ = std::make_unique<nl::file>(path_);
+        nl::nx::sound = file_->root();
+    }
+
+    ~Tracks() {
+        nl::nx::sound = {};
+        file_.reset();
+        std::filesystem::remove(path_);
+    }
+
+    static std::string path(size_t track) {
+        return "Bgm00.img/" + std::to_string(track);
+    }
+
+private:
+    std::string path_;
+    std::unique_ptr<nl::file> file_;
+};
+
+bool close_to(float value, float expected) {
+    return std::fabs(value - expected) < 1e-4f;
+}
+
+StubBackend &install_backend() {
+    auto backend = std::make_unique<StubBackend>();
+    StubBackend &stub = *backend;
+    AudioBackend::set(std::move(backend));
+
+    return stub;
+}
+
+// Playing the current track again keeps its stream, unless it should loop
+// differently. Then a new stream fades in over the old one.
+void test_reuse() {
+    StubBackend &backend = install_backend();
+    Tracks tracks;
+    MusicPlayer player;
+
+    player.play(Tracks::path(1), true);
+    player.play(Tracks::path(1), true);
+    CHECK_EQ(backend.streams.size(), size_t(1));
+    CHECK(backend.streams[0].playing);
+    CHECK(backend.streams[0].loop);
+    CHECK(close_to(backend.streams[0].gain, 1.0f));
+    CHECK(!player.get_stats().fading);
+
+    player.play(Tracks::path(1), false);
+    CHECK_EQ(backend.streams.size(), size_t(2));
+    CHECK(!backend.streams[1].loop);
+    CHECK(close_to(backend.streams[1].gain, 0.0f));
+    CHECK(player.get_stats().fading);
+
+    player.play(Tracks::path(1), false);
+    CHECK_EQ(backend.streams.size(), size_t(2));
+
+    // A missing track leaves the music as it is
+    player.play("Bgm00.img/4", true);
+    CHECK_EQ(backend.streams.size(), size_t(2));
+    CHECK_EQ(player.get_stats().path, Tracks::path(1));
+
+    player.close();
+    CHECK(backend.playing().empty());
+}
+
+// One track fades out while the next fades in, both over FADE_TIME, and the
+// old stream is freed once it is silent
+void test_crossfade() {
+    StubBackend &backend = install_backend();
+    Tracks tracks;
+    MusicPlayer player;
+
+    player.play(Tracks::path(1), true);
+    player.play(Tracks::path(2), true);
+
+    const float step = static_cast<float>(Constants::TIMESTEP) / 1000;
+    const size_t ticks = 1000 / Constants::TIMESTEP;
+
+    for (size_t i = 1; i < ticks; i++) {
+        player.update();
+
+        CHECK(close_to(backend.streams[0].gain, 1.0f - i * step));
+        CHECK(close_to(backend.streams[1].gain, i * step));
+        CHECK(player.get_stats().fading);
+    }
+
+    player.update();
+    CHECK(backend.streams[0].freed);
+    CHECK(close_to(backend.streams[1].gain, 1.0f));
+    CHECK(!player.get_stats().fading);
+    CHECK_EQ(player.get_stats().path, Tracks::path(2));
+
+    // A prefetched track is decoded ahead and used once it is played
+    player.prefetch(Tracks::path(3));
+    CHECK_EQ(backend.streams.size(), size_t(3));
+    CHECK(!backend.streams[2].playing);
+
+    player.play(Tracks::path(3), true);
+    CHECK_EQ(backend.streams.size(), size_t(3));
+    CHECK(backend.streams[2].playing);
+    CHECK(player.get_stats().fading);
+
+    player.close();
+    CHECK(backend.playing().empty());
+}
+
+// Going back to the track which is fading out fades the same stream in
+// again from where it was, only if it loops the same way
+void test_swap_back() {
+    StubBackend &backend = install_backend();
+    Tracks tracks;
+    MusicPlayer player;
+
+    player.play(Tracks::path(1), true);
+    player.play(Tracks::path(2), true);
+
+    for (size_t i = 0; i < 25; i++) {
+        player.update();
+    }
+
+    float gain = backend.streams[0].gain;
+    CHECK(gain < 1.0f && gain > 0.0f);
+
+    player.play(Tracks::path(1), true);
+    CHECK_EQ(backend.streams.size(), size_t(2));
+    CHECK_EQ(player.get_stats().path, Tracks::path(1));
+
+    player.update();
+    CHECK(backend.streams[0].gain > gain);
+    CHECK(backend.streams[1].gain < 1.0f - gain);
+
+    // The other track fades out first, then this one is fully back
+    for (size_t i = 0; i < 1000 / Constants::TIMESTEP; i++) {
+        player.update();
+    }
+
+    CHECK(backend.streams[1].freed);
+    CHECK(close_to(backend.streams[0].gain, 1.0f));
+
+    // Without looping it is a different stream, which is opened anew. The
+    // track faded out before is dropped for the one fading out now.
+    player.play(Tracks::path(2), true);
+    player.play(Tracks::path(1), false);
+    CHECK_EQ(backend.streams.size(), size_t(4));
+    CHECK(!backend.streams[3].loop);
+    CHECK(backend.streams[0].freed);
+    CHECK_EQ(backend.playing()[100].size(), size_t(1));
+    CHECK_EQ(backend.playing()[200].size(), size_t(1));
+
+    player.close();
+    CHECK(backend.playing().empty());
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_reuse();
+    ms::test_crossfade();
+    ms::test_swap_back();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "NxBuilder.h"
+
+#include <nlnx/child_index.hpp>
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <filesystem>
+#include <string>
+
+namespace ms {
+namespace {
+const int32_t LARGE = 3000;
+
+std::string write_file() {
+    NxBuilder builder;
+
+    size_t large = builder.add(NxBuilder::ROOT, "large");
+
+    for (int32_t i = 0; i < LARGE; i++) {
+        size_t child = builder.add(large, std::to_string(i * 2));
+        builder.add_int(child, "value", i * 2);
+    }
+
+    size_t small = builder.add(NxBuilder::ROOT, "small");
+    builder.add_string(small, "name", "small");
+    builder.add_vector(small, "origin", -3, 7);
+
+    for (int32_t i = 0; i < 8; i++) {
+        builder.add_real(small, "r" + std::to_string(i), i / 2.0);
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "NodeLookupTest.nx").string();
+    CHECK(builder.write(path));
+
+    return path;
+}
+
+// Every lookup must give the same node whether it goes through the child
+// index or the binary search over the string table
+void test_lookups(const nl::node &root) {
+    nl::node large = root["large"];
+
+    CHECK_EQ(large.size(), static_cast<size_t>(LARGE));
+
+    for (int32_t i = 0; i < LARGE * 2; i++) {
+        nl::node child = large[i];
+
+        if (i % 2 == 0) {
+            CHECK(child);
+            CHECK_EQ(child.name(), std::to_string(i));
+            CHECK_EQ(child["value"].get_integer(), i);
+            CHECK(large[std::to_string(i)] == child);
+            CHECK(large[static_cast<uint16_t>(i)] == child);
+            CHECK(large[static_cast<int64_t>(i)] == child);
+        } else {
+            CHECK(!child);
+        }
+    }
+
+    CHECK(!large[-2]);
+    CHECK(!large[""]);
+    CHECK(!large["02"]);
+    CHECK(!large["20a"]);
+    CHECK(!large["value"]);
+
+    nl::node small = root["small"];
+
+    CHECK_EQ(small["name"].get_string(), "small");
+    CHECK(small["origin"].x() == -3 && small["origin"].y() == 7);
+    CHECK_EQ(small["r5"].get_real(), 2.5);
+    CHECK(!small["r8"]);
+    CHECK(!root["missing"]["deeper"]);
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    std::string path = ms::write_file();
+
+    {
+        nl::file file(path);
+
+        nl::child_index::set_enabled(false);
+        ms::test_lookups(file.root());
+
+        nl::child_index::set_enabled(true);
+        ms::test_lookups(file.root());
+        ms::test_lookups(file.root());
+    }
+
+    std::filesystem::remove(path);
+
+    return ms::check_result();
+}
\ No newline at end of file
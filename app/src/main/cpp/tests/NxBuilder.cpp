@@ -0,0 +1,256 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "NxBuilder.h"
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace ms {
+namespace {
+void put(std::vector<char> &out, const void *value, size_t size) {
+    const char *bytes = static_cast<const char *>(value);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+template<typename T>
+void put(std::vector<char> &out, T value) {
+    put(out, &value, sizeof(T));
+}
+
+template<typename T>
+void patch(std::vector<char> &out, size_t offset, T value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void align(std::vector<char> &out, size_t alignment) {
+    out.resize((out.size() + alignment - 1) / alignment * alignment, 0);
+}
+}  // namespace
+
+NxBuilder::NxBuilder() {
+    nodes_.push_back(Node{"", NONE, 0, 0.0, {0, 0}, 0, 0, "", {}});
+}
+
+size_t NxBuilder::add(size_t parent, const std::string &name, Type type) {
+    nodes_.push_back(Node{name, type, 0, 0.0, {0, 0}, 0, 0, "", {}});
+    nodes_[parent].children.push_back(nodes_.size() - 1);
+
+    return nodes_.size() - 1;
+}
+
+size_t NxBuilder::add(size_t parent, const std::string &name) {
+    return add(parent, name, NONE);
+}
+
+size_t NxBuilder::add_int(size_t parent, const std::string &name, int64_t value) {
+    size_t index = add(parent, name, INTEGER);
+    nodes_[index].integer = value;
+
+    return index;
+}
+
+size_t NxBuilder::add_real(size_t parent, const std::string &name, double value) {
+    size_t index = add(parent, name, REAL);
+    nodes_[index].real = value;
+
+    return index;
+}
+
+size_t NxBuilder::add_string(size_t parent, const std::string &name, const std::string &value) {
+    size_t index = add(parent, name, STRING);
+    nodes_[index].text = value;
+
+    return index;
+}
+
+size_t NxBuilder::add_vector(size_t parent, const std::string &name, int32_t x, int32_t y) {
+    size_t index = add(parent, name, VECTOR);
+    nodes_[index].vector[0] = x;
+    nodes_[index].vector[1] = y;
+
+    return index;
+}
+
+size_t NxBuilder::add_bitmap(size_t parent,
+                             const std::string &name,
+                             uint16_t width,
+                             uint16_t height,
+                             const std::vector<uint8_t> &pixels) {
+    size_t index = add(parent, name, BITMAP);
+    nodes_[index].width = width;
+    nodes_[index].height = height;
+    nodes_[index].integer = static_cast<int64_t>(bitmaps_.size());
+
+    int length = static_cast<int>(pixels.size());
+    std::vector<char> compressed(LZ4_compressBound(length));
+    int size = LZ4_compress_default(reinterpret_cast<const char *>(pixels.data()),
+                                    compressed.data(),
+                                    length,
+                                    static_cast<int>(compressed.size()));
+    compressed.resize(size > 0 ? size : 0);
+
+    bitmaps_.push_back(std::move(compressed));
+
+    return index;
+}
+
+size_t NxBuilder::add_audio(size_t parent,
+                            const std::string &name,
+                            const std::vector<uint8_t> &data) {
+    size_t index = add(parent, name, AUDIO);
+    nodes_[index].integer = static_cast<int64_t>(audios_.size());
+
+    audios_.push_back(data);
+
+    return index;
+}
+
+bool NxBuilder::write(const std::string &path) const {
+    // Children have to be stored next to each other and sorted by name, so
+    // the nodes are laid out breadth first
+    std::vector<size_t> order = {ROOT};
+    std::vector<uint32_t> first_child(nodes_.size(), 0);
+
+    for (size_t i = 0; i < order.size(); i++) {
+        std::vector<size_t> children = nodes_[order[i]].children;
+
+        std::sort(children.begin(), children.end(), [this](size_t a, size_t b) {
+            return nodes_[a].name < nodes_[b].name;
+        });
+
+        first_child[order[i]] = static_cast<uint32_t>(order.size());
+        order.insert(order.end(), children.begin(), children.end());
+    }
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> string_ids;
+
+    auto string_id = [&](const std::string &value) {
+        auto iter = string_ids.find(value);
+
+        if (iter != string_ids.end()) {
+            return iter->second;
+        }
+
+        uint32_t id = static_cast<uint32_t>(strings.size());
+        strings.push_back(value);
+        string_ids.emplace(value, id);
+
+        return id;
+    };
+
+    std::vector<char> out;
+    out.resize(52, 0);
+    align(out, 8);
+
+    size_t node_offset = out.size();
+
+    for (size_t index: order) {
+        const Node &node = nodes_[index];
+
+        put(out, string_id(node.name));
+        put(out, node.children.empty() ? 0u : first_child[index]);
+        put(out, static_cast<uint16_t>(node.children.size()));
+        put(out, static_cast<uint16_t>(node.type));
+
+        switch (node.type) {
+            case INTEGER: put(out, node.integer); break;
+            case REAL: put(out, node.real); break;
+            case STRING:
+                put(out, string_id(node.text));
+                put(out, 0u);
+                break;
+            case VECTOR:
+                put(out, node.vector[0]);
+                put(out, node.vector[1]);
+                break;
+            case BITMAP:
+                put(out, static_cast<uint32_t>(node.integer));
+                put(out, node.width);
+                put(out, node.height);
+                break;
+            case AUDIO:
+                put(out, static_cast<uint32_t>(node.integer));
+                put(out, static_cast<uint32_t>(audios_[node.integer].size()));
+                break;
+            default: put(out, int64_t(0)); break;
+        }
+    }
+
+    align(out, 8);
+
+    std::vector<char> data;
+    std::vector<uint64_t> string_offsets;
+    std::vector<uint64_t> bitmap_offsets;
+    std::vector<uint64_t> audio_offsets;
+
+    size_t data_offset =
+        out.size() + 8 * (strings.size() + bitmaps_.size() + audios_.size());
+
+    for (const std::string &value: strings) {
+        align(data, 2);
+        string_offsets.push_back(data_offset + data.size());
+
+        put(data, static_cast<uint16_t>(value.size()));
+        put(data, value.data(), value.size());
+    }
+
+    for (const std::vector<char> &bitmap: bitmaps_) {
+        align(data, 8);
+        bitmap_offsets.push_back(data_offset + data.size());
+
+        put(data, static_cast<uint32_t>(bitmap.size()));
+        put(data, bitmap.data(), bitmap.size());
+    }
+
+    for (const std::vector<uint8_t> &audio: audios_) {
+        align(data, 8);
+        audio_offsets.push_back(data_offset + data.size());
+
+        put(data, audio.data(), audio.size());
+    }
+
+    size_t string_offset = out.size();
+    put(out, string_offsets.data(), 8 * string_offsets.size());
+
+    size_t bitmap_offset = out.size();
+    put(out, bitmap_offsets.data(), 8 * bitmap_offsets.size());
+
+    size_t audio_offset = out.size();
+    put(out, audio_offsets.data(), 8 * audio_offsets.size());
+
+    out.insert(out.end(), data.begin(), data.end());
+
+    patch(out, 0, uint32_t(0x34474B50));
+    patch(out, 4, static_cast<uint32_t>(order.size()));
+    patch(out, 8, static_cast<uint64_t>(node_offset));
+    patch(out, 16, static_cast<uint32_t>(strings.size()));
+    patch(out, 20, static_cast<uint64_t>(string_offset));
+    patch(out, 28, static_cast<uint32_t>(bitmaps_.size()));
+    patch(out, 32, static_cast<uint64_t>(bitmaps_.empty() ? 0 : bitmap_offset));
+    patch(out, 40, static_cast<uint32_t>(audios_.size()));
+    patch(out, 44, static_cast<uint64_t>(audios_.empty() ? 0 : audio_offset));
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+    return static_cast<bool>(stream);
+}
+}  // namespace ms
\ No newline at end of file
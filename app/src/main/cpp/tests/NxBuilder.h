@@ -0,0 +1,79 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ms {
+// Writes small PKG4 files so that tests and benchmarks can open synthetic
+// NX data through nlnx without the game's own files
+class NxBuilder {
+public:
+    static const size_t ROOT = 0;
+
+    NxBuilder();
+
+    // Add an empty node and return its index
+    size_t add(size_t parent, const std::string &name);
+
+    size_t add_int(size_t parent, const std::string &name, int64_t value);
+
+    size_t add_real(size_t parent, const std::string &name, double value);
+
+    size_t add_string(size_t parent, const std::string &name, const std::string &value);
+
+    size_t add_vector(size_t parent, const std::string &name, int32_t x, int32_t y);
+
+    // Add a bitmap from BGRA pixels, the format nlnx decodes to
+    size_t add_bitmap(size_t parent,
+                      const std::string &name,
+                      uint16_t width,
+                      uint16_t height,
+                      const std::vector<uint8_t> &pixels);
+
+    // Add audio, stored as it is
+    size_t add_audio(size_t parent,
+                     const std::string &name,
+                     const std::vector<uint8_t> &data);
+
+    // Write the file, return false if it could not be written
+    bool write(const std::string &path) const;
+
+private:
+    enum Type : uint16_t { NONE, INTEGER, REAL, STRING, VECTOR, BITMAP, AUDIO };
+
+    struct Node {
+        std::string name;
+        Type type;
+        int64_t integer;
+        double real;
+        int32_t vector[2];
+        uint16_t width;
+        uint16_t height;
+        std::string text;
+        std::vector<size_t> children;
+    };
+
+    size_t add(size_t parent, const std::string &name, Type type);
+
+    std::vector<Node> nodes_;
+    std::vector<std::vector<char>> bitmaps_;
+    std::vector<std::vector<uint8_t>> audios_;
+};
+}  // namespace ms
\ No newline at end of file
@@ -0,0 +1,170 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "FootholdMap.h"
+
+#include "Gameplay/Physics/Physics.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ms {
+namespace {
+const size_t OBJECTS = 900;
+const size_t TICKS = 600;
+
+// Both are not a number when the object stands on the null foothold
+bool same(double first, double second) {
+    return first == second || (std::isnan(first) && std::isnan(second));
+}
+
+void check_same(const PhysicsObject &phobj, const PhysicsObject &expected) {
+    CHECK_EQ(phobj.crnt_x(), expected.crnt_x());
+    CHECK_EQ(phobj.crnt_y(), expected.crnt_y());
+    CHECK_EQ(phobj.x.last(), expected.x.last());
+    CHECK_EQ(phobj.y.last(), expected.y.last());
+    CHECK_EQ(phobj.hspeed, expected.hspeed);
+    CHECK_EQ(phobj.vspeed, expected.vspeed);
+    CHECK_EQ(phobj.hforce, expected.hforce);
+    CHECK_EQ(phobj.vforce, expected.vforce);
+    CHECK(same(phobj.hacc, expected.hacc));
+    CHECK(same(phobj.vacc, expected.vacc));
+    CHECK_EQ(phobj.fhid, expected.fhid);
+    CHECK_EQ(phobj.fhlayer, expected.fhlayer);
+    CHECK(same(phobj.fhslope, expected.fhslope));
+    CHECK_EQ(phobj.onground, expected.onground);
+    CHECK_EQ(phobj.enablejd, expected.enablejd);
+}
+
+// Objects of every type scattered over the map, some dropped from above and
+// some pushed along the ground every tick like walking mobs
+std::vector<PhysicsObject> make_objects(uint32_t seed) {
+    const PhysicsObject::Type TYPES[] = { PhysicsObject::Type::NORMAL,
+                                          PhysicsObject::Type::NORMAL,
+                                          PhysicsObject::Type::NORMAL,
+                                          PhysicsObject::Type::FLYING,
+                                          PhysicsObject::Type::SWIMMING,
+                                          PhysicsObject::Type::ICE,
+                                          PhysicsObject::Type::FIXATED };
+
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int16_t> x(-4200, 4200);
+    std::uniform_int_distribution<int16_t> y(-2000, 2000);
+    std::uniform_real_distribution<double> speed(-4.0, 4.0);
+    std::uniform_int_distribution<size_t> type(0, std::size(TYPES) - 1);
+
+    std::vector<PhysicsObject> objects(OBJECTS);
+
+    for (PhysicsObject &phobj : objects) {
+        phobj.type = TYPES[type(engine)];
+        phobj.set_x(x(engine));
+        phobj.set_y(y(engine));
+        phobj.hspeed = speed(engine);
+        phobj.vspeed = speed(engine);
+        phobj.onground = engine() % 2 == 0;
+
+        if (engine() % 5 == 0) {
+            phobj.set_flag(PhysicsObject::Flag::NO_GRAVITY);
+        }
+
+        if (engine() % 3 == 0) {
+            phobj.set_flag(PhysicsObject::Flag::TURN_AT_EDGES);
+        }
+    }
+
+    return objects;
+}
+
+// What the objects' own updates do before moving them
+void push(std::vector<PhysicsObject> &objects, size_t tick) {
+    for (size_t i = 0; i < objects.size(); i++) {
+        PhysicsObject &phobj = objects[i];
+
+        if (i % 4 == 0) {
+            phobj.hforce = (tick / 50 + i) % 2 ? 0.2 : -0.2;
+        } else if (i % 4 == 1 && tick % 90 == i % 90) {
+            phobj.vforce = -4.5;
+        }
+    }
+}
+
+// Moving objects one by one and in a batch must give the same objects
+void test_map(size_t chains, int16_t width, uint32_t seed) {
+    NxBuilder builder;
+    add_footholds(builder, NxBuilder::ROOT, make_footholds(chains, width, seed));
+
+    std::string path = (std::filesystem::temp_directory_path() / "PhysicsBatchTest.nx").string();
+    CHECK(builder.write(path));
+
+    {
+        nl::file file(path);
+        Physics physics(file.root()["foothold"]);
+
+        std::vector<PhysicsObject> single = make_objects(seed);
+        std::vector<PhysicsObject> batched = single;
+        PhysicsBatch batch;
+
+        for (size_t tick = 0; tick < TICKS; tick++) {
+            push(single, tick);
+            push(batched, tick);
+
+            for (PhysicsObject &phobj : single) {
+                physics.move_object(phobj);
+            }
+
+            batch.clear();
+
+            for (PhysicsObject &phobj : batched) {
+                batch.add(phobj);
+            }
+
+            CHECK_EQ(batch.size(), batched.size());
+
+            physics.move_objects(batch);
+        }
+
+        for (size_t i = 0; i < single.size(); i++) {
+            check_same(batched[i], single[i]);
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+void test_empty() {
+    Physics physics;
+    PhysicsBatch batch;
+
+    CHECK(batch.empty());
+    physics.move_objects(batch);
+    CHECK(batch.empty());
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_map(400, 8000, 3);
+    ms::test_map(60, 2000, 4);
+    ms::test_empty();
+
+    return ms::check_result();
+}
\ No newline at end of file
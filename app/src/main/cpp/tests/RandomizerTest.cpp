@@ -0,0 +1,129 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+
+#include "Util/Randomizer.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ms {
+namespace {
+enum Stance : uint8_t { STAND, MOVE, JUMP, LENGTH };
+
+// The same seed gives the same draws, on any instance
+void test_seed() {
+    Randomizer randomizer;
+    std::vector<int32_t> first;
+
+    Randomizer::seed(42);
+
+    for (size_t i = 0; i < 100; i++) {
+        first.push_back(randomizer.next_int(1000));
+    }
+
+    Randomizer::seed(42);
+
+    for (size_t i = 0; i < 100; i++) {
+        CHECK_EQ(Randomizer().next_int(1000), first[i]);
+    }
+}
+
+// Every value of a range comes up about equally often, including signed,
+// narrow and enum ranges
+template<typename T>
+void test_uniform(T from, T to) {
+    Randomizer randomizer;
+    size_t range = static_cast<size_t>(static_cast<int64_t>(to) - static_cast<int64_t>(from));
+    std::vector<size_t> counts(range);
+    const size_t draws = 20000 * range;
+
+    for (size_t i = 0; i < draws; i++) {
+        T value = randomizer.next_int(from, to);
+
+        CHECK(value >= from && value < to);
+
+        if (value >= from && value < to) {
+            counts[static_cast<size_t>(static_cast<int64_t>(value) - static_cast<int64_t>(from))]++;
+        }
+    }
+
+    for (size_t count : counts) {
+        CHECK(count > 19000 && count < 21000);
+    }
+}
+
+void test_enum() {
+    Randomizer randomizer;
+    std::array<size_t, 3> counts = {};
+
+    for (size_t i = 0; i < 30000; i++) {
+        Stance stance = randomizer.next_enum<Stance>();
+
+        CHECK(stance < LENGTH);
+
+        if (stance < LENGTH) {
+            counts[static_cast<size_t>(stance)]++;
+        }
+    }
+
+    for (size_t count : counts) {
+        CHECK(count > 9000 && count < 11000);
+    }
+}
+
+// Reals stay in [from, to), singly and in batches, and empty ranges return
+// their start
+void test_reals() {
+    Randomizer randomizer;
+    double sum = 0;
+    std::array<float, 1000> batch;
+
+    for (size_t i = 0; i < 100000; i++) {
+        float value = randomizer.next_real(1.0f);
+        double wide = randomizer.next_real(-5.0, 5.0);
+
+        CHECK(value >= 0.0f && value < 1.0f);
+        CHECK(wide >= -5.0 && wide < 5.0);
+
+        sum += value;
+    }
+
+    CHECK(sum / 100000 > 0.49 && sum / 100000 < 0.51);
+
+    randomizer.next_reals(batch.begin(), batch.end(), 2.0f, 3.0f);
+
+    for (float value : batch) {
+        CHECK(value >= 2.0f && value < 3.0f);
+    }
+
+    CHECK_EQ(randomizer.next_real(4.0f, 4.0f), 4.0f);
+    CHECK_EQ(randomizer.next_int(7, 3), 7);
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_seed();
+    ms::test_uniform<int32_t>(0, 10);
+    ms::test_uniform<int16_t>(-3, 4);
+    ms::test_uniform<uint8_t>(250, 255);
+    ms::test_enum();
+    ms::test_reals();
+
+    return ms::check_result();
+}
\ No newline at end of file
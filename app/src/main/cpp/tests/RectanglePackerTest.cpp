@@ -0,0 +1,105 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+
+#include "Util/RectanglePacker.h"
+
+#include <random>
+#include <vector>
+
+namespace ms {
+namespace {
+// Place random rectangles until the packer is full, checking that every
+// placement stays inside the area and overlaps nothing placed before
+void test_random_fill(int16_t width, int16_t height, uint32_t seed) {
+    SkylinePacker packer(width, height);
+    std::vector<bool> covered(static_cast<size_t>(width) * height, false);
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> side(1, 96);
+
+    size_t area = 0;
+    size_t failures = 0;
+
+    while (failures < 200) {
+        int16_t w = side(engine);
+        int16_t h = side(engine);
+        int16_t x = -1;
+        int16_t y = -1;
+
+        if (!packer.insert(w, h, x, y)) {
+            failures++;
+            continue;
+        }
+
+        CHECK(x >= 0 && y >= 0);
+        CHECK(x + w <= width && y + h <= height);
+
+        if (x < 0 || y < 0 || x + w > width || y + h > height) {
+            return;
+        }
+
+        bool overlaps = false;
+
+        for (int16_t row = y; row < y + h; row++) {
+            for (int16_t column = x; column < x + w; column++) {
+                size_t index = static_cast<size_t>(row) * width + column;
+
+                overlaps |= covered[index];
+                covered[index] = true;
+            }
+        }
+
+        CHECK(!overlaps);
+
+        area += static_cast<size_t>(w) * h;
+    }
+
+    CHECK_EQ(packer.get_used(), area);
+    CHECK(packer.get_used() + packer.get_wasted() <= static_cast<size_t>(width) * height);
+    CHECK(packer.get_used() > static_cast<size_t>(width) * height * 3 / 4);
+}
+
+void test_exact_fit() {
+    SkylinePacker packer(64, 32);
+    int16_t x = -1;
+    int16_t y = -1;
+
+    CHECK(!packer.insert(65, 1, x, y));
+    CHECK(!packer.insert(1, 33, x, y));
+    CHECK(packer.insert(64, 32, x, y));
+    CHECK(x == 0 && y == 0);
+    CHECK(!packer.insert(1, 1, x, y));
+    CHECK_EQ(packer.get_used(), 64u * 32u);
+
+    packer.clear();
+
+    CHECK_EQ(packer.get_used(), 0u);
+    CHECK_EQ(packer.get_wasted(), 0u);
+    CHECK(packer.insert(32, 32, x, y));
+    CHECK(packer.insert(32, 32, x, y));
+    CHECK(x == 32 && y == 0);
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_exact_fit();
+    ms::test_random_fill(1024, 1024, 1);
+    ms::test_random_fill(512, 128, 2);
+    ms::test_random_fill(8192, 256, 3);
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Net/NetConstants.h"
+
+namespace ms {
+// The byte-wise packet cipher the client used before the table-driven and
+// hardware AES paths and the word-wide maple cipher, kept as the reference
+// those are checked and measured against
+class ReferenceCryptography {
+public:
+    // Obtain the initialization vector from the handshake
+    ReferenceCryptography(const int8_t *handshake);
+
+    // Encrypt a byte array with the given length and iv
+    void encrypt(int8_t *bytes, size_t length);
+    // Decrypt a byte array with the given length and iv
+    void decrypt(int8_t *bytes, size_t length);
+    // Add the maple custom encryption
+    void mapleencrypt(int8_t *bytes, size_t length) const;
+    // Remove the maple custom encryption
+    void mapledecrypt(int8_t *bytes, size_t length) const;
+    // Apply AES OFB to a byte array
+    void aesofb(int8_t *bytes, size_t length, uint8_t *iv) const;
+
+private:
+    // Update a key
+    void updateiv(uint8_t *iv) const;
+    // Perform a roll-left operation
+    int8_t rollleft(int8_t byte, size_t count) const;
+    // Perform a roll-right operation
+    int8_t rollright(int8_t byte, size_t count) const;
+
+    // Encrypt a byte array with AES
+    void aesencrypt(uint8_t *bytes) const;
+    // AES add round key step
+    void addroundkey(uint8_t *bytes, uint8_t round) const;
+    // AES sub bytes step
+    void subbytes(uint8_t *bytes) const;
+    // AES shift rows step
+    void shiftrows(uint8_t *bytes) const;
+    // AES mix columns step
+    void mixcolumns(uint8_t *bytes) const;
+    // Perform a Galois multiplication
+    uint8_t gmul(uint8_t byte) const;
+
+    uint8_t sendiv_[HEADER_LENGTH];
+    uint8_t recviv_[HEADER_LENGTH];
+};
+}  // namespace ms
\ No newline at end of file
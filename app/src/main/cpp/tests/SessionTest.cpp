@@ -0,0 +1,471 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+
+#include "Configuration.h"
+#include "Net/Session.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Session reads the server address from the activity's data directory
+namespace {
+ANativeActivity activity;
+std::string data_path;
+}  // namespace
+
+void *glfmGetAndroidActivity(GLFMDisplay *) {
+    return &activity;
+}
+
+namespace ms {
+namespace {
+using Packets = std::vector<std::vector<int8_t>>;
+
+class Collector : public Forwarder {
+public:
+    explicit Collector(Packets &packets) : packets_(packets) {}
+
+    void forward(int8_t *bytes, size_t length) const override {
+        packets_.emplace_back(bytes, bytes + length);
+    }
+
+private:
+    Packets &packets_;
+};
+
+// Mostly small packets with a few long ones, the header holds lengths up to
+// 32767
+Packets make_packets(std::mt19937 &engine, size_t count) {
+    Packets packets;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t longest = i % 50 == 0 ? 30000 : 300;
+        std::vector<int8_t> packet(2 + engine() % longest);
+
+        for (int8_t &byte: packet) {
+            byte = static_cast<int8_t>(engine());
+        }
+
+        packets.push_back(std::move(packet));
+    }
+
+    return packets;
+}
+
+// The server's side of the keys: the client encrypts with the receive iv
+// and the other way round
+Cryptography server_cryptography(const int8_t *handshake) {
+    int8_t keys[HANDSHAKE_LEN];
+    memcpy(keys, handshake, HANDSHAKE_LEN);
+    memcpy(keys + 7, handshake + 11, 4);
+    memcpy(keys + 11, handshake + 7, 4);
+
+    return Cryptography(keys);
+}
+
+// Encrypt a packet and append it with its header to the stream
+void append_packet(Cryptography &cryptography, std::vector<int8_t> &stream,
+                   std::vector<int8_t> packet) {
+    int8_t header[4];
+    cryptography.create_header(header, packet.size());
+    cryptography.encrypt(packet.data(), packet.size());
+    stream.insert(stream.end(), header, header + 4);
+    stream.insert(stream.end(), packet.begin(), packet.end());
+}
+
+// Stand-in for the login server: for every connection it sends the
+// handshake, reads and decrypts the client's packets, then sends its own in
+// odd-sized fragments
+class Server {
+public:
+    Server(const Packets &downstream, size_t upstream, size_t connections) :
+        acceptor_(io_, tcp::endpoint(asio::ip::address_v4::loopback(), 0)) {
+        std::mt19937 engine(7);
+
+        for (int8_t &byte: handshake_) {
+            byte = static_cast<int8_t>(engine());
+        }
+
+        thread_ = std::thread([=]() { run(downstream, upstream, connections); });
+    }
+
+    ~Server() { join(); }
+
+    // Wait until the client has closed the last connection
+    void join() {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    std::string port() const {
+        return std::to_string(acceptor_.local_endpoint().port());
+    }
+
+    // Every packet received, over all connections. Only read after join.
+    const Packets &received() const { return received_; }
+
+    // Whether the server has read or sent everything on the given connection
+    bool read(size_t connection) const { return read_ > connection; }
+    bool sent(size_t connection) const { return sent_ > connection; }
+
+private:
+    void run(Packets downstream, size_t upstream, size_t connections) {
+        error_code error;
+
+        for (size_t c = 0; c < connections; c++) {
+            tcp::socket socket(io_);
+            acceptor_.accept(socket);
+            asio::write(socket, asio::buffer(handshake_));
+
+            Cryptography cryptography = server_cryptography(handshake_);
+
+            for (size_t i = 0; i < upstream; i++) {
+                int8_t header[4];
+                asio::read(socket, asio::buffer(header), error);
+
+                if (error) {
+                    break;
+                }
+
+                std::vector<int8_t> packet(cryptography.check_length(header));
+                asio::read(socket, asio::buffer(packet), error);
+                cryptography.decrypt(packet.data(), packet.size());
+                received_.push_back(std::move(packet));
+            }
+
+            read_++;
+            std::vector<int8_t> stream;
+
+            for (const std::vector<int8_t> &packet: downstream) {
+                append_packet(cryptography, stream, packet);
+            }
+
+            std::mt19937 engine(3);
+
+            for (size_t sent = 0; sent < stream.size();) {
+                size_t count = std::min<size_t>(stream.size() - sent,
+                                                1 + engine() % 5000);
+                asio::write(socket, asio::buffer(stream.data() + sent, count),
+                            error);
+                sent += count;
+            }
+
+            sent_++;
+
+            // Let the client read everything before the connection closes
+            char byte;
+            socket.read_some(asio::buffer(&byte, 1), error);
+        }
+    }
+
+    asio::io_context io_;
+    tcp::acceptor acceptor_;
+    int8_t handshake_[HANDSHAKE_LEN];
+    Packets received_;
+    std::atomic<size_t> read_ { 0 };
+    std::atomic<size_t> sent_ { 0 };
+    std::thread thread_;
+};
+
+// Sends one connection's packets cut into pieces at the given stream
+// offsets, each piece only once the client has asked for it. The client
+// then knows which bytes every read can see.
+class ScriptedServer {
+public:
+    ScriptedServer(const Packets &packets, std::vector<size_t> cuts) :
+        acceptor_(io_, tcp::endpoint(asio::ip::address_v4::loopback(), 0)),
+        cuts_(std::move(cuts)) {
+        std::mt19937 engine(13);
+
+        for (int8_t &byte: handshake_) {
+            byte = static_cast<int8_t>(engine());
+        }
+
+        Cryptography cryptography = server_cryptography(handshake_);
+
+        for (const std::vector<int8_t> &packet: packets) {
+            append_packet(cryptography, stream_, packet);
+        }
+
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~ScriptedServer() {
+        // Let the thread run out if the client gave up early
+        requested_ = cuts_.size();
+        thread_.join();
+    }
+
+    std::string port() const {
+        return std::to_string(acceptor_.local_endpoint().port());
+    }
+
+    // Send the next piece of the stream
+    void send_next() { requested_++; }
+
+private:
+    void run() {
+        tcp::socket socket(io_);
+        acceptor_.accept(socket);
+        asio::write(socket, asio::buffer(handshake_));
+
+        error_code error;
+        size_t sent = 0;
+
+        for (size_t i = 0; i < cuts_.size(); i++) {
+            while (requested_ <= i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            asio::write(socket,
+                        asio::buffer(stream_.data() + sent, cuts_[i] - sent),
+                        error);
+            sent = cuts_[i];
+        }
+
+        // Let the client read everything before the connection closes
+        char byte;
+        socket.read_some(asio::buffer(&byte, 1), error);
+    }
+
+    asio::io_context io_;
+    tcp::acceptor acceptor_;
+    int8_t handshake_[HANDSHAKE_LEN];
+    std::vector<int8_t> stream_;
+    std::vector<size_t> cuts_;
+    std::atomic<size_t> requested_ { 0 };
+    std::thread thread_;
+};
+
+bool read_until(Session &session, const Packets &got, size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+
+    while (got.size() < count && std::chrono::steady_clock::now() < deadline) {
+        session.read();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return got.size() == count;
+}
+
+// Packets must arrive intact and in order both ways, on the first
+// connection and after a reconnect. More packets than the queues between
+// the threads hold are written and received without reading in between.
+void test_loopback(bool threaded) {
+    std::mt19937 engine(threaded ? 11 : 5);
+    Packets downstream = make_packets(engine, 3000);
+    Packets upstream = make_packets(engine, 3000);
+
+    Server server(downstream, upstream.size(), 2);
+    Setting<ServerPort>::get().save(server.port());
+    Setting<NetworkThread>::get().save(threaded);
+
+    Packets got;
+    auto session = std::make_unique<Session>(std::make_unique<Collector>(got));
+    CHECK(session->init(nullptr) == Error::NONE);
+
+    for (size_t c = 0; c < 2; c++) {
+        if (c > 0) {
+            got.clear();
+            session->reconnect("127.0.0.1", server.port().c_str());
+        }
+
+        CHECK(session->is_connected());
+
+        for (std::vector<int8_t> packet: upstream) {
+            session->write(packet.data(), packet.size());
+        }
+
+        // Held back packets only leave when the game thread comes back
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(20);
+
+        while (!server.read(c) && std::chrono::steady_clock::now() < deadline) {
+            session->read();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Then leave the server's packets to pile up on the network thread
+        while (threaded && !server.sent(c) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        CHECK(read_until(*session, got, downstream.size()));
+        CHECK(got == downstream);
+        CHECK(session->is_connected());
+    }
+
+    session.reset();
+    server.join();
+
+    CHECK_EQ(server.received().size(), 2 * upstream.size());
+
+    for (size_t i = 0; i < server.received().size(); i++) {
+        CHECK(server.received()[i] == upstream[i % upstream.size()]);
+    }
+}
+
+// Framing on the game thread, with every read seeing a known piece of the
+// stream: several packets in one read, a header split over two reads, a
+// packet that wraps around the end of the ring and a header that does so
+// while also being split over two reads.
+void test_framing() {
+    // Large enough that the ring wraps, small enough for the header
+    constexpr size_t FILLER = 30000;
+    constexpr size_t RING_LENGTH = 2 * MAX_PACKET_LENGTH;
+
+    std::mt19937 engine(17);
+    Packets packets;
+    std::vector<size_t> cuts;
+    size_t end = 0;
+
+    auto add = [&](size_t length) {
+        std::vector<int8_t> packet(length);
+
+        for (int8_t &byte: packet) {
+            byte = static_cast<int8_t>(engine());
+        }
+
+        packets.push_back(std::move(packet));
+        end += HEADER_LENGTH + length;
+    };
+
+    // Fill the stream up to the given offset
+    auto pad = [&](size_t offset) {
+        while (offset - end > HEADER_LENGTH + FILLER) {
+            add(FILLER);
+        }
+
+        add(offset - end - HEADER_LENGTH);
+    };
+
+    // Five packets arrive at once
+    for (size_t length: { 10, 20, 30, 40, 50 }) {
+        add(length);
+    }
+
+    cuts.push_back(end);
+    size_t several = packets.size();
+
+    // Then half of a header and the rest of its packet
+    cuts.push_back(end + 2);
+    add(100);
+    cuts.push_back(end);
+    size_t split = packets.size();
+
+    // A packet body running over the end of the ring
+    pad(RING_LENGTH - 100 - HEADER_LENGTH);
+    add(300);
+    cuts.push_back(end);
+    size_t wrapped = packets.size();
+
+    // A header running over the end of the ring, read in two halves
+    pad(2 * RING_LENGTH - 2);
+    cuts.push_back(end);
+    size_t padded = packets.size();
+    cuts.push_back(end + 2);
+    add(64);
+    cuts.push_back(end);
+
+    ScriptedServer server(packets, cuts);
+    Setting<ServerPort>::get().save(server.port());
+    Setting<NetworkThread>::get().save(false);
+
+    Packets got;
+    Session session(std::make_unique<Collector>(got));
+    CHECK(session.init(nullptr) == Error::NONE);
+
+    // Counters summed over the reads that took in the current piece
+    Session::ReadStats stats;
+    size_t received = 0;
+    size_t piece = 0;
+
+    auto read_piece = [&]() {
+        server.send_next();
+        stats = {};
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(20);
+
+        while (received < cuts[piece] &&
+               std::chrono::steady_clock::now() < deadline) {
+            session.read();
+            const Session::ReadStats &last = session.get_read_stats();
+            stats.bytes += last.bytes;
+            stats.packets += last.packets;
+            stats.reads += last.reads;
+            received += last.bytes;
+        }
+
+        CHECK_EQ(received, cuts[piece]);
+        piece++;
+    };
+
+    read_piece();
+    CHECK_EQ(got.size(), several);
+    CHECK(stats.reads < stats.packets);
+
+    read_piece();
+    CHECK_EQ(stats.bytes, size_t(2));
+    CHECK_EQ(got.size(), several);
+
+    read_piece();
+    CHECK_EQ(got.size(), split);
+
+    read_piece();
+    CHECK_EQ(got.size(), wrapped);
+    CHECK(got.back() == packets[wrapped - 1]);
+
+    read_piece();
+    CHECK_EQ(got.size(), padded);
+
+    read_piece();
+    CHECK_EQ(stats.bytes, size_t(2));
+    CHECK_EQ(got.size(), padded);
+
+    read_piece();
+    CHECK(got == packets);
+    CHECK(session.is_connected());
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    // Configuration saves its file into the working directory
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "SessionTest";
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+    std::ofstream(directory / "hostip.txt") << "127.0.0.1";
+
+    data_path = directory.string();
+    activity.externalDataPath = data_path.c_str();
+
+    ms::test_loopback(false);
+    ms::test_loopback(true);
+    ms::test_framing();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,316 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Check.h"
+#include "NxBuilder.h"
+
+#include "Audio/AudioBackend.h"
+#include "Audio/SoundCache.h"
+
+#include <nlnx/file.hpp>
+#include <nlnx/node.hpp>
+
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ms {
+// AudioBackend.cpp would pull in every backend, the tests install their own
+std::unique_ptr<AudioBackend> AudioBackend::instance_;
+
+AudioBackend &AudioBackend::get() {
+    return *instance_;
+}
+
+void AudioBackend::set(std::unique_ptr<AudioBackend> backend) {
+    instance_ = std::move(backend);
+}
+
+namespace {
+// Decodes every sound into a sample as large as its data. Played samples
+// keep playing while held. Playing a freed sample and freeing a playing
+// one are counted.
+class StubBackend : public AudioBackend {
+public:
+    bool init() override { return true; }
+
+    void close() override {}
+
+    uint64_t load_sample(const void *, size_t length) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        uint64_t sample = next_sample_++;
+        sizes_.emplace(sample, length);
+
+        return sample;
+    }
+
+    void free_sample(uint64_t sample) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        cut_off += playing_.erase(sample);
+        sizes_.erase(sample);
+    }
+
+    size_t get_sample_size(uint64_t sample) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto iter = sizes_.find(sample);
+
+        return iter == sizes_.end() ? 0 : iter->second;
+    }
+
+    bool is_sample_playing(uint64_t sample) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return playing_.count(sample) > 0;
+    }
+
+    void play_sample(uint64_t sample, float, float, int8_t) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!sizes_.count(sample)) {
+            freed_plays++;
+            return;
+        }
+
+        plays++;
+
+        if (hold_) {
+            playing_.insert(sample);
+        }
+    }
+
+    uint64_t create_stream(const void *, size_t, bool) override { return 0; }
+
+    void play_stream(uint64_t) override {}
+
+    void free_stream(uint64_t) override {}
+
+    void set_stream_gain(uint64_t, float) override {}
+
+    StreamStats get_stream_stats(uint64_t) const override { return { 0, 0 }; }
+
+    bool set_sample_volume(uint8_t) override { return true; }
+
+    bool set_stream_volume(uint8_t) override { return true; }
+
+    // Whether played samples keep playing until stopped
+    void hold(bool hold) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hold_ = hold;
+    }
+
+    void stop_all() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        playing_.clear();
+    }
+
+    // Sizes of the samples which have not been freed, they tell the sounds
+    // apart
+    std::set<size_t> resident() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::set<size_t> sizes;
+
+        for (const auto &entry: sizes_) {
+            sizes.insert(entry.second);
+        }
+
+        return sizes;
+    }
+
+    size_t plays = 0;
+    size_t freed_plays = 0;
+    size_t cut_off = 0;
+
+private:
+    mutable std::mutex mutex_;
+    uint64_t next_sample_ = 1;
+    std::unordered_map<uint64_t, size_t> sizes_;
+    std::unordered_set<uint64_t> playing_;
+    bool hold_ = false;
+};
+
+// Sounds whose data is 1000 bytes plus their index long
+class Sounds {
+public:
+    explicit Sounds(size_t count) :
+        path_((std::filesystem::temp_directory_path() / "SoundCacheTest.nx")
+                  .string()) {
+        NxBuilder builder;
+
+        for (size_t i = 0; i < count; i++) {
+            builder.add_audio(NxBuilder::ROOT,
+                              std::to_string(i),
+                              std::vector<uint8_t>(size(i), uint8_t(i)));
+        }
+
+        CHECK(builder.write(path_));
+        file_ = std::make_unique<nl::file>(path_);
+    }
+
+    ~Sounds() {
+        file_.reset();
+        std::filesystem::remove(path_);
+    }
+
+    static size_t size(size_t index) { return 1000 + index; }
+
+    // Register every sound with a cache, return their ids
+    std::vector<size_t> add(SoundCache &cache) const {
+        std::vector<size_t> ids;
+
+        for (size_t i = 0; i < file_->root().size(); i++) {
+            nl::audio audio = file_->root()[std::to_string(i)];
+            ids.push_back(cache.add(audio));
+            CHECK(ids.back() != 0);
+        }
+
+        return ids;
+    }
+
+private:
+    std::string path_;
+    std::unique_ptr<nl::file> file_;
+};
+
+StubBackend &install_backend() {
+    auto backend = std::make_unique<StubBackend>();
+    StubBackend &stub = *backend;
+    AudioBackend::set(std::move(backend));
+
+    return stub;
+}
+
+void play(SoundCache &cache, size_t id) {
+    cache.play(id, 1.0f, 0.0f, 0);
+}
+
+// The least recently played samples are freed once the budget is exceeded,
+// and hits, misses and resident bytes add up
+void test_budget() {
+    StubBackend &backend = install_backend();
+    Sounds sounds(4);
+    SoundCache cache;
+    std::vector<size_t> ids = sounds.add(cache);
+    cache.set_budget(2500);
+
+    play(cache, ids[0]);
+    play(cache, ids[1]);
+    play(cache, ids[0]);
+    CHECK(backend.resident() == std::set<size_t>({ 1000, 1001 }));
+
+    // The second sound was played longest ago
+    play(cache, ids[2]);
+    CHECK(backend.resident() == std::set<size_t>({ 1000, 1002 }));
+
+    play(cache, ids[1]);
+    CHECK(backend.resident() == std::set<size_t>({ 1001, 1002 }));
+
+    SoundCache::Stats stats = cache.get_stats();
+    CHECK_EQ(stats.hits, uint64_t(1));
+    CHECK_EQ(stats.misses, uint64_t(4));
+    CHECK_EQ(stats.evictions, uint64_t(2));
+    CHECK_EQ(stats.samples, size_t(2));
+    CHECK_EQ(stats.resident_bytes, size_t(1001 + 1002));
+
+    // A smaller budget frees the oldest right away, even the last played
+    cache.set_budget(1001);
+    CHECK(backend.resident() == std::set<size_t>({ 1001 }));
+    CHECK_EQ(cache.get_stats().resident_bytes, size_t(1001));
+
+    cache.set_budget(0);
+    CHECK(backend.resident().empty());
+    stats = cache.get_stats();
+    CHECK_EQ(stats.evictions, uint64_t(4));
+    CHECK_EQ(stats.samples, size_t(0));
+    CHECK_EQ(stats.resident_bytes, size_t(0));
+
+    CHECK_EQ(backend.plays, size_t(5));
+    CHECK_EQ(backend.freed_plays, size_t(0));
+    cache.close();
+}
+
+// Samples which are still playing stay resident over the budget and are
+// freed by a later eviction once they have ended
+void test_playing() {
+    StubBackend &backend = install_backend();
+    Sounds sounds(3);
+    SoundCache cache;
+    std::vector<size_t> ids = sounds.add(cache);
+    cache.set_budget(1500);
+    backend.hold(true);
+
+    play(cache, ids[0]);
+    play(cache, ids[1]);
+    CHECK(backend.resident() == std::set<size_t>({ 1000, 1001 }));
+    CHECK_EQ(cache.get_stats().resident_bytes, size_t(1000 + 1001));
+
+    // Only the first sound has ended when the third is played
+    backend.stop_all();
+    play(cache, ids[1]);
+    play(cache, ids[2]);
+    CHECK(backend.resident() == std::set<size_t>({ 1001, 1002 }));
+
+    backend.stop_all();
+    cache.set_budget(1500);
+    CHECK(backend.resident() == std::set<size_t>({ 1002 }));
+
+    SoundCache::Stats stats = cache.get_stats();
+    CHECK_EQ(stats.evictions, uint64_t(2));
+    CHECK_EQ(stats.resident_bytes, size_t(1002));
+    CHECK_EQ(backend.cut_off, size_t(0));
+    cache.close();
+}
+
+// Prefetching evicts on the worker thread while sounds are played. With a
+// budget of one byte every new sample evicts all others, yet no sample may
+// be freed before it is played.
+void test_prefetch() {
+    StubBackend &backend = install_backend();
+    Sounds sounds(8);
+    SoundCache cache;
+    std::vector<size_t> ids = sounds.add(cache);
+    cache.set_budget(1);
+
+    std::mt19937 engine(5);
+
+    for (size_t i = 0; i < 20000; i++) {
+        cache.prefetch(ids[engine() % ids.size()]);
+        play(cache, ids[engine() % ids.size()]);
+    }
+
+    CHECK_EQ(backend.plays, size_t(20000));
+    CHECK_EQ(backend.freed_plays, size_t(0));
+
+    cache.close();
+    CHECK(backend.resident().empty());
+    CHECK_EQ(cache.get_stats().resident_bytes, size_t(0));
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_budget();
+    ms::test_playing();
+    ms::test_prefetch();
+
+    return ms::check_result();
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Box.h"
+#include "Check.h"
+
+#include "Gameplay/MapleMap/SpatialGrid.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ms {
+namespace {
+Point<int16_t> random_position(std::mt19937 &engine) {
+    std::uniform_int_distribution<int16_t> x(-3000, 3000);
+    std::uniform_int_distribution<int16_t> y(-1500, 1500);
+
+    return { x(engine), y(engine) };
+}
+
+// Mostly mob-sized bounds, some as wide as a boss
+Rectangle<int16_t> random_bounds(std::mt19937 &engine) {
+    int16_t half = engine() % 10 == 0 ? 200 : 10 + engine() % 30;
+    int16_t height = 20 + engine() % 80;
+
+    return { static_cast<int16_t>(-half), half, static_cast<int16_t>(-height), 0 };
+}
+
+Rectangle<int16_t> random_range(std::mt19937 &engine) {
+    Point<int16_t> corner = random_position(engine);
+    int16_t width = engine() % 4 == 0 ? 0 : engine() % 600;
+    int16_t height = engine() % 4 == 0 ? 0 : engine() % 300;
+
+    return { corner.x(),
+             static_cast<int16_t>(corner.x() + width),
+             corner.y(),
+             static_cast<int16_t>(corner.y() + height) };
+}
+
+// Queries through the grid find the same objects as a scan over all of
+// them, while objects are added, moved and removed
+void test_matches_scan() {
+    std::mt19937 engine(16);
+    std::vector<std::unique_ptr<Box>> boxes;
+    SpatialGrid grid;
+    int32_t next_oid = 0;
+
+    for (size_t i = 0; i < 2000; i++) {
+        boxes.push_back(std::make_unique<Box>(next_oid++, random_position(engine), random_bounds(engine)));
+        grid.insert(boxes.back().get());
+    }
+
+    for (size_t round = 0; round < 200; round++) {
+        for (auto &box : boxes) {
+            switch (engine() % 20) {
+                case 0:
+                    box->set_position(random_position(engine));
+                    break;
+                case 1:
+                case 2:
+                case 3:
+                    box->set_position(box->get_position() + Point<int16_t>(engine() % 21 - 10, engine() % 11 - 5));
+                    break;
+                default:
+                    continue;
+            }
+
+            grid.update(box.get());
+        }
+
+        for (size_t i = 0; i < 20; i++) {
+            size_t index = engine() % boxes.size();
+            grid.remove(boxes[index].get());
+            boxes[index] = std::make_unique<Box>(next_oid++, random_position(engine), random_bounds(engine));
+            grid.insert(boxes[index].get());
+        }
+
+        for (size_t i = 0; i < 50; i++) {
+            Rectangle<int16_t> range = random_range(engine);
+            std::vector<int32_t> expected;
+            std::vector<int32_t> found;
+
+            for (const auto &box : boxes) {
+                if (box->hits(range)) {
+                    expected.push_back(box->get_oid());
+                }
+            }
+
+            grid.query(range, [&](const MapObject &object) {
+                if (static_cast<const Box &>(object).hits(range)) {
+                    found.push_back(object.get_oid());
+                }
+
+                return false;
+            });
+
+            std::sort(expected.begin(), expected.end());
+            std::sort(found.begin(), found.end());
+
+            CHECK(found == expected);
+        }
+    }
+}
+
+// A query stops at the first object the callback accepts, and a cleared
+// grid finds nothing
+void test_stop_and_clear() {
+    SpatialGrid grid;
+    std::vector<std::unique_ptr<Box>> boxes;
+
+    for (int16_t i = 0; i < 10; i++) {
+        boxes.push_back(std::make_unique<Box>(i, Point<int16_t>(i, 0), Rectangle<int16_t>(-5, 5, -5, 0)));
+        grid.insert(boxes.back().get());
+    }
+
+    Rectangle<int16_t> range(-10, 20, -10, 10);
+    size_t visited = 0;
+
+    grid.query(range, [&](const MapObject &) {
+        visited++;
+
+        return true;
+    });
+
+    CHECK_EQ(visited, 1u);
+
+    grid.clear();
+    visited = 0;
+
+    grid.query(range, [&](const MapObject &) {
+        visited++;
+
+        return false;
+    });
+
+    CHECK_EQ(visited, 0u);
+}
+
+// Number of objects a query visits before the callback's own test
+size_t count_visited(const SpatialGrid &grid, const Rectangle<int16_t> &range) {
+    size_t visited = 0;
+
+    grid.query(range, [&](const MapObject &) {
+        visited++;
+
+        return false;
+    });
+
+    return visited;
+}
+
+// Queries are only widened while a large object is in the grid, and bounds
+// that change are picked up once the object reports it
+void test_reach() {
+    SpatialGrid grid;
+    Box small(0, Point<int16_t>(0, 0), Rectangle<int16_t>(-10, 10, -10, 0));
+    Box boss(1, Point<int16_t>(3000, 0), Rectangle<int16_t>(-1000, 1000, -500, 0));
+    Rectangle<int16_t> nearby(600, 610, -5, 5);
+
+    grid.insert(&small);
+    CHECK_EQ(count_visited(grid, nearby), 0u);
+
+    grid.insert(&boss);
+    CHECK_EQ(count_visited(grid, nearby), 1u);
+
+    grid.remove(&boss);
+    CHECK_EQ(count_visited(grid, nearby), 0u);
+
+    // The grid does not look at bounds until told they changed
+    small.set_bounds(Rectangle<int16_t>(-700, 700, -10, 0));
+    CHECK(small.hits(nearby));
+    grid.update(&small);
+    CHECK_EQ(count_visited(grid, nearby), 1u);
+
+    small.set_bounds(Rectangle<int16_t>(-10, 10, -10, 0));
+    grid.update(&small);
+    CHECK_EQ(count_visited(grid, nearby), 0u);
+}
+}  // namespace
+}  // namespace ms
+
+int main() {
+    ms::test_matches_scan();
+    ms::test_stop_and_clear();
+    ms::test_reach();
+
+    return ms::check_result();
+}
\ No newline at end of file
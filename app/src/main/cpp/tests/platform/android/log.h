@@ -0,0 +1,38 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+
+// Host stand-in for the NDK log, printing to stderr
+enum android_LogPriority {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_WARN = 5,
+    ANDROID_LOG_ERROR = 6
+};
+
+inline int __android_log_print(int, const char *tag, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    std::fprintf(stderr, "%s: ", tag);
+    int result = std::vfprintf(stderr, format, args);
+    std::fputc('\n', stderr);
+    va_end(args);
+
+    return result;
+}
\ No newline at end of file
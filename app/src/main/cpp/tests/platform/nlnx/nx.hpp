@@ -0,0 +1,26 @@
+//	This file is part of the continued Journey MMORPG client
+//	Copyright (C) 2015-2024  Daniel Allendorf, Ryan Payton, Bizhou Xing
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <nlnx/nxfwd.hpp>
+
+// Host stand-in for nx.hpp, which pulls in GLFM and the asset manager to
+// open the game files. Tests point the nodes they use at their own files.
+namespace nl::nx {
+extern node base, character, effect, etc, item, map, mapPretty, mapLatest,
+    map001, mob, morph, npc, quest, reactor, skill, sound, string, tamingmob,
+    ui;
+}  // namespace nl::nx
\ No newline at end of file
@@ -43,7 +43,7 @@ bitmap::operator bool() const
     return m_data != nullptr;
 }
 
-std::vector<char> bitmap_buf;
+thread_local std::vector<char> bitmap_buf;
 void const* bitmap::data() const
 {
     if (!m_data) {
@@ -55,16 +55,25 @@ void const* bitmap::data() const
         bitmap_buf.resize(l + 0x20);
     }
 
-    if (::LZ4_decompress_safe(reinterpret_cast<char const*>(m_data) + 4,
-                              bitmap_buf.data(),
-                              static_cast<int>(compressed_length()),
-                              static_cast<int>(l)) < 0) {
+    if (!decode(bitmap_buf.data())) {
         return nullptr;
     }
 
     return bitmap_buf.data();
 }
 
+bool bitmap::decode(void* dest) const
+{
+    if (!m_data) {
+        return false;
+    }
+
+    return ::LZ4_decompress_safe(reinterpret_cast<char const*>(m_data) + 4,
+                                 static_cast<char*>(dest),
+                                 static_cast<int>(compressed_length()),
+                                 static_cast<int>(length())) >= 0;
+}
+
 std::uint16_t bitmap::width() const
 {
     return m_width;
@@ -39,12 +39,16 @@ public:
     explicit operator bool() const;
     //! This function decompresses the data on the fly.
     //! Do not free the pointer returned by this method.
-    //! Every time this function is called, any previous pointers returned
-    //! by this method become invalid.
-    //! As such, this function is very *not* threadsafe.
+    //! Every time this function is called on the same thread, any previous
+    //! pointers returned by this method on that thread become invalid.
+    //! Each thread decompresses into its own buffer.
     //!
     //! Nullable
     void const* data() const;
+    //! Decompresses the data into a caller owned buffer of at least
+    //! `length()` bytes. Safe to call from any thread.
+    //! Returns false if the bitmap is null or the data is corrupt.
+    bool decode(void* dest) const;
     uint16_t width() const;
     uint16_t height() const;
     //! 4 * width * height
@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////////
+// NoLifeNx - Part of the NoLifeStory project                               //
+// Copyright © 2013 Peter Atashian                                          //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.    //
+//////////////////////////////////////////////////////////////////////////////
+#include "child_index.hpp"
+#include "file_impl.hpp"
+
+namespace nl
+{
+std::atomic<bool> child_index::s_enabled{true};
+
+child_index::~child_index() = default;
+
+node::data const* child_index::find(node::data const* parent,
+                                    std::string_view name,
+                                    _file_data const* file)
+{
+    const auto h = hash(name);
+    auto t = m_table.load(std::memory_order_acquire);
+    if (auto c = lookup(t, parent, h, name, file)) {
+        return c;
+    }
+    if (lookup(t, parent, 0, {}, file)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    // Another thread may have indexed the parent while we waited.
+    t = m_table.load(std::memory_order_relaxed);
+    if (!lookup(t, parent, 0, {}, file)) {
+        index(parent, file);
+        t = m_table.load(std::memory_order_relaxed);
+    }
+    return lookup(t, parent, h, name, file);
+}
+
+std::size_t child_index::indexed() const
+{
+    return m_parents.load(std::memory_order_relaxed);
+}
+
+void child_index::set_enabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool child_index::enabled()
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void child_index::index(node::data const* parent, _file_data const* file)
+{
+    const auto first = file->node_table + parent->children;
+    for (auto c = first; c != first + parent->num; ++c) {
+        insert(parent, hash(name(c, file)), c);
+    }
+    // The marker goes in last so a concurrent reader that finds it also
+    // finds every child.
+    insert(parent, 0, parent);
+    m_parents.fetch_add(1, std::memory_order_relaxed);
+}
+
+void child_index::insert(node::data const* parent, std::uint64_t hash,
+                         node::data const* child)
+{
+    auto t = m_tables.empty() ? nullptr : m_tables.back().get();
+    // Keep the load factor at or below one half so probes stay short. A full
+    // table is rebuilt into a larger one and published in one store.
+    if (!t || (m_used + 1) * 2 > t->mask + 1) {
+        const auto size = t ? (t->mask + 1) * 2 : std::size_t{4096};
+        auto grown = std::make_unique<table>();
+        grown->mask = size - 1;
+        grown->entries = std::make_unique<entry[]>(size);
+        if (t) {
+            for (auto i = 0u; i <= t->mask; ++i) {
+                auto const& o = t->entries[i];
+                auto p = o.parent.load(std::memory_order_relaxed);
+                if (p) {
+                    auto j = slot(p, o.hash) & grown->mask;
+                    while (grown->entries[j].parent.load(
+                        std::memory_order_relaxed)) {
+                        j = (j + 1) & grown->mask;
+                    }
+                    grown->entries[j].hash = o.hash;
+                    grown->entries[j].child = o.child;
+                    grown->entries[j].parent.store(p,
+                                                   std::memory_order_relaxed);
+                }
+            }
+        }
+        t = grown.get();
+        m_tables.push_back(std::move(grown));
+        m_table.store(t, std::memory_order_release);
+    }
+
+    auto i = slot(parent, hash) & t->mask;
+    while (t->entries[i].parent.load(std::memory_order_relaxed)) {
+        i = (i + 1) & t->mask;
+    }
+    t->entries[i].hash = hash;
+    t->entries[i].child = child;
+    t->entries[i].parent.store(parent, std::memory_order_release);
+    ++m_used;
+}
+
+node::data const* child_index::lookup(table const* t,
+                                      node::data const* parent,
+                                      std::uint64_t hash,
+                                      std::string_view name,
+                                      _file_data const* file)
+{
+    if (!t) {
+        return nullptr;
+    }
+
+    for (auto i = slot(parent, hash) & t->mask;; i = (i + 1) & t->mask) {
+        auto const& e = t->entries[i];
+        auto p = e.parent.load(std::memory_order_acquire);
+        if (!p) {
+            return nullptr;
+        }
+        if (p == parent && e.hash == hash
+            && (!hash || child_index::name(e.child, file) == name)) {
+            return e.child;
+        }
+    }
+}
+
+std::size_t child_index::slot(node::data const* parent, std::uint64_t hash)
+{
+    auto k = hash
+             ^ (static_cast<std::uint64_t>(
+                    reinterpret_cast<std::uintptr_t>(parent))
+                * 0x9E3779B97F4A7C15ull);
+    k ^= k >> 32;
+    return static_cast<std::size_t>(k);
+}
+std::uint64_t child_index::hash(std::string_view name)
+{
+    // FNV-1a, with the low bit forced so that zero stays free for the marker.
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    for (auto c : name) {
+        h ^= static_cast<std::uint8_t>(c);
+        h *= 0x100000001B3ull;
+    }
+    return h | 1;
+}
+
+std::string_view child_index::name(node::data const* n, _file_data const* file)
+{
+    const auto s = reinterpret_cast<char const*>(file->base)
+                   + file->string_table[n->name];
+    return {s + 2, *reinterpret_cast<std::uint16_t const*>(s)};
+}
+} // namespace nl
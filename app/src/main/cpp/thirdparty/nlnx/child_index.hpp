@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////////
+// NoLifeNx - Part of the NoLifeStory project                               //
+// Copyright © 2013 Peter Atashian                                          //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.    //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "node_impl.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace nl
+{
+//! Open-addressed hash table over the children of large nodes in one file.
+//! A parent is indexed the first time one of its children is looked up, after
+//! which every lookup under it costs one hash and a short probe instead of a
+//! binary search over the string table.
+//! Lookups never lock; indexing a new parent is serialized by a mutex and
+//! publishes its entries with release stores.
+class child_index
+{
+public:
+    //! Parents with fewer children than this keep using the binary search,
+    //! which for small nodes touches fewer cache lines than a probe does.
+    static constexpr std::uint16_t min_children = 64;
+
+    child_index() = default;
+    ~child_index();
+    child_index(child_index const&) = delete;
+    child_index& operator=(child_index const&) = delete;
+
+    //! Returns the child of `parent` named `name`, or null if there is none.
+    //! Indexes `parent` first if this is its first lookup.
+    node::data const* find(node::data const* parent, std::string_view name,
+                           _file_data const* file);
+
+    //! Returns the number of parents indexed so far.
+    std::size_t indexed() const;
+
+    //! Turns the index on or off for every file. It is on by default.
+    static void set_enabled(bool enabled);
+    //! Whether lookups should go through the index.
+    static bool enabled();
+
+private:
+    struct entry {
+        //! Null marks an empty slot. Stored last so readers never see a
+        //! half-written entry.
+        std::atomic<node::data const*> parent{nullptr};
+        //! Zero marks the entry recording that `parent` has been indexed.
+        std::uint64_t hash = 0;
+        node::data const* child = nullptr;
+    };
+
+    struct table {
+        std::size_t mask;
+        std::unique_ptr<entry[]> entries;
+    };
+
+    void index(node::data const* parent, _file_data const* file);
+    void insert(node::data const* parent, std::uint64_t hash,
+                node::data const* child);
+    static node::data const* lookup(table const* t, node::data const* parent,
+                                    std::uint64_t hash, std::string_view name,
+                                    _file_data const* file);
+    static std::size_t slot(node::data const* parent, std::uint64_t hash);
+
+    static std::uint64_t hash(std::string_view name);
+    static std::string_view name(node::data const* n, _file_data const* file);
+
+    std::atomic<table const*> m_table{nullptr};
+    // Tables outgrown while readers may still be probing them. They are only
+    // freed together with the file.
+    std::vector<std::unique_ptr<table>> m_tables;
+    std::mutex m_mutex;
+    std::size_t m_used = 0;
+    std::atomic<std::size_t> m_parents{0};
+    static std::atomic<bool> s_enabled;
+};
+} // namespace nl
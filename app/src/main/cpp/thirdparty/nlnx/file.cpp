@@ -16,6 +16,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.    //
 //////////////////////////////////////////////////////////////////////////////
 
+#include "child_index.hpp"
 #include "file_impl.hpp"
 #include "node_impl.hpp"
 #ifdef _WIN32
@@ -55,6 +56,7 @@ void file::open(std::string name)
 {
     close();
     m_data = new data();
+    m_data->children = new child_index();
 
 #ifdef _WIN32
     m_data->file_handle = ::CreateFileA(name.c_str(),
@@ -137,6 +139,7 @@ void file::close()
     ::close(m_data->file_handle);
 #endif
 
+    delete m_data->children;
     delete m_data;
     m_data = nullptr;
 }
@@ -22,6 +22,7 @@
 
 namespace nl
 {
+class child_index;
 #pragma pack(push, 1)
 struct file::header {
     uint32_t const magic;
@@ -43,6 +44,8 @@ struct _file_data {
     uint64_t const* bitmap_table = nullptr;
     uint64_t const* audio_table = nullptr;
     file::header const* header = nullptr;
+    //! Lazily built lookup table for the children of large nodes.
+    child_index* children = nullptr;
 #ifdef _WIN32
     void* file_handle = nullptr;
     void* map = nullptr;
@@ -17,9 +17,11 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "audio.hpp"
 #include "bitmap.hpp"
+#include "child_index.hpp"
 #include "file_impl.hpp"
 #include "node_impl.hpp"
 
+#include <charconv>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
@@ -101,42 +103,52 @@ std::string operator+(node n, char const* s)
     return n.get_string() + s;
 }
 
+namespace
+{
+// Formats the integer into a stack buffer so that child lookups by number
+// never touch the heap or the locale-aware formatting routines.
+template <typename T>
+std::string_view format_child(T n, char (&buf)[21])
+{
+    auto res = std::to_chars(buf, buf + sizeof(buf), n);
+    return {buf, static_cast<std::string_view::size_type>(res.ptr - buf)};
+}
+} // namespace
+
 node node::operator[](std::uint16_t n) const
 {
-    return operator[](std::to_string(n));
+    char buf[21];
+    return get_child(format_child(n, buf));
 }
 
 node node::operator[](std::int16_t n) const
 {
-    return operator[](std::to_string(n));
+    char buf[21];
+    return get_child(format_child(n, buf));
 }
 
 node node::operator[](std::uint32_t n) const
 {
-    return operator[](std::to_string(n));
+    char buf[21];
+    return get_child(format_child(n, buf));
 }
 
 node node::operator[](std::int32_t n) const
 {
-    return operator[](std::to_string(n));
+    char buf[21];
+    return get_child(format_child(n, buf));
 }
 
 node node::operator[](std::uint64_t n) const
 {
-    // 64-bit integers in string form have the possibility of not getting SSO,
-    // so to ensure that no allocations occur we use `snprintf()`.
     char buf[21];
-    auto len = std::snprintf(buf, 21, "%lu", n);
-    return operator[](std::string_view{buf, static_cast<std::string_view::size_type>(len)});
+    return get_child(format_child(n, buf));
 }
 
 node node::operator[](std::int64_t n) const
 {
-    // 64-bit integers in string form have the possibility of not getting SSO,
-    // so to ensure that no allocations occur we use `snprintf()`.
     char buf[21];
-    auto len = std::snprintf(buf, 21, "%ld", n);
-    return operator[](std::string_view{buf, static_cast<std::string_view::size_type>(len)});
+    return get_child(format_child(n, buf));
 }
 
 node node::operator[](std::string_view o) const
@@ -379,12 +391,22 @@ node::type node::data_type() const
     return m_data ? m_data->type : type::none;
 }
 
+std::size_t node::id() const
+{
+    return reinterpret_cast<std::size_t>(m_data);
+}
+
 node node::get_child(std::string_view o) const
 {
     if (!m_data) {
         return {nullptr, m_file};
     }
 
+    if (m_data->num >= child_index::min_children && m_file->children
+        && child_index::enabled()) {
+        return {m_file->children->find(m_data, o, m_file), m_file};
+    }
+
     auto p = m_file->node_table + m_data->children;
     auto n = m_data->num;
     const auto b = reinterpret_cast<const char*>(m_file->base);
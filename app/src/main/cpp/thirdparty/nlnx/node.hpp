@@ -120,6 +120,9 @@ public:
     std::size_t size() const;
     //! Gets the type of data contained within the node.
     type data_type() const;
+    //! Returns a value which identifies this node among all loaded files.
+    //! Null nodes all share the id 0.
+    std::size_t id() const;
     //! Returns the root node of the file this node was derived from.
     node root() const;
     //! Takes a '/' separated string view, and resolves the given path.